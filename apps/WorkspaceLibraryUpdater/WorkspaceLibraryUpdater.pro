@@ -10,7 +10,7 @@ TARGET = workspace-library-updater
 # Use common project definitions
 include(../../common.pri)
 
-QT += core widgets xml sql network
+QT += core widgets xml sql network concurrent
 
 LIBS += \
     -L$${DESTDIR} \
@@ -18,7 +18,6 @@ LIBS += \
     -llibrepcbproject \
     -llibrepcblibrary \    # Note: The order of the libraries is very important for the linker!
     -llibrepcbcommon \     # Another order could end up in "undefined reference" errors!
-    -lsexpresso \
     -lclipper \
     -lquazip -lz \
 
@@ -32,7 +31,6 @@ DEPENDPATH += \
     ../../libs/librepcb/project \
     ../../libs/librepcb/library \
     ../../libs/librepcb/common \
-    ../../libs/sexpresso \
     ../../libs/clipper \
 
 PRE_TARGETDEPS += \
@@ -40,7 +38,6 @@ PRE_TARGETDEPS += \
     $${DESTDIR}/liblibrepcbproject.a \
     $${DESTDIR}/liblibrepcblibrary.a \
     $${DESTDIR}/liblibrepcbcommon.a \
-    $${DESTDIR}/libsexpresso.a \
     $${DESTDIR}/libclipper.a \
 
 SOURCES += \
@@ -205,7 +205,8 @@ int CommandLineInterface::execute() noexcept {
         parser.isSet(exportPcbFabricationDataOption),  // export PCB fab. data
         parser.value(pcbFabricationSettingsOption),    // PCB fab. settings
         parser.values(boardOption),                    // boards
-        parser.isSet(saveOption)                       // save project
+        parser.isSet(saveOption),                      // save project
+        parser.isSet(verboseOption)                    // print loading times
     );
   } else if (command == "open-library") {
     if (positionalArgs.count() != 1) {
@@ -237,7 +238,7 @@ bool CommandLineInterface::openProject(
     const QString& projectFile, bool runErc,
     const QStringList& exportSchematicsFiles, bool exportPcbFabricationData,
     const QString& pcbFabricationSettingsPath, const QStringList& boards,
-    bool save) const noexcept {
+    bool save, bool verbose) const noexcept {
   try {
     bool success = true;
 
@@ -263,6 +264,12 @@ bool CommandLineInterface::openProject(
     Project project(std::unique_ptr<TransactionalDirectory>(
                         new TransactionalDirectory(projectFs)),
                     projectFileName);  // can throw
+    if (verbose) {
+      for (const auto& stage : project.getLoadingTimes()) {
+        print("  " %
+              QString(tr("%1: %2 ms")).arg(stage.first).arg(stage.second));
+      }
+    }
 
     // ERC
     if (runErc) {
@@ -356,8 +363,10 @@ bool CommandLineInterface::openProject(
       }
       QHash<FilePath, int> filesCounter;
       bool                 filesOverwritten = false;
-      foreach (const Board* board, boardList) {
+      foreach (Board* board, boardList) {
         print("  " % QString(tr("Board '%1':")).arg(*board->getName()));
+        // make sure the planes are up to date (cheap if the cache was valid)
+        board->rebuildAllPlanes();
         BoardGerberExport grbExport(
             *board, customSettings ? *customSettings
                                    : board->getFabricationOutputSettings());
@@ -366,6 +375,15 @@ bool CommandLineInterface::openProject(
           filesCounter[fp]++;
           if (filesCounter[fp] > 1) filesOverwritten = true;
           print(QString("    => '%1'").arg(prettyPath(fp, projectFile)));
+          if (grbExport.getDrillTravelDistances().contains(fp)) {
+            BoardGerberExport::DrillTravelDistance distance =
+                grbExport.getDrillTravelDistances().value(fp);
+            print("       " %
+                  QString(tr("Drill travel distance: %1 mm (unoptimized: %2 "
+                             "mm)"))
+                      .arg(distance.optimized->toMmString(),
+                           distance.unoptimized->toMmString()));
+          }
         }
       }
       if (filesOverwritten) {
@@ -59,7 +59,8 @@ private:  // Methods
                    const QStringList& exportSchematicsFiles,
                    bool               exportPcbFabricationData,
                    const QString&     pcbFabricationSettingsPath,
-                   const QStringList& boards, bool save) const noexcept;
+                   const QStringList& boards, bool save,
+                   bool verbose) const noexcept;
   bool openLibrary(const QString& libDir, bool all, bool save) const noexcept;
   static QString prettyPath(const FilePath& path,
                             const QString&  style) noexcept;
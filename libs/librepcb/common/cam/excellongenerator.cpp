@@ -24,8 +24,13 @@
 
 #include "../fileio/fileutils.h"
 
+#include <QtConcurrent/QtConcurrent>
 #include <QtCore>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 /*******************************************************************************
  *  Namespace
  ******************************************************************************/
@@ -35,7 +40,11 @@ namespace librepcb {
  *  Constructors / Destructor
  ******************************************************************************/
 
-ExcellonGenerator::ExcellonGenerator() noexcept : mOutput() {
+ExcellonGenerator::ExcellonGenerator() noexcept
+  : mOptimizeToolPaths(false),
+    mOutput(),
+    mTotalTravelDistance(0),
+    mUnoptimizedTravelDistance(0) {
 }
 
 ExcellonGenerator::~ExcellonGenerator() noexcept {
@@ -51,9 +60,22 @@ void ExcellonGenerator::drill(const Point&          pos,
 }
 
 void ExcellonGenerator::generate() {
+  QVector<Tool> tools;
+  foreach (const Length& dia, mDrillList.uniqueKeys()) {
+    tools.append(Tool{dia, mDrillList.values(dia).toVector()});
+  }
+  mUnoptimizedTravelDistance = calcTotalTravelDistance(tools);
+  if (mOptimizeToolPaths) {
+    // tools are independent of each other, so optimize them in parallel
+    QtConcurrent::blockingMap(tools, &ExcellonGenerator::optimizeToolPath);
+    mTotalTravelDistance = calcTotalTravelDistance(tools);
+  } else {
+    mTotalTravelDistance = mUnoptimizedTravelDistance;
+  }
+
   mOutput.clear();
-  printHeader();
-  printDrills();
+  printHeader(tools);
+  printDrills(tools);
   printFooter();
 }
 
@@ -64,13 +86,15 @@ void ExcellonGenerator::saveToFile(const FilePath& filepath) const {
 void ExcellonGenerator::reset() noexcept {
   mOutput.clear();
   mDrillList.clear();
+  mTotalTravelDistance       = UnsignedLength(0);
+  mUnoptimizedTravelDistance = UnsignedLength(0);
 }
 
 /*******************************************************************************
  *  Private Methods
  ******************************************************************************/
 
-void ExcellonGenerator::printHeader() noexcept {
+void ExcellonGenerator::printHeader(const QVector<Tool>& tools) noexcept {
   mOutput.append("M48\n");  // Beginning of Part Program Header
 
   // Comments
@@ -82,7 +106,7 @@ void ExcellonGenerator::printHeader() noexcept {
   mOutput.append("FMAT,2\n");     // Use Format 2 commands
   mOutput.append("METRIC,TZ\n");  // Metric Format, Trailing Zeros Mode
 
-  printToolList();
+  printToolList(tools);
 
   mOutput.append("%\n");    // Beginning of Pattern
   mOutput.append("G90\n");  // Absolute Mode
@@ -90,18 +114,17 @@ void ExcellonGenerator::printHeader() noexcept {
   mOutput.append("M71\n");  // Metric Measuring Mode
 }
 
-void ExcellonGenerator::printToolList() noexcept {
-  for (int i = 0; i < mDrillList.uniqueKeys().count(); ++i) {
-    Length dia = mDrillList.uniqueKeys().value(i);
+void ExcellonGenerator::printToolList(const QVector<Tool>& tools) noexcept {
+  for (int i = 0; i < tools.count(); ++i) {
+    Length dia = tools.at(i).diameter;
     mOutput.append(QString("T%1C%2\n").arg(i + 1).arg(dia.toMmString()));
   }
 }
 
-void ExcellonGenerator::printDrills() noexcept {
-  for (int i = 0; i < mDrillList.uniqueKeys().count(); ++i) {
+void ExcellonGenerator::printDrills(const QVector<Tool>& tools) noexcept {
+  for (int i = 0; i < tools.count(); ++i) {
     mOutput.append(QString("T%1\n").arg(i + 1));  // Select Tool
-    Length dia = mDrillList.uniqueKeys().value(i);
-    foreach (const Point& pos, mDrillList.values(dia)) {
+    foreach (const Point& pos, tools.at(i).hits) {
       mOutput.append(
           QString("X%1Y%2\n")
               .arg(pos.getX().toMmString(), pos.getY().toMmString()));
@@ -114,6 +137,136 @@ void ExcellonGenerator::printFooter() noexcept {
   mOutput.append("M30\n");  // End of Program Rewind
 }
 
+/*******************************************************************************
+ *  Static Methods
+ ******************************************************************************/
+
+void ExcellonGenerator::optimizeToolPath(Tool& tool) noexcept {
+  if (tool.hits.count() <= sMaxNearestNeighbourHits) {
+    sortByNearestNeighbour(tool.hits);
+    improveByTwoOpt(tool.hits, tool.hits.count());
+  } else {
+    sortByHilbertCurve(tool.hits);
+    improveByTwoOpt(tool.hits, sTwoOptWindow);
+  }
+}
+
+void ExcellonGenerator::sortByNearestNeighbour(QVector<Point>& hits) noexcept {
+  Point current;  // start at the origin
+  for (int i = 0; i < hits.count(); ++i) {
+    int   nearest         = i;
+    qreal nearestDistance = std::numeric_limits<qreal>::infinity();
+    for (int k = i; k < hits.count(); ++k) {
+      qreal dx = qreal(hits.at(k).getX().toNm()) - qreal(current.getX().toNm());
+      qreal dy = qreal(hits.at(k).getY().toNm()) - qreal(current.getY().toNm());
+      qreal distance = dx * dx + dy * dy;  // squared is enough to compare
+      if (distance < nearestDistance) {
+        nearest         = k;
+        nearestDistance = distance;
+      }
+    }
+    std::swap(hits[i], hits[nearest]);
+    current = hits.at(i);
+  }
+}
+
+void ExcellonGenerator::sortByHilbertCurve(QVector<Point>& hits) noexcept {
+  if (hits.isEmpty()) return;
+
+  // map the bounding box of all hits to a grid of 2^16 x 2^16 cells
+  LengthBase_t minX = hits.first().getX().toNm(), maxX = minX;
+  LengthBase_t minY = hits.first().getY().toNm(), maxY = minY;
+  foreach (const Point& hit, hits) {
+    minX = qMin(minX, hit.getX().toNm());
+    maxX = qMax(maxX, hit.getX().toNm());
+    minY = qMin(minY, hit.getY().toNm());
+    maxY = qMax(maxY, hit.getY().toNm());
+  }
+  const quint32 gridSize = 1u << 16;
+  const qreal   scale =
+      qreal(gridSize - 1) / qMax(qreal(maxX - minX), qreal(maxY - minY));
+  if (!std::isfinite(scale)) return;  // all hits at the same position
+
+  QVector<QPair<quint64, int>> keys;
+  keys.reserve(hits.count());
+  for (int i = 0; i < hits.count(); ++i) {
+    quint32 x = quint32((hits.at(i).getX().toNm() - minX) * scale);
+    quint32 y = quint32((hits.at(i).getY().toNm() - minY) * scale);
+    quint64 d = 0;
+    for (quint32 s = gridSize / 2; s > 0; s /= 2) {
+      quint32 rx = (x & s) ? 1 : 0;
+      quint32 ry = (y & s) ? 1 : 0;
+      d += quint64(s) * s * ((3 * rx) ^ ry);
+      if (ry == 0) {
+        if (rx == 1) {
+          x = gridSize - 1 - x;
+          y = gridSize - 1 - y;
+        }
+        std::swap(x, y);
+      }
+    }
+    keys.append(qMakePair(d, i));
+  }
+  std::sort(keys.begin(), keys.end());  // index as tie-breaker
+
+  QVector<Point> sorted;
+  sorted.reserve(hits.count());
+  foreach (const auto& key, keys) { sorted.append(hits.at(key.second)); }
+  hits = sorted;
+}
+
+void ExcellonGenerator::improveByTwoOpt(QVector<Point>& hits,
+                                        int             window) noexcept {
+  // The path starts at the origin and has an open end, thus reversing the
+  // hits i..j only replaces the edge before i and the edge after j.
+  for (int pass = 0; pass < sMaxTwoOptPasses; ++pass) {
+    bool improved = false;
+    for (int i = 0; i < hits.count() - 1; ++i) {
+      Point prev = (i > 0) ? hits.at(i - 1) : Point();
+      int   last = qMin(hits.count() - 1, i + window);
+      for (int j = i + 1; j <= last; ++j) {
+        qreal before = calcDistance(prev, hits.at(i));
+        qreal after  = calcDistance(prev, hits.at(j));
+        if (j + 1 < hits.count()) {
+          before += calcDistance(hits.at(j), hits.at(j + 1));
+          after += calcDistance(hits.at(i), hits.at(j + 1));
+        }
+        if (after < before - 1) {  // tolerance of 1nm against rounding loops
+          std::reverse(hits.begin() + i, hits.begin() + j + 1);
+          improved = true;
+        }
+      }
+    }
+    if (!improved) break;
+  }
+}
+
+qreal ExcellonGenerator::calcTravelDistance(
+    const QVector<Point>& hits) noexcept {
+  qreal distance = 0;
+  Point current;  // start at the origin
+  foreach (const Point& hit, hits) {
+    distance += calcDistance(current, hit);
+    current = hit;
+  }
+  return distance;
+}
+
+UnsignedLength ExcellonGenerator::calcTotalTravelDistance(
+    const QVector<Tool>& tools) noexcept {
+  qreal distance = 0;
+  foreach (const Tool& tool, tools) {
+    distance += calcTravelDistance(tool.hits);
+  }
+  return UnsignedLength(Length(qRound64(distance)));
+}
+
+qreal ExcellonGenerator::calcDistance(const Point& a, const Point& b) noexcept {
+  qreal dx = qreal(b.getX().toNm()) - qreal(a.getX().toNm());
+  qreal dy = qreal(b.getY().toNm()) - qreal(a.getY().toNm());
+  return std::sqrt(dx * dx + dy * dy);
+}
+
 /*******************************************************************************
  *  End of File
  ******************************************************************************/
@@ -40,6 +40,11 @@ namespace librepcb {
 
 /**
  * @brief The ExcellonGenerator class
+ *
+ * By default the hits of each tool are written in the order they were added.
+ * With #setOptimizeToolPaths() the hits of each tool get sorted to reduce the
+ * travel distance of the drilling machine (see #optimizeToolPath()). Each
+ * tool starts at the origin of the coordinate system.
  */
 class ExcellonGenerator final {
   Q_DECLARE_TR_FUNCTIONS(ExcellonGenerator)
@@ -53,6 +58,36 @@ public:
 
   // Getters
   const QString& toStr() const noexcept { return mOutput; }
+  bool getOptimizeToolPaths() const noexcept { return mOptimizeToolPaths; }
+
+  /**
+   * @brief Get the travel distance between all hits of the generated output
+   *
+   * @return Sum of the travel distances of all tools, or zero if #generate()
+   *         was not called yet
+   */
+  const UnsignedLength& getTotalTravelDistance() const noexcept {
+    return mTotalTravelDistance;
+  }
+
+  /**
+   * @brief Get the travel distance the output would have without optimization
+   *
+   * Allows to compare the result of #setOptimizeToolPaths() with the original
+   * order of the hits. If optimization is disabled, this is the same as
+   * #getTotalTravelDistance().
+   *
+   * @return Sum of the travel distances of all tools in their original order,
+   *         or zero if #generate() was not called yet
+   */
+  const UnsignedLength& getUnoptimizedTravelDistance() const noexcept {
+    return mUnoptimizedTravelDistance;
+  }
+
+  // Setters
+  void setOptimizeToolPaths(bool optimize) noexcept {
+    mOptimizeToolPaths = optimize;
+  }
 
   // General Methods
   void drill(const Point& pos, const PositiveLength& dia) noexcept;
@@ -63,15 +98,44 @@ public:
   // Operator Overloadings
   ExcellonGenerator& operator=(const ExcellonGenerator& rhs) = delete;
 
-private:
-  void printHeader() noexcept;
-  void printToolList() noexcept;
-  void printDrills() noexcept;
+private:  // Types
+  struct Tool {
+    Length         diameter;
+    QVector<Point> hits;
+  };
+
+private:  // Methods
+  void printHeader(const QVector<Tool>& tools) noexcept;
+  void printToolList(const QVector<Tool>& tools) noexcept;
+  void printDrills(const QVector<Tool>& tools) noexcept;
   void printFooter() noexcept;
 
+  static void  optimizeToolPath(Tool& tool) noexcept;
+  static void  sortByNearestNeighbour(QVector<Point>& hits) noexcept;
+  static void  sortByHilbertCurve(QVector<Point>& hits) noexcept;
+  static void  improveByTwoOpt(QVector<Point>& hits, int window) noexcept;
+  static qreal calcTravelDistance(const QVector<Point>& hits) noexcept;
+  static qreal calcDistance(const Point& a, const Point& b) noexcept;
+
+  static UnsignedLength calcTotalTravelDistance(
+      const QVector<Tool>& tools) noexcept;
+
+private:  // Data
+  /// Above this number of hits per tool, the quadratic nearest neighbour
+  /// heuristic gets too slow and a Hilbert curve order is used instead
+  static const int sMaxNearestNeighbourHits = 2000;
+  /// Max. length of reversed segments for 2-opt on Hilbert curve orders
+  static const int sTwoOptWindow    = 50;
+  static const int sMaxTwoOptPasses = 8;
+
+  // Settings
+  bool mOptimizeToolPaths;
+
   // Excellon Data
   QString                  mOutput;
   QMultiMap<Length, Point> mDrillList;
+  UnsignedLength           mTotalTravelDistance;
+  UnsignedLength           mUnoptimizedTravelDistance;
 };
 
 /*******************************************************************************
@@ -49,9 +49,10 @@ QString GerberApertureList::generateString() const noexcept {
   foreach (const QString& macro, mApertureMacros) {
     str.append(QString("%AM%1*%\n").arg(macro));
   }
-  foreach (int number, mApertures.keys()) {
-    str.append(
-        QString("%ADD%1%2*%\n").arg(number).arg(mApertures.value(number)));
+  for (int i = 0; i < mApertures.count(); ++i) {
+    str.append(QString("%ADD%1%2*%\n")
+                   .arg(i + 10)
+                   .arg(generateAperture(mApertures.at(i))));
   }
   str.append("G04 --- APERTURE LIST END --- *\n");
   return str;
@@ -63,25 +64,26 @@ QString GerberApertureList::generateString() const noexcept {
 
 int GerberApertureList::setCircle(const UnsignedLength& dia,
                                   const UnsignedLength& hole) {
-  return setCurrentAperture(generateCircle(dia, hole));
+  return setCurrentAperture(
+      Aperture{Shape::Circle, {{dia->toNm(), hole->toNm(), 0, 0, 0, 0}}});
 }
 
 int GerberApertureList::setRect(const UnsignedLength& w,
                                 const UnsignedLength& h, const Angle& rot,
                                 const UnsignedLength& hole) noexcept {
   if (rot % Angle::deg180() == 0) {
-    return setCurrentAperture(generateRect(w, h, hole));
+    return setCurrentAperture(Aperture{
+        Shape::Rect, {{w->toNm(), h->toNm(), hole->toNm(), 0, 0, 0}}});
   } else if (rot % Angle::deg90() == 0) {
-    return setCurrentAperture(generateRect(h, w, hole));
+    return setCurrentAperture(Aperture{
+        Shape::Rect, {{h->toNm(), w->toNm(), hole->toNm(), 0, 0, 0}}});
   } else {
     // Rotation is not a multiple of 90 degrees --> we need to use an aperture
     // macro
-    if (hole > 0) {
-      addMacro(generateRotatedRectMacroWithHole());
-    } else {
-      addMacro(generateRotatedRectMacro());
-    }
-    return setCurrentAperture(generateRotatedRect(w, h, rot, hole));
+    return setCurrentAperture(
+        Aperture{Shape::RotatedRect,
+                 {{w->toNm(), h->toNm(), rot.toMicroDeg(), hole->toNm(), 0,
+                   0}}});
   }
 }
 
@@ -89,18 +91,21 @@ int GerberApertureList::setObround(const UnsignedLength& w,
                                    const UnsignedLength& h, const Angle& rot,
                                    const UnsignedLength& hole) noexcept {
   if (rot % Angle::deg180() == 0) {
-    return setCurrentAperture(generateObround(w, h, hole));
+    return setCurrentAperture(Aperture{
+        Shape::Obround, {{w->toNm(), h->toNm(), hole->toNm(), 0, 0, 0}}});
   } else if (rot % Angle::deg90() == 0) {
-    return setCurrentAperture(generateObround(h, w, hole));
+    return setCurrentAperture(Aperture{
+        Shape::Obround, {{h->toNm(), w->toNm(), hole->toNm(), 0, 0, 0}}});
   } else {
     // Rotation is not a multiple of 90 degrees --> we need to use an aperture
     // macro
-    if (hole > 0) {
-      addMacro(generateRotatedObroundMacroWithHole());
-    } else {
-      addMacro(generateRotatedObroundMacro());
-    }
-    return setCurrentAperture(generateRotatedObround(w, h, rot, hole));
+    UnsignedLength width = (w < h ? w : h);
+    Point          start = Point(-w / 2 + width / 2, 0).rotated(rot);
+    Point          end   = Point(w / 2 - width / 2, 0).rotated(rot);
+    return setCurrentAperture(
+        Aperture{Shape::RotatedObround,
+                 {{start.getX().toNm(), start.getY().toNm(), end.getX().toNm(),
+                   end.getY().toNm(), width->toNm(), hole->toNm()}}});
   }
 }
 
@@ -115,24 +120,42 @@ int GerberApertureList::setRegularPolygon(const UnsignedLength& dia, int n,
   // Adjust rotation as its interpretation differs between LibrePCB and Gerber
   // specs
   Angle grbRot = rot + (Angle::deg180() / (n > 0 ? n : 1));
-  return setCurrentAperture(generateRegularPolygon(dia, n, grbRot, hole));
+  return setCurrentAperture(
+      Aperture{Shape::RegularPolygon,
+               {{dia->toNm(), n, grbRot.toMicroDeg(), hole->toNm(), 0, 0}}});
 }
 
 void GerberApertureList::reset() noexcept {
   // mApertureMacros.clear();
   mApertures.clear();
+  mApertureNumbers.clear();
 }
 
 /*******************************************************************************
  *  Private Methods
  ******************************************************************************/
 
-int GerberApertureList::setCurrentAperture(const QString& aperture) noexcept {
-  int number = mApertures.key(aperture, -1);
+int GerberApertureList::setCurrentAperture(const Aperture& aperture) noexcept {
+  int number = mApertureNumbers.value(aperture, -1);
   if (number < 0) {
     number = mApertures.count() + 10;  // 10 is the number of the first aperture
-    Q_ASSERT(!mApertures.contains(number));
-    mApertures.insert(number, aperture);
+    mApertures.append(aperture);
+    mApertureNumbers.insert(aperture, number);
+
+    // add macros required by the new aperture
+    switch (aperture.shape) {
+      case Shape::RotatedRect:
+        addMacro((aperture.values[3] > 0) ? generateRotatedRectMacroWithHole()
+                                          : generateRotatedRectMacro());
+        break;
+      case Shape::RotatedObround:
+        addMacro((aperture.values[5] > 0)
+                     ? generateRotatedObroundMacroWithHole()
+                     : generateRotatedObroundMacro());
+        break;
+      default:
+        break;
+    }
   }
   return number;
 }
@@ -147,6 +170,34 @@ void GerberApertureList::addMacro(const QString& macro) noexcept {
  *  Aperture Generator Methods
  ******************************************************************************/
 
+QString GerberApertureList::generateAperture(
+    const Aperture& aperture) noexcept {
+  const std::array<qint64, 6>& v = aperture.values;
+  switch (aperture.shape) {
+    case Shape::Circle:
+      return generateCircle(UnsignedLength(v[0]), UnsignedLength(v[1]));
+    case Shape::Rect:
+      return generateRect(UnsignedLength(v[0]), UnsignedLength(v[1]),
+                          UnsignedLength(v[2]));
+    case Shape::Obround:
+      return generateObround(UnsignedLength(v[0]), UnsignedLength(v[1]),
+                             UnsignedLength(v[2]));
+    case Shape::RegularPolygon:
+      return generateRegularPolygon(UnsignedLength(v[0]), v[1], Angle(v[2]),
+                                    UnsignedLength(v[3]));
+    case Shape::RotatedRect:
+      return generateRotatedRect(UnsignedLength(v[0]), UnsignedLength(v[1]),
+                                 Angle(v[2]), UnsignedLength(v[3]));
+    case Shape::RotatedObround:
+      return generateRotatedObround(Point(v[0], v[1]), Point(v[2], v[3]),
+                                    UnsignedLength(v[4]), UnsignedLength(v[5]));
+    default:
+      qCritical() << "Unhandled aperture shape:"
+                  << static_cast<int>(aperture.shape);
+      return QString();
+  }
+}
+
 QString GerberApertureList::generateCircle(
     const UnsignedLength& dia, const UnsignedLength& hole) noexcept {
   if (hole > 0) {
@@ -224,11 +275,8 @@ QString GerberApertureList::generateRotatedRect(
 }
 
 QString GerberApertureList::generateRotatedObround(
-    const UnsignedLength& w, const UnsignedLength& h, const Angle& rot,
+    const Point& start, const Point& end, const UnsignedLength& width,
     const UnsignedLength& hole) noexcept {
-  UnsignedLength width = (w < h ? w : h);
-  Point          start = Point(-w / 2 + width / 2, 0).rotated(rot);
-  Point          end   = Point(w / 2 - width / 2, 0).rotated(rot);
   if (hole > 0) {
     return QString("ROTATEDOBROUNDWITHHOLE,%1X%2X%3X%4X%5X%6")
         .arg(start.getX().toMmString(), start.getY().toMmString(),
@@ -30,6 +30,8 @@
 
 #include <QtCore>
 
+#include <array>
+
 /*******************************************************************************
  *  Namespace / Forward Declarations
  ******************************************************************************/
@@ -41,6 +43,11 @@ namespace librepcb {
 
 /**
  * @brief The GerberApertureList class
+ *
+ * Apertures are identified by a compact #Aperture value (shape and integer
+ * parameters) which is looked up in a hash table, so setting an aperture
+ * doesn't require any string formatting. The textual aperture definitions
+ * are only generated once per aperture by #generateString().
  */
 class GerberApertureList final {
   Q_DECLARE_TR_FUNCTIONS(GerberApertureList)
@@ -69,11 +76,34 @@ public:
   GerberApertureList& operator=(const GerberApertureList& rhs) = delete;
 
 private:
+  // Private Types
+  enum class Shape {
+    Circle,          ///< [diameter, hole]
+    Rect,            ///< [width, height, hole]
+    Obround,         ///< [width, height, hole]
+    RegularPolygon,  ///< [diameter, vertices, rotation, hole]
+    RotatedRect,     ///< [width, height, rotation, hole]
+    RotatedObround,  ///< [x1, y1, x2, y2, width, hole]
+  };
+  struct Aperture {
+    Shape                 shape;
+    std::array<qint64, 6> values;  ///< Lengths in nm, rotation in µdeg
+    bool operator==(const Aperture& rhs) const noexcept {
+      return (shape == rhs.shape) && (values == rhs.values);
+    }
+  };
+  friend uint qHash(const Aperture& key, uint seed) noexcept {
+    return ::qHash(static_cast<int>(key.shape),
+                   qHashRange(key.values.begin(), key.values.end(), seed));
+  }
+
   // Private Methods
-  int  setCurrentAperture(const QString& aperture) noexcept;
+  int  setCurrentAperture(const Aperture& aperture) noexcept;
   void addMacro(const QString& macro) noexcept;
 
   // Aperture Generator Methods
+  static QString generateAperture(const Aperture& aperture) noexcept;
+
   static QString generateCircle(const UnsignedLength& dia,
                                 const UnsignedLength& hole) noexcept;
   static QString generateRect(const UnsignedLength& w, const UnsignedLength& h,
@@ -91,14 +121,14 @@ private:
   static QString generateRotatedRect(const UnsignedLength& w,
                                      const UnsignedLength& h, const Angle& rot,
                                      const UnsignedLength& hole) noexcept;
-  static QString generateRotatedObround(const UnsignedLength& w,
-                                        const UnsignedLength& h,
-                                        const Angle&          rot,
+  static QString generateRotatedObround(const Point&          start,
+                                        const Point&          end,
+                                        const UnsignedLength& width,
                                         const UnsignedLength& hole) noexcept;
 
-  QList<QString> mApertureMacros;
-  QMap<int, QString>
-      mApertures;  ///< key: aperture number (>= 10); value: aperture definition
+  QList<QString>       mApertureMacros;
+  QVector<Aperture>    mApertures;        ///< index: aperture number - 10
+  QHash<Aperture, int> mApertureNumbers;  ///< value: aperture number (>= 10)
 };
 
 /*******************************************************************************
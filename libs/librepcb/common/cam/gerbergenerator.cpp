@@ -30,6 +30,8 @@
 
 #include <QtCore>
 
+#include <cstring>
+
 /*******************************************************************************
  *  Namespace
  ******************************************************************************/
@@ -46,14 +48,37 @@ GerberGenerator::GerberGenerator(const QString& projName, const Uuid& projUuid,
     mProjectRevision(escapeString(projRevision)),
     mOutput(),
     mContent(),
+    mContentFile(),
+    mContentFileError(),
+    mContentOffset(-1),
+    mOutputMd5(QCryptographicHash::Md5),
     mApertureList(new GerberApertureList()),
     mCurrentApertureNumber(-1),
     mMultiQuadrantArcModeOn(false) {
+  mContent.reserve(sInitialContentCapacity);
 }
 
 GerberGenerator::~GerberGenerator() noexcept {
 }
 
+/*******************************************************************************
+ *  Getters
+ ******************************************************************************/
+
+QByteArray GerberGenerator::toByteArray() const {
+  if (mContentOffset < 0) {
+    return mOutput;
+  } else {
+    QByteArray output = mOutput.left(mContentOffset);
+    QBuffer    buffer(&output);
+    buffer.open(QIODevice::Append);
+    writeContent(buffer);  // can throw
+    buffer.write(mOutput.constData() + mContentOffset,
+                 mOutput.size() - mContentOffset);
+    return output;
+  }
+}
+
 /*******************************************************************************
  *  Plot Methods
  ******************************************************************************/
@@ -194,21 +219,53 @@ void GerberGenerator::flashRegularPolygon(const Point&          pos,
 
 void GerberGenerator::reset() noexcept {
   mOutput.clear();
-  mContent.clear();
+  mContent.resize(0);  // keeps the allocated memory
+  mContentFile.reset();
+  mContentFileError.clear();
+  mContentOffset = -1;
+  mOutputMd5.reset();
   mApertureList->reset();
   mCurrentApertureNumber = -1;
 }
 
 void GerberGenerator::generate() {
   mOutput.clear();
+  mOutput.reserve((mContentFile ? 0 : mContent.size()) +
+                  4096);  // avoid reallocations
+  mContentOffset = -1;
+  mOutputMd5.reset();
   printHeader();
   printApertureList();
   printContent();
   printFooter();
+  if (!mContentFileError.isEmpty()) {
+    throw RuntimeError(__FILE__, __LINE__, mContentFileError);
+  }
 }
 
 void GerberGenerator::saveToFile(const FilePath& filepath) const {
-  FileUtils::writeFile(filepath, mOutput.toLatin1());  // can throw
+  if (mContentOffset < 0) {
+    FileUtils::writeFile(filepath, mOutput);  // can throw
+    return;
+  }
+
+  // stream the content from the temporary file into the output file
+  FileUtils::makePath(filepath.getParentDir());  // can throw
+  QSaveFile file(filepath.toStr());
+  if (!file.open(QIODevice::WriteOnly)) {
+    throw RuntimeError(__FILE__, __LINE__,
+                       QString(tr("Could not open or create file \"%1\": %2"))
+                           .arg(filepath.toNative(), file.errorString()));
+  }
+  file.write(mOutput.constData(), mContentOffset);
+  writeContent(file);  // can throw
+  file.write(mOutput.constData() + mContentOffset,
+             mOutput.size() - mContentOffset);
+  if (!file.commit()) {
+    throw RuntimeError(__FILE__, __LINE__,
+                       QString(tr("Could not write to file \"%1\": %2"))
+                           .arg(filepath.toNative(), file.errorString()));
+  }
 }
 
 /*******************************************************************************
@@ -217,7 +274,9 @@ void GerberGenerator::saveToFile(const FilePath& filepath) const {
 
 void GerberGenerator::setCurrentAperture(int number) noexcept {
   if (number != mCurrentApertureNumber) {
-    mContent.append(QString("D%1*\n").arg(number));
+    mContent.append('D');
+    appendInteger(mContent, number);
+    mContent.append("*\n");
     mCurrentApertureNumber = number;
   }
 }
@@ -257,13 +316,17 @@ void GerberGenerator::switchToCircularCcwInterpolationModeG03() noexcept {
 }
 
 void GerberGenerator::moveToPosition(const Point& pos) noexcept {
-  mContent.append(QString("X%1Y%2D02*\n")
-                      .arg(pos.getX().toNmString(), pos.getY().toNmString()));
+  appendCoordinate('X', pos.getX());
+  appendCoordinate('Y', pos.getY());
+  mContent.append("D02*\n");
+  flushContentIfTooLarge();
 }
 
 void GerberGenerator::linearInterpolateToPosition(const Point& pos) noexcept {
-  mContent.append(QString("X%1Y%2D01*\n")
-                      .arg(pos.getX().toNmString(), pos.getY().toNmString()));
+  appendCoordinate('X', pos.getX());
+  appendCoordinate('Y', pos.getY());
+  mContent.append("D01*\n");
+  flushContentIfTooLarge();
 }
 
 void GerberGenerator::circularInterpolateToPosition(const Point& start,
@@ -273,18 +336,65 @@ void GerberGenerator::circularInterpolateToPosition(const Point& start,
   if (!mMultiQuadrantArcModeOn) {
     diff.makeAbs();  // no sign allowed in single quadrant mode!
   }
-  mContent.append(QString("X%1Y%2I%3J%4D01*\n")
-                      .arg(end.getX().toNmString(), end.getY().toNmString(),
-                           diff.getX().toNmString(), diff.getY().toNmString()));
+  appendCoordinate('X', end.getX());
+  appendCoordinate('Y', end.getY());
+  appendCoordinate('I', diff.getX());
+  appendCoordinate('J', diff.getY());
+  mContent.append("D01*\n");
+  flushContentIfTooLarge();
 }
 
 void GerberGenerator::flashAtPosition(const Point& pos) noexcept {
-  mContent.append(QString("X%1Y%2D03*\n")
-                      .arg(pos.getX().toNmString(), pos.getY().toNmString()));
+  appendCoordinate('X', pos.getX());
+  appendCoordinate('Y', pos.getY());
+  mContent.append("D03*\n");
+  flushContentIfTooLarge();
+}
+
+void GerberGenerator::appendCoordinate(char          axis,
+                                       const Length& value) noexcept {
+  // coordinate format "6.6" in millimeters --> nanometers without decimals
+  mContent.append(axis);
+  appendInteger(mContent, value.toNm());
+}
+
+void GerberGenerator::flushContentIfTooLarge() noexcept {
+  if (mContent.size() > sMaxContentBufferSize) {
+    flushContent();
+  }
+}
+
+void GerberGenerator::flushContent() noexcept {
+  if (!mContentFile) {
+    mContentFile.reset(new QTemporaryFile());
+    if (!mContentFile->open()) {
+      mContentFileError = tr("Could not create temporary file: %1")
+                              .arg(mContentFile->errorString());
+    }
+  }
+  if (mContentFileError.isEmpty() &&
+      (mContentFile->write(mContent) != mContent.size())) {
+    mContentFileError = tr("Could not write to temporary file: %1")
+                            .arg(mContentFile->errorString());
+  }
+  mContent.resize(0);  // keeps the allocated memory
+}
+
+void GerberGenerator::writeContent(QIODevice& device) const {
+  Q_ASSERT(mContentFile);
+  if (!mContentFile->seek(0)) {
+    throw RuntimeError(__FILE__, __LINE__, mContentFile->errorString());
+  }
+  while (!mContentFile->atEnd()) {
+    QByteArray chunk = mContentFile->read(sContentFileChunkSize);
+    if (chunk.isEmpty() || (device.write(chunk) != chunk.size())) {
+      throw RuntimeError(__FILE__, __LINE__, device.errorString());
+    }
+  }
 }
 
 void GerberGenerator::printHeader() noexcept {
-  mOutput.append("G04 --- HEADER BEGIN --- *\n");
+  appendToOutput("G04 --- HEADER BEGIN --- *\n");
 
   // add some X2 attributes
   QString appVersion   = qApp->applicationVersion();
@@ -292,57 +402,88 @@ void GerberGenerator::printHeader() noexcept {
   QString projId       = mProjectId.remove(',');
   QString projUuid     = mProjectUuid.toStr();
   QString projRevision = mProjectRevision.remove(',');
-  mOutput.append(QString("%TF.GenerationSoftware,LibrePCB,LibrePCB,%1*%\n")
-                     .arg(appVersion));
-  mOutput.append(QString("%TF.CreationDate,%1*%\n").arg(creationDate));
-  mOutput.append(QString("%TF.ProjectId,%1,%2,%3*%\n")
-                     .arg(projId, projUuid, projRevision));
-  mOutput.append("%TF.Part,Single*%\n");  // "Single" means "this is a PCB"
-  // mOutput.append("%TF.FilePolarity,Positive*%\n");
+  appendToOutput(QString("%TF.GenerationSoftware,LibrePCB,LibrePCB,%1*%\n")
+                     .arg(appVersion)
+                     .toLatin1());
+  appendToOutput(
+      QString("%TF.CreationDate,%1*%\n").arg(creationDate).toLatin1());
+  appendToOutput(QString("%TF.ProjectId,%1,%2,%3*%\n")
+                     .arg(projId, projUuid, projRevision)
+                     .toLatin1());
+  appendToOutput("%TF.Part,Single*%\n");  // "Single" means "this is a PCB"
+  // appendToOutput("%TF.FilePolarity,Positive*%\n");
 
   // coordinate format specification:
   //  - leading zeros omitted
   //  - absolute coordinates
   //  - coordiante format "6.6" --> allows us to directly use LengthBase_t
   //  (nanometers)!
-  mOutput.append("%FSLAX66Y66*%\n");
+  appendToOutput("%FSLAX66Y66*%\n");
 
   // set unit to millimeters
-  mOutput.append("%MOMM*%\n");
+  appendToOutput("%MOMM*%\n");
 
   // start linear interpolation mode
-  mOutput.append("G01*\n");
+  appendToOutput("G01*\n");
 
   // use single quadrant arc mode
-  mOutput.append("G74*\n");
+  appendToOutput("G74*\n");
 
-  mOutput.append("G04 --- HEADER END --- *\n");
+  appendToOutput("G04 --- HEADER END --- *\n");
 }
 
 void GerberGenerator::printApertureList() noexcept {
-  mOutput.append(mApertureList->generateString());
+  appendToOutput(mApertureList->generateString().toLatin1());
 }
 
 void GerberGenerator::printContent() noexcept {
-  mOutput.append("G04 --- BOARD BEGIN --- *\n");
-  mOutput.append(mContent);
-  mOutput.append("G04 --- BOARD END --- *\n");
+  appendToOutput("G04 --- BOARD BEGIN --- *\n");
+  if (mContentFile) {
+    // The content is too large to keep it in memory, so only calculate the
+    // checksum here. It is inserted at #mContentOffset in #saveToFile().
+    flushContent();
+    mContentOffset = mOutput.size();
+    if (mContentFileError.isEmpty() && mContentFile->seek(0)) {
+      while (!mContentFile->atEnd()) {
+        QByteArray chunk = mContentFile->read(sContentFileChunkSize);
+        if (chunk.isEmpty()) break;
+        updateChecksum(chunk);
+      }
+    }
+  } else {
+    appendToOutput(mContent);
+  }
+  appendToOutput("G04 --- BOARD END --- *\n");
 }
 
 void GerberGenerator::printFooter() noexcept {
   // MD5 checksum over content
-  mOutput.append(QString("%TF.MD5,%1*%\n").arg(calcOutputMd5Checksum()));
+  QByteArray checksum = mOutputMd5.result().toHex();
+  mOutput.append("%TF.MD5,");
+  mOutput.append(checksum);
+  mOutput.append("*%\n");
 
   // end of file
   mOutput.append("M02*\n");
 }
 
-QString GerberGenerator::calcOutputMd5Checksum() const noexcept {
+void GerberGenerator::appendToOutput(const QByteArray& data) noexcept {
+  mOutput.append(data);
+  updateChecksum(data);
+}
+
+void GerberGenerator::updateChecksum(const QByteArray& data) noexcept {
   // according to the RS-274C standard, linebreaks are not included in the
   // checksum
-  QString data = QString(mOutput).remove(QChar('\n'));
-  return QString(
-      QCryptographicHash::hash(data.toUtf8(), QCryptographicHash::Md5).toHex());
+  const char* begin = data.constData();
+  const char* end   = begin + data.size();
+  while (begin < end) {
+    const char* lineEnd =
+        static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+    if (!lineEnd) lineEnd = end;
+    mOutputMd5.addData(begin, lineEnd - begin);
+    begin = lineEnd + 1;
+  }
 }
 
 /*******************************************************************************
@@ -363,6 +504,24 @@ QString GerberGenerator::escapeString(const QString& str) noexcept {
   return ret;
 }
 
+void GerberGenerator::appendInteger(QByteArray& output, qint64 value) noexcept {
+  // much faster than QString::number() since no locale or allocations
+  // are involved
+  char    buffer[24];  // enough for all 64 bit integers incl. sign
+  char*   end  = buffer + sizeof(buffer);
+  char*   pos  = end;
+  quint64 uval = (value < 0) ? (0 - static_cast<quint64>(value))
+                             : static_cast<quint64>(value);
+  do {
+    *--pos = static_cast<char>('0' + (uval % 10));
+    uval /= 10;
+  } while (uval > 0);
+  if (value < 0) {
+    *--pos = '-';
+  }
+  output.append(pos, end - pos);
+}
+
 /*******************************************************************************
  *  End of File
  ******************************************************************************/
@@ -46,6 +46,15 @@ class GerberApertureList;
 /**
  * @brief The GerberGenerator class
  *
+ * The output is written as ASCII directly into byte buffers, and coordinates
+ * are formatted with a simple integer to decimal conversion (no QString
+ * formatting). The MD5 checksum is calculated while the output is written.
+ *
+ * To keep the memory usage bounded for huge files (e.g. copper layers with
+ * large planes), the content is streamed into a temporary file as soon as it
+ * exceeds #sMaxContentBufferSize. It is then copied in chunks into the
+ * output file by #saveToFile().
+ *
  * @todo Remove/Escape illegal characters in #mProjectId and #mProjectRevision!
  * @todo Use file/aperture attributes
  */
@@ -66,7 +75,7 @@ public:
   ~GerberGenerator() noexcept;
 
   // Getters
-  const QString& toStr() const noexcept { return mOutput; }
+  QByteArray toByteArray() const;
 
   // Plot Methods
   void setLayerPolarity(LayerPolarity p) noexcept;
@@ -112,14 +121,20 @@ private:
   void    circularInterpolateToPosition(const Point& start, const Point& center,
                                         const Point& end) noexcept;
   void    flashAtPosition(const Point& pos) noexcept;
+  void    appendCoordinate(char axis, const Length& value) noexcept;
+  void    flushContentIfTooLarge() noexcept;
+  void    flushContent() noexcept;
+  void    writeContent(QIODevice& device) const;
   void    printHeader() noexcept;
   void    printApertureList() noexcept;
   void    printContent() noexcept;
   void    printFooter() noexcept;
-  QString calcOutputMd5Checksum() const noexcept;
+  void    appendToOutput(const QByteArray& data) noexcept;
+  void    updateChecksum(const QByteArray& data) noexcept;
 
   // Static Methods
   static QString escapeString(const QString& str) noexcept;
+  static void    appendInteger(QByteArray& output, qint64 value) noexcept;
 
   // Metadata
   QString mProjectId;
@@ -127,11 +142,24 @@ private:
   QString mProjectRevision;
 
   // Gerber Data
-  QString                            mOutput;
-  QString                            mContent;
+  QByteArray                         mOutput;
+  QByteArray                         mContent;
+  QScopedPointer<QTemporaryFile>     mContentFile;  ///< Streamed content
+  QString                            mContentFileError;
+  int                                mContentOffset;  ///< -1 if not streamed
+  QCryptographicHash                 mOutputMd5;  ///< Checksum of #mOutput
   QScopedPointer<GerberApertureList> mApertureList;
   int                                mCurrentApertureNumber;
   bool                               mMultiQuadrantArcModeOn;
+
+  /// Initial capacity of #mContent to avoid reallocations for small files
+  static const int sInitialContentCapacity = 64 * 1024;
+
+  /// Max. size of #mContent before it's streamed into #mContentFile
+  static const int sMaxContentBufferSize = 16 * 1024 * 1024;
+
+  /// Size of the chunks to read from #mContentFile
+  static const int sContentFileChunkSize = 1024 * 1024;
 };
 
 /*******************************************************************************
@@ -15,7 +15,7 @@ DEFINES += BUILD_OUTPUT_DIRECTORY="\\\"$${OUTPUT_DIR_ABS}\\\""
 DEFINES += SHARE_DIRECTORY_SOURCE="\\\"$${SHARE_DIR_ABS}\\\""
 DEFINES += GIT_COMMIT_SHA="\\\"$(shell git -C \""$$_PRO_FILE_PWD_"\" rev-parse --verify HEAD)\\\""
 
-QT += core widgets xml opengl network sql
+QT += core widgets xml opengl network sql concurrent
 
 CONFIG += staticlib
 
@@ -23,7 +23,6 @@ INCLUDEPATH += \
     ../../ \
     ../../fontobene \
     ../../quazip \
-    ../../sexpresso \
     ../../type_safe/include \
     ../../type_safe/external/debug_assert \
 
@@ -234,6 +233,7 @@ HEADERS += \
     utils/clipperhelpers.h \
     utils/exclusiveactiongroup.h \
     utils/graphicslayerstackappearancesettings.h \
+    utils/spatialindex.h \
     utils/toolbarproxy.h \
     utils/undostackactiongroup.h \
     uuid.h \
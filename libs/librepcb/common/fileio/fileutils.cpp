@@ -23,6 +23,7 @@
 #include "fileutils.h"
 
 #include "filepath.h"
+#include "sexpression.h"
 
 #include <QtCore>
 
@@ -74,6 +75,24 @@ void FileUtils::writeFile(const FilePath& filepath, const QByteArray& content) {
   }
 }
 
+void FileUtils::writeFile(const FilePath&    filepath,
+                          const SExpression& content) {
+  makePath(filepath.getParentDir());  // can throw
+  QSaveFile file(filepath.toStr());
+  if (!file.open(QIODevice::WriteOnly)) {
+    throw RuntimeError(__FILE__, __LINE__,
+                       QString(tr("Could not open or create file \"%1\": %2"))
+                           .arg(filepath.toNative(), file.errorString()));
+  }
+  content.write(file);  // can throw
+  if (!file.commit()) {
+    throw RuntimeError(__FILE__, __LINE__,
+                       QString(tr("Could not write to "
+                                  "file \"%1\": %2"))
+                           .arg(filepath.toNative(), file.errorString()));
+  }
+}
+
 void FileUtils::copyFile(const FilePath& source, const FilePath& dest) {
   if (!source.isExistingFile()) {
     throw LogicError(
@@ -33,6 +33,7 @@
 namespace librepcb {
 
 class FilePath;
+class SExpression;
 
 /*******************************************************************************
  *  Class FileUtils
@@ -76,6 +77,19 @@ public:
    */
   static void writeFile(const FilePath& filepath, const QByteArray& content);
 
+  /**
+   * @brief Serialize an S-Expression document into a file
+   *
+   * Same as #writeFile(const FilePath&, const QByteArray&), but the document
+   * is streamed into the file without building its content in memory first.
+   *
+   * @param filepath      The file to (over)write
+   * @param content       The document to write
+   *
+   * @throws Exception    If an error occurs.
+   */
+  static void writeFile(const FilePath& filepath, const SExpression& content);
+
   /**
    * @brief Copy a single file
    *
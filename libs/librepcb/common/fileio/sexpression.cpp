@@ -22,55 +22,550 @@
  ******************************************************************************/
 #include "sexpression.h"
 
-#include <sexpresso/sexpresso.hpp>
-
 #include <QtCore>
 
+#include <cstring>
+
 /*******************************************************************************
  *  Namespace
  ******************************************************************************/
 namespace librepcb {
 
+/*******************************************************************************
+ *  Struct SExpression::Node
+ ******************************************************************************/
+
+/**
+ * @brief A node of a parsed S-Expression, stored in the arena of ::Document
+ *
+ * The value is not copied but only referenced by its byte range in the
+ * source buffer. Children are linked as a singly linked list of arena indices.
+ */
+struct SExpression::Node {
+  Type type;
+  bool escaped;      ///< Whether the value contains escape sequences
+  int  valueBegin;   ///< Byte offset of the value in the source buffer
+  int  valueLength;  ///< Byte length of the value in the source buffer
+  int  firstChild;   ///< Arena index of the first child (-1 if none)
+  int  nextSibling;  ///< Arena index of the next sibling (-1 if none)
+  int  childCount;   ///< Number of children
+};
+
+/*******************************************************************************
+ *  Struct SExpression::Document
+ ******************************************************************************/
+
+/**
+ * @brief The source buffer and node arena of a parsed S-Expression file
+ *
+ * Shared by all nodes created from the same file, and kept alive as long as
+ * any of them exists. It is never modified after parsing, so it can be read
+ * from multiple threads without locking.
+ */
+struct SExpression::Document {
+  QByteArray    source;    ///< UTF-8 content of the file
+  FilePath      filePath;  ///< Path of the parsed file (for error messages)
+  QVector<Node> nodes;     ///< Arena of all nodes
+
+  QString decode(const Node& node) const noexcept {
+    const char* begin = source.constData() + node.valueBegin;
+    if (!node.escaped) {
+      return QString::fromUtf8(begin, node.valueLength);
+    }
+    QByteArray  unescaped;
+    const char* end = begin + node.valueLength;
+    unescaped.reserve(node.valueLength);
+    for (const char* p = begin; p < end; ++p) {
+      if ((*p == '\\') && (p + 1 < end)) {
+        ++p;
+        switch (*p) {
+          case 'a': unescaped.append('\a'); break;
+          case 'b': unescaped.append('\b'); break;
+          case 'f': unescaped.append('\f'); break;
+          case 'n': unescaped.append('\n'); break;
+          case 'r': unescaped.append('\r'); break;
+          case 't': unescaped.append('\t'); break;
+          case 'v': unescaped.append('\v'); break;
+          default: unescaped.append(*p); break;
+        }
+      } else {
+        unescaped.append(*p);
+      }
+    }
+    return QString::fromUtf8(unescaped);
+  }
+
+  bool equals(const Node& node, const QByteArray& utf8) const noexcept {
+    if (node.escaped) {
+      return decode(node).toUtf8() == utf8;
+    } else {
+      return (node.valueLength == utf8.length()) &&
+             (std::memcmp(source.constData() + node.valueBegin,
+                          utf8.constData(), node.valueLength) == 0);
+    }
+  }
+};
+
+/*******************************************************************************
+ *  Class SExpression::Parser
+ ******************************************************************************/
+
+/**
+ * @brief Single-pass parser filling the node arena of a ::Document
+ *
+ * Works directly on the UTF-8 bytes of the source buffer, without creating
+ * any strings.
+ */
+class SExpression::Parser final {
+public:
+  Parser(Document& document, const QSet<QByteArray>* rootChildren) noexcept
+    : mDocument(document),
+      mRootChildren(rootChildren),
+      mData(document.source.constData()),
+      mSize(document.source.size()),
+      mPos(0) {
+    // skip UTF-8 byte order mark, if any
+    if ((mSize >= 3) && (std::memcmp(mData, "\xEF\xBB\xBF", 3) == 0)) {
+      mPos = 3;
+    }
+  }
+
+  int parse() {
+    QVector<int> openLists;  // arena indices of all currently open lists
+    QVector<int> lastChild;  // last child of each open list (-1 if none)
+    int          root = -1;
+    while (true) {
+      skipWhitespace();
+      if (mPos >= mSize) {
+        break;
+      }
+      const char c = mData[mPos];
+      if (c == ')') {
+        if (openLists.isEmpty()) {
+          raise(mPos, tr("Unexpected closing parenthesis."));
+        }
+        openLists.removeLast();
+        lastChild.removeLast();
+        ++mPos;
+        continue;
+      }
+      const bool isList = (c == '(');
+      if (isList) {
+        const int listPos = mPos++;
+        skipWhitespace();
+        if ((mPos >= mSize) || (mData[mPos] == '(') || (mData[mPos] == ')')) {
+          raise(listPos, tr("List without name."));
+        }
+      }
+      const int index = parseAtom();
+      if (isList && mRootChildren && (openLists.count() == 1) &&
+          (!mRootChildren->contains(getRawValue(index)))) {
+        mDocument.nodes.removeLast();
+        skipList();
+        continue;
+      }
+      if (isList) {
+        mDocument.nodes[index].type = Type::List;
+      }
+      if (!openLists.isEmpty()) {
+        Node& parent = mDocument.nodes[openLists.last()];
+        if (lastChild.last() < 0) {
+          parent.firstChild = index;
+        } else {
+          mDocument.nodes[lastChild.last()].nextSibling = index;
+        }
+        ++parent.childCount;
+        lastChild.last() = index;
+      } else if ((root < 0) && isList) {
+        root = index;
+      } else {
+        raise(mDocument.nodes.at(index).valueBegin,
+              tr("File does not have exactly one root node."));
+      }
+      if (isList) {
+        openLists.append(index);
+        lastChild.append(-1);
+      }
+    }
+    if (!openLists.isEmpty()) {
+      raise(mSize, tr("Missing closing parenthesis."));
+    }
+    if (root < 0) {
+      raise(mSize, tr("File does not have exactly one root node."));
+    }
+    return root;
+  }
+
+private:
+  static bool isWhitespace(char c) noexcept {
+    return (c == ' ') || (c == '\n') || (c == '\r') || (c == '\t') ||
+           (c == '\f') || (c == '\v');
+  }
+
+  static bool isDelimiter(char c) noexcept {
+    return isWhitespace(c) || (c == '(') || (c == ')') || (c == '"');
+  }
+
+  void skipWhitespace() noexcept {
+    while ((mPos < mSize) && isWhitespace(mData[mPos])) {
+      ++mPos;
+    }
+  }
+
+  QByteArray getRawValue(int index) const noexcept {
+    const Node& node = mDocument.nodes.at(index);
+    return QByteArray::fromRawData(mData + node.valueBegin, node.valueLength);
+  }
+
+  /**
+   * @brief Skip the rest of a list whose name was already parsed
+   */
+  void skipList() {
+    int depth = 1;
+    while (mPos < mSize) {
+      const char c = mData[mPos++];
+      if (c == '(') {
+        ++depth;
+      } else if ((c == ')') && (--depth == 0)) {
+        return;
+      } else if (c == '"') {
+        const int quotePos = mPos - 1;
+        while ((mPos < mSize) && (mData[mPos] != '"')) {
+          if (mData[mPos] == '\\') {
+            ++mPos;  // skip escaped character
+          }
+          ++mPos;
+        }
+        if (mPos >= mSize) {
+          raise(quotePos, tr("Unterminated string."));
+        }
+        ++mPos;  // skip closing quote
+      }
+    }
+    raise(mSize, tr("Missing closing parenthesis."));
+  }
+
+  int parseAtom() {
+    Node node = {Type::Token, false, mPos, 0, -1, -1, 0};
+    if (mData[mPos] == '"') {
+      const int quotePos = mPos++;
+      node.type          = Type::String;
+      node.valueBegin    = mPos;
+      while ((mPos < mSize) && (mData[mPos] != '"')) {
+        if (mData[mPos] == '\\') {
+          node.escaped = true;
+          ++mPos;  // skip escaped character
+        }
+        ++mPos;
+      }
+      if (mPos >= mSize) {
+        raise(quotePos, tr("Unterminated string."));
+      }
+      node.valueLength = mPos - node.valueBegin;
+      ++mPos;  // skip closing quote
+    } else {
+      while ((mPos < mSize) && (!isDelimiter(mData[mPos]))) {
+        ++mPos;
+      }
+      node.valueLength = mPos - node.valueBegin;
+    }
+    mDocument.nodes.append(node);
+    return mDocument.nodes.count() - 1;
+  }
+
+  [[noreturn]] void raise(int pos, const QString& msg) const {
+    int line   = 1;
+    int column = 1;
+    for (int i = 0; (i < pos) && (i < mSize); ++i) {
+      if (mData[i] == '\n') {
+        ++line;
+        column = 1;
+      } else if ((static_cast<uchar>(mData[i]) & 0xC0) != 0x80) {
+        ++column;  // count characters, not UTF-8 continuation bytes
+      }
+    }
+    throw FileParseError(__FILE__, __LINE__, mDocument.filePath, line, column,
+                         QString(), msg);
+  }
+
+private:
+  Document&               mDocument;
+  const QSet<QByteArray>* mRootChildren;  ///< nullptr to parse everything
+  const char*             mData;
+  int                     mSize;
+  int                     mPos;
+};
+
+/*******************************************************************************
+ *  Class SExpression::Writer
+ ******************************************************************************/
+
+/**
+ * @brief Streaming serializer writing UTF-8 directly into a byte buffer
+ *
+ * The buffer is flushed to the output device whenever it exceeds a fixed
+ * size, so the whole document never needs to exist in memory at once. Without
+ * output device, the buffer collects the whole document instead.
+ */
+class SExpression::Writer final {
+public:
+  explicit Writer(QIODevice* device) noexcept
+    : mDevice(device), mLastChar('\0'), mFailed(false) {
+    mBuffer.reserve(sFlushThreshold + 1024);
+  }
+
+  const QByteArray& getBuffer() const noexcept { return mBuffer; }
+
+  void writeDocument(const SExpression& root) {
+    write(root, 0);  // can throw
+    append('\n');    // newline at end of file
+    flush();         // can throw
+  }
+
+  void flush() {
+    flushIfPossible();
+    if (mFailed) {
+      throw RuntimeError(__FILE__, __LINE__,
+                         QString(tr("Failed to write S-Expression: %1"))
+                             .arg(mErrorString));
+    }
+  }
+
+private:
+  /**
+   * @brief Write a node and return whether it contains line breaks
+   */
+  bool write(const SExpression& node, int indent) {
+    switch (node.mType) {
+      case Type::List: {
+        const QString& name = node.loadValue();
+        if (!isValidListName(name)) {
+          throw LogicError(
+              __FILE__, __LINE__,
+              QString(tr("Invalid S-Expression list name: %1")).arg(name));
+        }
+        append('(');
+        appendValue(node);
+        const QList<SExpression>& children  = node.getChildren();
+        bool                      multiLine = false;
+        for (int i = 0; i < children.count(); ++i) {
+          const SExpression& child = children.at(i);
+          if ((mLastChar != ' ') && (mLastChar != '\n') &&
+              (!child.isLineBreak())) {
+            append(' ');
+          }
+          bool nextChildIsLineBreak = (i < children.count() - 1)
+                                          ? children.at(i + 1).isLineBreak()
+                                          : true;
+          if (child.isLineBreak() && nextChildIsLineBreak) {
+            if ((i > 0) && children.at(i - 1).isLineBreak()) {
+              // too many line breaks ;)
+            } else {
+              append('\n');
+            }
+            multiLine = true;
+          } else if (write(child, indent + 1)) {
+            multiLine = true;
+          }
+        }
+        if (multiLine) {
+          append('\n');
+          appendIndent(indent);
+        }
+        append(')');
+        return multiLine;
+      }
+      case Type::Token: {
+        const QString& token = node.loadValue();
+        if (!isValidToken(token)) {
+          throw LogicError(
+              __FILE__, __LINE__,
+              QString(tr("Invalid S-Expression token: %1")).arg(token));
+        }
+        appendValue(node);
+        return false;
+      }
+      case Type::String: {
+        append('"');
+        appendEscaped(node.loadValue());
+        append('"');
+        return false;
+      }
+      case Type::LineBreak: {
+        append('\n');
+        appendIndent(indent);
+        return true;
+      }
+      default: { throw LogicError(__FILE__, __LINE__); }
+    }
+  }
+
+  static bool isValidListName(const QString& name) noexcept {
+    // [a-z][a-z0-9_]*
+    if (name.isEmpty()) {
+      return false;
+    }
+    for (int i = 0; i < name.length(); ++i) {
+      const ushort c = name.at(i).unicode();
+      if (!(((c >= 'a') && (c <= 'z')) ||
+            ((i > 0) && (((c >= '0') && (c <= '9')) || (c == '_'))))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static bool isValidToken(const QString& token) noexcept {
+    // [a-zA-Z0-9\.:_-]+
+    if (token.isEmpty()) {
+      return false;
+    }
+    foreach (const QChar& qc, token) {
+      const ushort c = qc.unicode();
+      if (!(((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) ||
+            ((c >= '0') && (c <= '9')) || (c == '.') || (c == ':') ||
+            (c == '_') || (c == '-'))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void append(char c) noexcept {
+    mBuffer.append(c);
+    mLastChar = c;
+    if (mBuffer.size() >= sFlushThreshold) {
+      flushIfPossible();
+    }
+  }
+
+  void appendIndent(int indent) noexcept {
+    static const QByteArray spaces(64, ' ');
+    if (indent > 0) {
+      mLastChar = ' ';
+    }
+    while (indent > 0) {
+      const int count = qMin(indent, spaces.size());
+      mBuffer.append(spaces.constData(), count);
+      indent -= count;
+    }
+  }
+
+  /**
+   * @brief Append a validated (i.e. ASCII-only) list name or token
+   */
+  void appendValue(const SExpression& node) noexcept {
+    foreach (const QChar& c, node.loadValue()) {
+      mBuffer.append(c.toLatin1());
+    }
+    mLastChar = mBuffer.at(mBuffer.size() - 1);
+  }
+
+  /**
+   * @brief Append a string as escaped UTF-8
+   */
+  void appendEscaped(const QString& string) noexcept {
+    const ushort* data   = string.utf16();
+    const int     length = string.length();
+    for (int i = 0; i < length; ++i) {
+      uint c = data[i];
+      if (c < 0x80) {
+        switch (c) {
+          case '"': mBuffer.append("\\\"", 2); break;
+          case '\\': mBuffer.append("\\\\", 2); break;
+          case '\a': mBuffer.append("\\a", 2); break;
+          case '\b': mBuffer.append("\\b", 2); break;
+          case '\f': mBuffer.append("\\f", 2); break;
+          case '\n': mBuffer.append("\\n", 2); break;
+          case '\r': mBuffer.append("\\r", 2); break;
+          case '\t': mBuffer.append("\\t", 2); break;
+          case '\v': mBuffer.append("\\v", 2); break;
+          default: mBuffer.append(static_cast<char>(c)); break;
+        }
+        continue;
+      }
+      if (QChar::isHighSurrogate(c) && (i + 1 < length) &&
+          QChar::isLowSurrogate(data[i + 1])) {
+        c = QChar::surrogateToUcs4(static_cast<ushort>(c), data[++i]);
+      } else if (QChar::isSurrogate(c)) {
+        // same as QString::toUtf8(), which was used by the former serializer
+        mBuffer.append('?');
+        continue;
+      }
+      if (c < 0x800) {
+        mBuffer.append(static_cast<char>(0xC0 | (c >> 6)));
+      } else if (c < 0x10000) {
+        mBuffer.append(static_cast<char>(0xE0 | (c >> 12)));
+        mBuffer.append(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+      } else {
+        mBuffer.append(static_cast<char>(0xF0 | (c >> 18)));
+        mBuffer.append(static_cast<char>(0x80 | ((c >> 12) & 0x3F)));
+        mBuffer.append(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+      }
+      mBuffer.append(static_cast<char>(0x80 | (c & 0x3F)));
+    }
+    mLastChar = '"';  // only used to check for whitespace
+  }
+
+  void flushIfPossible() noexcept {
+    // After a failed (or partial) write the output is incomplete anyway, so
+    // nothing is written anymore and the error is raised by flush().
+    if (mDevice && (!mBuffer.isEmpty())) {
+      if ((!mFailed) && (mDevice->write(mBuffer) != mBuffer.size())) {
+        mFailed      = true;
+        mErrorString = mDevice->errorString();
+      }
+      mBuffer.resize(0);  // keeps the reserved capacity
+    }
+  }
+
+private:
+  static constexpr int sFlushThreshold = 64 * 1024;
+  QIODevice*           mDevice;    ///< nullptr to collect everything
+  QByteArray           mBuffer;    ///< pending UTF-8 output
+  char                 mLastChar;  ///< last character written to mBuffer
+  bool                 mFailed;    ///< whether writing to mDevice failed
+  QString              mErrorString;
+};
+
 /*******************************************************************************
  *  Constructors / Destructor
  ******************************************************************************/
 
-SExpression::SExpression() noexcept : mType(Type::String) {
+SExpression::SExpression() noexcept
+  : mType(Type::String),
+    mNodeIndex(-1),
+    mValueLoaded(true),
+    mChildrenLoaded(true) {
 }
 
 SExpression::SExpression(Type type, const QString& value)
-  : mType(type), mValue(value) {
+  : mType(type),
+    mValue(value),
+    mNodeIndex(-1),
+    mValueLoaded(true),
+    mChildrenLoaded(true) {
 }
 
 SExpression::SExpression(const SExpression& other) noexcept
   : mType(other.mType),
     mValue(other.mValue),
     mChildren(other.mChildren),
-    mFilePath(other.mFilePath) {
+    mDocument(other.mDocument),
+    mNodeIndex(other.mNodeIndex),
+    mValueLoaded(other.mValueLoaded),
+    mChildrenLoaded(other.mChildrenLoaded) {
 }
 
-SExpression::SExpression(sexpresso::Sexp& sexp, const FilePath& filePath)
-  : mType(Type::List), mValue(), mFilePath(filePath) {
-  if (sexp.childCount() < 1) {
-    throw RuntimeError(__FILE__, __LINE__);
-  }
-
-  if (sexp.isSexp()) {
-    sexpresso::Sexp& first = sexp.getChild(0);
-    if (!first.isString()) {
-      throw RuntimeError(__FILE__, __LINE__);
-    }
-    mValue = QString::fromStdString(first.getString());
-    for (auto&& arg : sexp.arguments()) {
-      mChildren.append(SExpression(arg, filePath));
-    }
-  } else if (sexp.isString()) {
-    mValue = QString::fromStdString(sexp.getString());
-    mType  = Type::String;
-  } else {
-    throw FileParseError(__FILE__, __LINE__, mFilePath, -1, -1, QString(),
-                         tr("Unknown node type."));
-  }
+SExpression::SExpression(const QSharedPointer<const Document>& document,
+                         int index) noexcept
+  : mType(document->nodes.at(index).type),
+    mValue(),
+    mChildren(),
+    mDocument(document),
+    mNodeIndex(index),
+    mValueLoaded(false),
+    mChildrenLoaded(false) {
 }
 
 SExpression::~SExpression() noexcept {
@@ -80,7 +575,15 @@ SExpression::~SExpression() noexcept {
  *  Getters
  ******************************************************************************/
 
+const FilePath& SExpression::getFilePath() const noexcept {
+  static const FilePath invalid;
+  return mDocument ? mDocument->filePath : invalid;
+}
+
 bool SExpression::isMultiLineList() const noexcept {
+  if (!mChildrenLoaded) {
+    return false;  // the parser does not create line breaks
+  }
   foreach (const SExpression& child, mChildren) {
     if (child.isLineBreak() || (child.isMultiLineList())) {
       return true;
@@ -91,42 +594,69 @@ bool SExpression::isMultiLineList() const noexcept {
 
 const QString& SExpression::getName() const {
   if (isList()) {
-    return mValue;
+    return loadValue();
   } else {
-    throw FileParseError(__FILE__, __LINE__, mFilePath, -1, -1, QString(),
+    throw FileParseError(__FILE__, __LINE__, getFilePath(), -1, -1, QString(),
                          tr("Node is not a list."));
   }
 }
 
 const QString& SExpression::getStringOrToken(bool throwIfEmpty) const {
   if (!isToken() && !isString()) {
-    throw FileParseError(__FILE__, __LINE__, mFilePath, -1, -1, mValue,
-                         tr("Node is not a token or string."));
+    throw FileParseError(__FILE__, __LINE__, getFilePath(), -1, -1,
+                         loadValue(), tr("Node is not a token or string."));
   }
-  if (mValue.isEmpty() && throwIfEmpty) {
-    throw FileParseError(__FILE__, __LINE__, mFilePath, -1, -1, mValue,
+  if (loadValue().isEmpty() && throwIfEmpty) {
+    throw FileParseError(__FILE__, __LINE__, getFilePath(), -1, -1, mValue,
                          tr("Node value is empty."));
   }
   return mValue;
 }
 
+const QList<SExpression>& SExpression::getChildren() const noexcept {
+  if (!mChildrenLoaded) {
+    const Node& node = mDocument->nodes.at(mNodeIndex);
+    mChildren.reserve(node.childCount);
+    for (int i = node.firstChild; i >= 0;
+         i     = mDocument->nodes.at(i).nextSibling) {
+      mChildren.append(SExpression(mDocument, i));
+    }
+    mChildrenLoaded = true;
+  }
+  return mChildren;
+}
+
 QList<SExpression> SExpression::getChildren(const QString& name) const
     noexcept {
   QList<SExpression> children;
-  foreach (const SExpression& child, mChildren) {
-    if (child.isList() && (child.mValue == name)) {
-      children.append(child);
+  if (mChildrenLoaded) {
+    foreach (const SExpression& child, mChildren) {
+      if (child.isList() && (child.loadValue() == name)) {
+        children.append(child);
+      }
+    }
+  } else {
+    // compare names directly in the source buffer to avoid creating nodes
+    // which are not of interest
+    const QByteArray nameUtf8 = name.toUtf8();
+    for (int i = mDocument->nodes.at(mNodeIndex).firstChild; i >= 0;
+         i     = mDocument->nodes.at(i).nextSibling) {
+      const Node& child = mDocument->nodes.at(i);
+      if ((child.type == Type::List) && mDocument->equals(child, nameUtf8)) {
+        children.append(SExpression(mDocument, i));
+      }
     }
   }
   return children;
 }
 
 const SExpression& SExpression::getChildByIndex(int index) const {
-  if ((index < 0) || index >= mChildren.count()) {
-    throw FileParseError(__FILE__, __LINE__, mFilePath, -1, -1, QString(),
+  const QList<SExpression>& children = getChildren();
+  if ((index < 0) || index >= children.count()) {
+    throw FileParseError(__FILE__, __LINE__, getFilePath(), -1, -1, QString(),
                          QString(tr("Child not found: %1")).arg(index));
   }
-  return mChildren.at(index);
+  return children.at(index);
 }
 
 const SExpression* SExpression::tryGetChildByPath(const QString& path) const
@@ -134,8 +664,8 @@ const SExpression* SExpression::tryGetChildByPath(const QString& path) const
   const SExpression* child = this;
   foreach (const QString& name, path.split('/')) {
     bool found = false;
-    foreach (const SExpression& childchild, child->mChildren) {
-      if (childchild.isList() && (childchild.mValue == name)) {
+    foreach (const SExpression& childchild, child->getChildren()) {
+      if (childchild.isList() && (childchild.loadValue() == name)) {
         child = &childchild;
         found = true;
       }
@@ -152,7 +682,7 @@ const SExpression& SExpression::getChildByPath(const QString& path) const {
   if (child) {
     return *child;
   } else {
-    throw FileParseError(__FILE__, __LINE__, mFilePath, -1, -1, QString(),
+    throw FileParseError(__FILE__, __LINE__, getFilePath(), -1, -1, QString(),
                          QString(tr("Child not found: %1")).arg(path));
   }
 }
@@ -162,6 +692,7 @@ const SExpression& SExpression::getChildByPath(const QString& path) const {
  ******************************************************************************/
 
 SExpression& SExpression::appendLineBreak() {
+  getChildren();  // make sure children of parsed nodes are loaded
   mChildren.append(createLineBreak());
   return *this;
 }
@@ -174,6 +705,7 @@ SExpression& SExpression::appendChild(const SExpression& child,
                                       bool               linebreak) {
   if (mType == Type::List) {
     if (linebreak) appendLineBreak();
+    getChildren();  // make sure children of parsed nodes are loaded
     mChildren.append(child);
     return mChildren.last();
   } else {
@@ -182,6 +714,7 @@ SExpression& SExpression::appendChild(const SExpression& child,
 }
 
 void SExpression::removeLineBreaks() noexcept {
+  getChildren();  // make sure children of parsed nodes are loaded
   for (int i = mChildren.count() - 1; i >= 0; --i) {
     if (mChildren.at(i).isLineBreak()) {
       mChildren.removeAt(i);
@@ -189,10 +722,15 @@ void SExpression::removeLineBreaks() noexcept {
   }
 }
 
+void SExpression::write(QIODevice& device) const {
+  Writer writer(&device);
+  writer.writeDocument(*this);  // can throw
+}
+
 QByteArray SExpression::toByteArray() const {
-  QString str = toString(0);  // can throw
-  str += '\n';                // newline at end of file
-  return str.toUtf8();
+  Writer writer(nullptr);
+  writer.writeDocument(*this);  // can throw
+  return writer.getBuffer();
 }
 
 /*******************************************************************************
@@ -200,10 +738,13 @@ QByteArray SExpression::toByteArray() const {
  ******************************************************************************/
 
 SExpression& SExpression::operator=(const SExpression& rhs) noexcept {
-  mType     = rhs.mType;
-  mValue    = rhs.mValue;
-  mChildren = rhs.mChildren;
-  mFilePath = rhs.mFilePath;
+  mType           = rhs.mType;
+  mValue          = rhs.mValue;
+  mChildren       = rhs.mChildren;
+  mDocument       = rhs.mDocument;
+  mNodeIndex      = rhs.mNodeIndex;
+  mValueLoaded    = rhs.mValueLoaded;
+  mChildrenLoaded = rhs.mChildrenLoaded;
   return *this;
 }
 
@@ -211,62 +752,12 @@ SExpression& SExpression::operator=(const SExpression& rhs) noexcept {
  *  Private Methods
  ******************************************************************************/
 
-QString SExpression::escapeString(const QString& string) const noexcept {
-  return QString::fromStdString(sexpresso::escape(string.toStdString()));
-}
-
-bool SExpression::isValidListName(const QString& name) const noexcept {
-  return QRegExp("[a-z][a-z0-9_]*").exactMatch(name);
-}
-
-bool SExpression::isValidToken(const QString& token) const noexcept {
-  return QRegExp("[a-zA-Z0-9\\.:_-]+").exactMatch(token);
-}
-
-QString SExpression::toString(int indent) const {
-  if (mType == Type::List) {
-    if (!isValidListName(mValue)) {
-      throw LogicError(
-          __FILE__, __LINE__,
-          QString(tr("Invalid S-Expression list name: %1")).arg(mValue));
-    }
-    QString str = '(' + mValue;
-    for (int i = 0; i < mChildren.count(); ++i) {
-      const SExpression& child = mChildren.at(i);
-      if ((!str.at(str.length() - 1).isSpace()) && (!child.isLineBreak())) {
-        str += ' ';
-      }
-      bool nextChildIsLineBreak = (i < mChildren.count() - 1)
-                                      ? mChildren.at(i + 1).isLineBreak()
-                                      : true;
-      if (child.isLineBreak() && nextChildIsLineBreak) {
-        if ((i > 0) && mChildren.at(i - 1).isLineBreak()) {
-          // too many line breaks ;)
-        } else {
-          str += '\n';
-        }
-      } else {
-        str += child.toString(indent + 1);
-      }
-    }
-    if (isMultiLineList()) {
-      str += '\n' + QString(' ').repeated(indent);
-    }
-    return str + ')';
-  } else if (mType == Type::Token) {
-    if (!isValidToken(mValue)) {
-      throw LogicError(
-          __FILE__, __LINE__,
-          QString(tr("Invalid S-Expression token: %1")).arg(mValue));
-    }
-    return mValue;
-  } else if (mType == Type::String) {
-    return '"' + escapeString(mValue) + '"';
-  } else if (mType == Type::LineBreak) {
-    return '\n' + QString(' ').repeated(indent);
-  } else {
-    throw LogicError(__FILE__, __LINE__);
+const QString& SExpression::loadValue() const noexcept {
+  if (!mValueLoaded) {
+    mValue       = mDocument->decode(mDocument->nodes.at(mNodeIndex));
+    mValueLoaded = true;
   }
+  return mValue;
 }
 
 /*******************************************************************************
@@ -291,20 +782,25 @@ SExpression SExpression::createLineBreak() {
 
 SExpression SExpression::parse(const QByteArray& content,
                                const FilePath&   filePath) {
-  std::string     error;
-  QString         str  = QString::fromUtf8(content);
-  sexpresso::Sexp tree = sexpresso::parse(str.toStdString(), error);
-  if (error.empty()) {
-    if (tree.childCount() == 1) {
-      return SExpression(tree.getChild(0), filePath);
-    } else {
-      throw FileParseError(__FILE__, __LINE__, filePath, -1, -1, QString(),
-                           tr("File does not have exactly one root node."));
-    }
-  } else {
-    throw FileParseError(__FILE__, __LINE__, filePath, -1, -1, QString(),
-                         QString::fromStdString(error));
-  }
+  QSharedPointer<Document> document(new Document());
+  document->source   = content;  // implicitly shared, i.e. no deep copy
+  document->filePath = filePath;
+  Parser parser(*document, nullptr);
+  int    root = parser.parse();  // can throw
+  document->nodes.squeeze();
+  return SExpression(document, root);
+}
+
+SExpression SExpression::parse(const QByteArray&       content,
+                               const FilePath&         filePath,
+                               const QSet<QByteArray>& rootChildren) {
+  QSharedPointer<Document> document(new Document());
+  document->source   = content;  // implicitly shared, i.e. no deep copy
+  document->filePath = filePath;
+  Parser parser(*document, &rootChildren);
+  int    root = parser.parse();  // can throw
+  document->nodes.squeeze();
+  return SExpression(document, root);
 }
 
 /*******************************************************************************
@@ -32,10 +32,6 @@
 /*******************************************************************************
  *  Namespace / Forward Declarations
  ******************************************************************************/
-namespace sexpresso {
-struct Sexp;
-}
-
 namespace librepcb {
 
 class SExpression;
@@ -53,6 +49,31 @@ T deserializeFromSExpression(const SExpression& sexpr,
 
 /**
  * @brief The SExpression class
+ *
+ * Nodes created by #parse() do not own their content. All nodes of a parsed
+ * file are stored in a single arena together with the UTF-8 source buffer,
+ * and a node only references a byte range of that buffer. The corresponding
+ * QString values and child lists are created lazily when a getter asks for
+ * them, so parsing a file does not allocate a string per node.
+ *
+ * Lifetime: Every node created from a parsed file, including all copies of
+ * its children, keeps a reference to the whole source buffer and arena of
+ * that file. So keeping a single (small) child node alive keeps the whole
+ * file in memory. Parsed nodes should therefore only be kept while loading,
+ * and everything needed afterwards should be copied out with #getValue() and
+ * friends (see e.g. librepcb::library::LibraryBaseElement, which destroys its
+ * document after loading). References returned by #getChildren() and
+ * #getChildByPath() are valid as long as the node they were obtained from
+ * is neither modified nor destroyed.
+ *
+ * @warning Because of the lazy evaluation, const getters may modify internal
+ *          caches, which is not the case for other implicitly shared Qt
+ *          classes. Thus a single SExpression object must not be accessed
+ *          from multiple threads at the same time, not even through const
+ *          methods. Different objects (e.g. copies made by one thread and
+ *          handed over to other threads) may be used concurrently, even if
+ *          they refer to the same parsed file, because the source buffer and
+ *          arena are never modified after parsing.
  */
 class SExpression final {
   Q_DECLARE_TR_FUNCTIONS(SExpression)
@@ -72,7 +93,7 @@ public:
   ~SExpression() noexcept;
 
   // Getters
-  const FilePath& getFilePath() const noexcept { return mFilePath; }
+  const FilePath& getFilePath() const noexcept;
   Type            getType() const noexcept { return mType; }
   bool            isList() const noexcept { return mType == Type::List; }
   bool            isToken() const noexcept { return mType == Type::Token; }
@@ -81,7 +102,7 @@ public:
   bool isMultiLineList() const noexcept;
   const QString&            getName() const;
   const QString&            getStringOrToken(bool throwIfEmpty = false) const;
-  const QList<SExpression>& getChildren() const { return mChildren; }
+  const QList<SExpression>& getChildren() const noexcept;
   QList<SExpression>        getChildren(const QString& name) const noexcept;
   const SExpression&        getChildByIndex(int index) const;
   const SExpression* tryGetChildByPath(const QString& path) const noexcept;
@@ -92,8 +113,8 @@ public:
     try {
       return deserializeFromSExpression<T>(*this, throwIfEmpty);
     } catch (const Exception& e) {
-      throw FileParseError(__FILE__, __LINE__, mFilePath, -1, -1, mValue,
-                           e.getMsg());
+      throw FileParseError(__FILE__, __LINE__, getFilePath(), -1, -1,
+                           loadValue(), e.getMsg());
     }
   }
 
@@ -105,11 +126,12 @@ public:
 
   template <typename T>
   T getValueOfFirstChild(bool throwIfEmpty = false) const {
-    if (mChildren.count() < 1) {
-      throw FileParseError(__FILE__, __LINE__, mFilePath, -1, -1, QString(),
-                           tr("Node does not have children."));
+    const QList<SExpression>& children = getChildren();
+    if (children.count() < 1) {
+      throw FileParseError(__FILE__, __LINE__, getFilePath(), -1, -1,
+                           QString(), tr("Node does not have children."));
     }
-    return mChildren.at(0).getValue<T>(throwIfEmpty);
+    return children.at(0).getValue<T>(throwIfEmpty);
   }
 
   // General Methods
@@ -126,6 +148,7 @@ public:
     return appendList(child, linebreak).appendChild(obj);
   }
   void       removeLineBreaks() noexcept;
+  void       write(QIODevice& device) const;
   QByteArray toByteArray() const;
 
   // Operator Overloadings
@@ -138,20 +161,45 @@ public:
   static SExpression createLineBreak();
   static SExpression parse(const QByteArray& content, const FilePath& filePath);
 
+  /**
+   * @brief Parse only some of the lists directly below the root node
+   *
+   * All other lists of the root node are skipped without creating any nodes,
+   * e.g. to read only the metadata of a file without its (possibly huge)
+   * content. Tokens and strings of the root node are always kept.
+   *
+   * @param content       The UTF-8 content to parse.
+   * @param filePath      The file path used for error messages.
+   * @param rootChildren  Names of the root children to parse.
+   *
+   * @return The parsed root node.
+   */
+  static SExpression parse(const QByteArray& content, const FilePath& filePath,
+                           const QSet<QByteArray>& rootChildren);
+
+private:  // Types
+  struct Node;
+  struct Document;
+  class Parser;
+  class Writer;
+
 private:  // Methods
   SExpression(Type type, const QString& value);
-  SExpression(sexpresso::Sexp& sexp, const FilePath& filePath);
+  SExpression(const QSharedPointer<const Document>& document,
+              int                                   index) noexcept;
 
-  QString escapeString(const QString& string) const noexcept;
-  bool    isValidListName(const QString& name) const noexcept;
-  bool    isValidToken(const QString& token) const noexcept;
-  QString toString(int indent) const;
+  const QString& loadValue() const noexcept;
 
 private:  // Data
-  Type               mType;
-  QString            mValue;  ///< either a list name, a token or a string
-  QList<SExpression> mChildren;
-  FilePath           mFilePath;
+  Type                       mType;
+  mutable QString            mValue;  ///< list name, token or string
+  mutable QList<SExpression> mChildren;
+
+  // Lazy evaluation of parsed nodes
+  QSharedPointer<const Document> mDocument;  ///< nullptr if not parsed
+  int                            mNodeIndex;  ///< Index in arena of mDocument
+  mutable bool mValueLoaded;     ///< Whether mValue is up to date
+  mutable bool mChildrenLoaded;  ///< Whether mChildren is up to date
 };
 
 /*******************************************************************************
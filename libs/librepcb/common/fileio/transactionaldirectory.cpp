@@ -22,6 +22,7 @@
  ******************************************************************************/
 #include "transactionaldirectory.h"
 
+#include "sexpression.h"
 #include "transactionalfilesystem.h"
 
 /*******************************************************************************
@@ -143,6 +144,22 @@ void TransactionalDirectory::moveTo(TransactionalDirectory& dest) {
   mPath       = dest.mPath;
 }
 
+void TransactionalDirectory::preloadSExpressions(
+    const QStringList& paths) noexcept {
+  QStringList fsPaths;
+  foreach (const QString& path, paths) { fsPaths.append(mPath % "/" % path); }
+  mFileSystem->preloadSExpressions(fsPaths);
+}
+
+void TransactionalDirectory::discardPreloadedSExpressions() noexcept {
+  mFileSystem->discardPreloadedSExpressions(mPath.isEmpty() ? QString()
+                                                            : mPath % "/");
+}
+
+SExpression TransactionalDirectory::readSExpression(const QString& path) const {
+  return mFileSystem->readSExpression(mPath % "/" % path);  // can throw
+}
+
 /*******************************************************************************
  *  Private Methods
  ******************************************************************************/
@@ -35,6 +35,7 @@
 
 namespace librepcb {
 
+class SExpression;
 class TransactionalFileSystem;
 
 /*******************************************************************************
@@ -95,6 +96,24 @@ public:
   void saveTo(TransactionalDirectory& dest);
   void moveTo(TransactionalDirectory& dest);
 
+  /**
+   * @copydoc librepcb::TransactionalFileSystem::preloadSExpressions()
+   */
+  void preloadSExpressions(const QStringList& paths) noexcept;
+
+  /**
+   * @brief Release preloaded documents of this directory which were not
+   *        fetched
+   *
+   * @see librepcb::TransactionalFileSystem::discardPreloadedSExpressions()
+   */
+  void discardPreloadedSExpressions() noexcept;
+
+  /**
+   * @copydoc librepcb::TransactionalFileSystem::readSExpression()
+   */
+  SExpression readSExpression(const QString& path) const;
+
 private:  // Methods
   static void copyDirRecursively(TransactionalFileSystem& srcFs,
                                  const QString&           srcDir,
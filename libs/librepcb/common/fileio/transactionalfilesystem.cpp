@@ -26,9 +26,10 @@
 #include "fileutils.h"
 #include "sexpression.h"
 
+#include <QtConcurrent/QtConcurrent>
 #include <quazip/quazip.h>
-#include <quazip/quazipdir.h>
 #include <quazip/quazipfile.h>
+#include <zlib.h>
 
 /*******************************************************************************
  *  Namespace
@@ -47,7 +48,9 @@ TransactionalFileSystem::TransactionalFileSystem(const FilePath& filepath,
     mFilePath(filepath),
     mIsWritable(writable),
     mLock(filepath),
-    mRestoredFromAutosave(false) {
+    mRestoredFromAutosave(false),
+    mGeneration(0),
+    mAutosaveGeneration(0) {
   // Load the backup if there is one (i.e. last save operation has failed).
   FilePath backupFile = mFilePath.getPathTo(".backup/backup.lp");
   if (backupFile.isExistingFile()) {
@@ -136,11 +139,12 @@ QStringList TransactionalFileSystem::getDirs(const QString& path) const
   }
 
   // add directories of new files
-  foreach (const QString& filepath, mModifiedFiles.keys()) {
-    if (filepath.startsWith(dirpath)) {
-      QStringList relpath = filepath.mid(dirpath.length()).split('/');
-      if (relpath.count() > 1) {
-        dirnames.insert(relpath.first());
+  if (const IndexNode* node = findIndexNode(dirpath)) {
+    for (auto it = node->children.constBegin();
+         it != node->children.constEnd(); ++it) {
+      const IndexNode& child = **it;
+      if (child.modifiedFilesCount > (child.isModifiedFile ? 1 : 0)) {
+        dirnames.insert(it.key());
       }
     }
   }
@@ -163,11 +167,11 @@ QStringList TransactionalFileSystem::getFiles(const QString& path) const
   }
 
   // add new files
-  foreach (const QString& filepath, mModifiedFiles.keys()) {
-    if (filepath.startsWith(dirpath)) {
-      QStringList relpath = filepath.mid(dirpath.length()).split('/');
-      if (relpath.count() == 1) {
-        filenames.insert(relpath.first());
+  if (const IndexNode* node = findIndexNode(dirpath)) {
+    for (auto it = node->children.constBegin();
+         it != node->children.constEnd(); ++it) {
+      if ((*it)->isModifiedFile) {
+        filenames.insert(it.key());
       }
     }
   }
@@ -189,7 +193,7 @@ bool TransactionalFileSystem::fileExists(const QString& path) const noexcept {
 QByteArray TransactionalFileSystem::read(const QString& path) const {
   QString cleanedPath = cleanPath(path);
   if (mModifiedFiles.contains(cleanedPath)) {
-    return mModifiedFiles.value(cleanedPath);
+    return readModifiedFile(cleanedPath);  // can throw
   } else if (!isRemoved(cleanedPath)) {
     return FileUtils::readFile(mFilePath.getPathTo(cleanedPath));  // can throw
   } else {
@@ -201,31 +205,24 @@ QByteArray TransactionalFileSystem::read(const QString& path) const {
 
 void TransactionalFileSystem::write(const QString&    path,
                                     const QByteArray& content) {
-  QString cleanedPath         = cleanPath(path);
-  mModifiedFiles[cleanedPath] = content;
-  mRemovedFiles.remove(cleanedPath);
+  QString cleanedPath = cleanPath(path);
+  discardPreloadedSExpressions(cleanedPath);
+  insertModifiedFile(cleanedPath, content);
+  setFileRemoved(cleanedPath, false);
 }
 
 void TransactionalFileSystem::removeFile(const QString& path) {
   QString cleanedPath = cleanPath(path);
-  mModifiedFiles.remove(cleanedPath);
-  mRemovedFiles.insert(cleanedPath);
+  discardPreloadedSExpressions(cleanedPath);
+  removeModifiedFile(cleanedPath);
+  setFileRemoved(cleanedPath, true);
 }
 
 void TransactionalFileSystem::removeDirRecursively(const QString& path) {
   QString dirpath = cleanPath(path);
   if (!dirpath.isEmpty()) dirpath.append("/");
-  foreach (const QString& fp, mModifiedFiles.keys()) {
-    if (dirpath.isEmpty() || fp.startsWith(dirpath)) {
-      mModifiedFiles.remove(fp);
-    }
-  }
-  foreach (const QString& fp, mRemovedFiles) {
-    if (dirpath.isEmpty() || fp.startsWith(dirpath)) {
-      mRemovedFiles.remove(fp);
-    }
-  }
-  mRemovedDirs.insert(dirpath);
+  discardPreloadedSExpressions(dirpath);
+  insertRemovedDir(dirpath);
 }
 
 /*******************************************************************************
@@ -233,22 +230,70 @@ void TransactionalFileSystem::removeDirRecursively(const QString& path) {
  ******************************************************************************/
 
 void TransactionalFileSystem::loadFromZip(const FilePath& fp) {
-  QuaZip zip(fp.toStr());
-  if (!zip.open(QuaZip::mdUnzip)) {
+  // Only one archive can be kept open, so a previously loaded archive has to
+  // be read into memory first.
+  releaseZip();  // can throw
+
+  std::unique_ptr<QuaZip> zip(new QuaZip(fp.toStr()));
+  if (!zip->open(QuaZip::mdUnzip)) {
     throw RuntimeError(
         __FILE__, __LINE__,
         QString(tr("Failed to open the ZIP file '%1'.")).arg(fp.toNative()));
   }
-  QuaZipFile file(&zip);
-  for (bool f = zip.goToFirstFile(); f; f = zip.goToNextFile()) {
-    file.open(QIODevice::ReadOnly);
-    write(file.getActualFileName(), file.readAll());
-    file.close();
+
+  // Only read the central directory, the file contents are decompressed
+  // on demand by readFromZip().
+  QHash<QString, QString> files;
+  for (bool f = zip->goToFirstFile(); f; f = zip->goToNextFile()) {
+    QString name = zip->getCurrentFileName();
+    if (name.endsWith('/')) continue;  // skip directory entries
+    files.insert(cleanPath(name), name);
+  }
+  discardPreloadedSExpressions("");
+  for (auto it = files.constBegin(); it != files.constEnd(); ++it) {
+    insertModifiedFile(it.key(), QByteArray());  // placeholder content
+    setFileRemoved(it.key(), false);
   }
-  zip.close();
+  mZipFiles.unite(files);
+
+  QMutexLocker lock(&mZipMutex);
+  mZip         = std::move(zip);
+  mZipFilePath = fp;
 }
 
 void TransactionalFileSystem::exportToZip(const FilePath& fp) const {
+  // If the archive is overwritten, all its files need to be read before.
+  if (fp == mZipFilePath) {
+    releaseZip();  // can throw
+  }
+
+  struct Entry {
+    QString                    path;
+    QByteArray                 data;  ///< Raw deflated content
+    qint64                     size;
+    quint32                    crc;
+    std::shared_ptr<Exception> error;
+  };
+  QStringList files;
+  collectFilesForZip(files, fp, "");  // can throw
+  QVector<Entry> entries;
+  foreach (const QString& filepath, files) {
+    entries.append(Entry{filepath, QByteArray(), 0, 0, nullptr});
+  }
+
+  // Reading and compressing the files is done in parallel. Reading files is
+  // thread-safe as long as the file system is not modified, which is
+  // guaranteed since we block until all files are compressed.
+  QtConcurrent::blockingMap(entries, [this](Entry& entry) {
+    try {
+      QByteArray content = read(entry.path);                // can throw
+      entry.data         = deflateRaw(content, entry.crc);  // can throw
+      entry.size         = content.size();
+    } catch (const Exception& e) {
+      entry.error.reset(e.clone());
+    }
+  });
+
   QuaZip zip(fp.toStr());
   if (!zip.open(QuaZip::mdCreate)) {
     throw RuntimeError(
@@ -257,7 +302,29 @@ void TransactionalFileSystem::exportToZip(const FilePath& fp) const {
   }
   try {
     QuaZipFile file(&zip);
-    exportDirToZip(file, fp, "");
+    foreach (const Entry& entry, entries) {
+      if (entry.error) {
+        entry.error->raise();
+      }
+      // add the already compressed file content to the ZIP archive
+      QuaZipNewInfo newFileInfo(entry.path);
+      newFileInfo.setPermissions(
+          QFileDevice::ReadOwner | QFileDevice::ReadGroup |
+          QFileDevice::ReadOther | QFileDevice::WriteOwner);
+      newFileInfo.uncompressedSize = entry.size;
+      if (!file.open(QIODevice::WriteOnly, newFileInfo, nullptr, entry.crc,
+                     Z_DEFLATED, Z_DEFAULT_COMPRESSION, true)) {
+        throw RuntimeError(__FILE__, __LINE__);
+      }
+      qint64 bytesWritten = file.write(entry.data);
+      file.close();
+      if ((bytesWritten != entry.data.length()) ||
+          (file.getZipError() != UNZ_OK)) {
+        throw RuntimeError(__FILE__, __LINE__,
+                           QString(tr("Failed to write file '%1' to '%2'."))
+                               .arg(entry.path, fp.toNative()));
+      }
+    }
     zip.close();
   } catch (const Exception& e) {
     // Remove ZIP file because it is not complete
@@ -268,7 +335,34 @@ void TransactionalFileSystem::exportToZip(const FilePath& fp) const {
 }
 
 void TransactionalFileSystem::autosave() {
-  saveDiff("autosave");  // can throw
+  // files not modified since the last autosave are still valid in the
+  // directories of previous autosaves, so they don't need to be written again
+  QHash<QString, QString> filesDirs;
+  for (auto it = mAutosavedFiles.constBegin(); it != mAutosavedFiles.constEnd();
+       ++it) {
+    if (mModifiedFilesGenerations.value(it.key()) <= mAutosaveGeneration) {
+      filesDirs.insert(it.key(), it.value());
+    }
+  }
+  saveDiff("autosave", &filesDirs);  // can throw
+  mAutosavedFiles     = filesDirs;
+  mAutosaveGeneration = mGeneration;
+
+  // remove directories of previous autosaves which are not referenced anymore
+  QSet<QString> usedDirs = filesDirs.values().toSet();
+  QDir          dir(mFilePath.getPathTo(".autosave").toStr());
+  foreach (const QString& dirname,
+           dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+    if (!usedDirs.contains(dirname)) {
+      try {
+        FileUtils::removeDirRecursively(
+            FilePath(dir.absoluteFilePath(dirname)));  // can throw
+      } catch (const Exception& e) {
+        qWarning() << "Could not remove outdated autosave directory:"
+                   << e.getMsg();
+      }
+    }
+  }
 }
 
 void TransactionalFileSystem::save() {
@@ -281,7 +375,8 @@ void TransactionalFileSystem::save() {
 
   // remove autosave directory because it is now older than the backup content
   // (the user should not be able to restore the outdated autosave backup)
-  removeDiff("autosave");  // can throw
+  mAutosavedFiles.clear();  // next autosave has to write all files again
+  removeDiff("autosave");   // can throw
 
   // remove directories
   foreach (const QString& dir, mRemovedDirs) {
@@ -302,7 +397,7 @@ void TransactionalFileSystem::save() {
   // save new or modified files
   foreach (const QString& filepath, mModifiedFiles.keys()) {
     FileUtils::writeFile(mFilePath.getPathTo(filepath),
-                         mModifiedFiles.value(filepath));  // can throw
+                         readModifiedFile(filepath));  // can throw
   }
 
   // remove backup
@@ -312,6 +407,54 @@ void TransactionalFileSystem::save() {
   discardChanges();
 }
 
+void TransactionalFileSystem::preloadSExpressions(
+    const QStringList& paths) noexcept {
+  struct Document {
+    QString     path;
+    SExpression root;
+    bool        valid;
+  };
+  QVector<Document> documents;
+  foreach (const QString& path, paths) {
+    documents.append(Document{cleanPath(path), SExpression(), false});
+  }
+
+  // Reading files is thread-safe as long as the file system is not modified,
+  // which is guaranteed since we block until all files are parsed.
+  QtConcurrent::blockingMap(documents, [this](Document& doc) {
+    try {
+      doc.root  = SExpression::parse(read(doc.path),
+                                    getAbsPath(doc.path));  // can throw
+      doc.valid = true;
+    } catch (const Exception&) {
+      // the error will be raised again when the file is actually loaded
+    }
+  });
+
+  QMutexLocker lock(&mPreloadedSExpressionsMutex);
+  foreach (const Document& doc, documents) {
+    if (doc.valid) {
+      mPreloadedSExpressions.insert(doc.path, doc.root);
+    }
+  }
+}
+
+SExpression TransactionalFileSystem::readSExpression(
+    const QString& path) const {
+  QString cleanedPath = cleanPath(path);
+  {
+    QMutexLocker lock(&mPreloadedSExpressionsMutex);
+    auto         it = mPreloadedSExpressions.find(cleanedPath);
+    if (it != mPreloadedSExpressions.end()) {
+      SExpression root = *it;
+      mPreloadedSExpressions.erase(it);  // not needed anymore
+      return root;
+    }
+  }
+  return SExpression::parse(read(cleanedPath),
+                            getAbsPath(cleanedPath));  // can throw
+}
+
 /*******************************************************************************
  *  Static Methods
  ******************************************************************************/
@@ -329,33 +472,37 @@ QString TransactionalFileSystem::cleanPath(QString path) noexcept {
  ******************************************************************************/
 
 bool TransactionalFileSystem::isRemoved(const QString& path) const noexcept {
-  if (mRemovedFiles.contains(path)) {
-    return true;
-  }
-
-  foreach (const QString dir, mRemovedDirs) {
-    if (path.startsWith(dir)) {
-      return true;
+  // path is either a file or a directory with trailing slash
+  bool             isDir = path.isEmpty() || path.endsWith('/');
+  QStringList      names = path.split('/', QString::SkipEmptyParts);
+  const IndexNode* node  = &mIndex;
+  for (int i = 0; i < names.count(); ++i) {
+    if (node->isRemovedDir) {
+      return true;  // a parent directory was removed
+    }
+    auto it = node->children.constFind(names.at(i));
+    if (it == node->children.constEnd()) {
+      return false;  // no modifications at all within this directory
     }
+    node = it->get();
   }
-
-  return false;
+  return isDir ? node->isRemovedDir : node->isRemovedFile;
 }
 
-void TransactionalFileSystem::exportDirToZip(QuaZipFile&     file,
-                                             const FilePath& zipFp,
-                                             const QString&  dir) const {
+void TransactionalFileSystem::collectFilesForZip(QStringList&    files,
+                                                 const FilePath& zipFp,
+                                                 const QString&  dir) const {
   QString path = dir.isEmpty() ? dir : dir % "/";
 
-  // export directories
-  foreach (const QString& dirname, getDirs(dir)) {
+  // collect files of directories
+  foreach (const QString& dirname, Toolbox::sorted(getDirs(dir))) {
     // skip dotdirs, e.g. ".git", ".svn", ".autosave", ".backup"
     if (dirname.startsWith('.')) continue;
-    exportDirToZip(file, zipFp, path % dirname);
+    collectFilesForZip(files, zipFp, path % dirname);
   }
 
-  // export files
-  foreach (const QString& filename, getFiles(dir)) {
+  // collect files
+  foreach (const QString& filename, Toolbox::sorted(getFiles(dir))) {
     QString filepath = path % filename;
     if (filepath == zipFp.toRelative(mFilePath)) {
       // In case the exported ZIP file is located inside this file system,
@@ -364,26 +511,12 @@ void TransactionalFileSystem::exportDirToZip(QuaZipFile&     file,
     }
     // skip lock file
     if (filename == ".lock") continue;
-    // read file content and add it to the ZIP archive
-    const QByteArray& content = read(filepath);  // can throw
-    QuaZipNewInfo     newFileInfo(filepath);
-    newFileInfo.setPermissions(QFileDevice::ReadOwner | QFileDevice::ReadGroup |
-                               QFileDevice::ReadOther |
-                               QFileDevice::WriteOwner);
-    if (!file.open(QIODevice::WriteOnly, newFileInfo)) {
-      throw RuntimeError(__FILE__, __LINE__);
-    }
-    qint64 bytesWritten = file.write(content);
-    file.close();
-    if (bytesWritten != content.length()) {
-      throw RuntimeError(__FILE__, __LINE__,
-                         QString(tr("Failed to write file '%1' to '%2'."))
-                             .arg(filepath, zipFp.toNative()));
-    }
+    files.append(filepath);
   }
 }
 
-void TransactionalFileSystem::saveDiff(const QString& type) const {
+void TransactionalFileSystem::saveDiff(
+    const QString& type, QHash<QString, QString>* filesDirs) const {
   QDateTime dt       = QDateTime::currentDateTime();
   FilePath  dir      = mFilePath.getPathTo("." % type);
   FilePath  filesDir = dir.getPathTo(dt.toString("yyyy-MM-dd_hh-mm-ss-zzz"));
@@ -395,10 +528,20 @@ void TransactionalFileSystem::saveDiff(const QString& type) const {
   SExpression root = SExpression::createList("librepcb_" % type);
   root.appendChild("created", dt, true);
   root.appendChild("modified_files_directory", filesDir.getFilename(), true);
+  QHash<QString, QString> writtenFilesDirs;
   foreach (const QString& filepath, Toolbox::sorted(mModifiedFiles.keys())) {
-    root.appendChild("modified_file", filepath, true);
-    FileUtils::writeFile(filesDir.getPathTo(filepath),
-                         mModifiedFiles.value(filepath));  // can throw
+    QString filesDirName = filesDirs ? filesDirs->value(filepath) : QString();
+    if (filesDirName.isEmpty()) {
+      root.appendChild("modified_file", filepath, true);
+      filesDirName = filesDir.getFilename();
+      FileUtils::writeFile(filesDir.getPathTo(filepath),
+                           readModifiedFile(filepath));  // can throw
+    } else {
+      // file is already contained in the directory of a previous diff
+      root.appendChild("modified_file", filepath, true)
+          .appendChild("directory", filesDirName, false);
+    }
+    writtenFilesDirs.insert(filepath, filesDirName);
   }
   foreach (const QString& filepath, Toolbox::sorted(mRemovedFiles.toList())) {
     root.appendChild("removed_file", filepath, true);
@@ -411,6 +554,9 @@ void TransactionalFileSystem::saveDiff(const QString& type) const {
   // complete!
   FileUtils::writeFile(dir.getPathTo(type % ".lp"),
                        root.toByteArray());  // can throw
+  if (filesDirs) {
+    *filesDirs = writtenFilesDirs;
+  }
 }
 
 void TransactionalFileSystem::loadDiff(const FilePath& fp) {
@@ -421,18 +567,26 @@ void TransactionalFileSystem::loadDiff(const FilePath& fp) {
   QString modifiedFilesDirName =
       root.getValueByPath<QString>("modified_files_directory", true);
   FilePath modifiedFilesDir = fp.getParentDir().getPathTo(modifiedFilesDirName);
+  // Note: Load removed directories first since this drops all modifications
+  // within these directories.
+  foreach (const SExpression& node, root.getChildren("removed_directory")) {
+    QString relPath = node.getValueOfFirstChild<QString>(true);
+    insertRemovedDir(relPath);
+  }
   foreach (const SExpression& node, root.getChildren("modified_file")) {
     QString  relPath = node.getValueOfFirstChild<QString>(true);
     FilePath absPath = modifiedFilesDir.getPathTo(relPath);
-    mModifiedFiles.insert(relPath, FileUtils::readFile(absPath));  // can throw
+    if (const SExpression* child = node.tryGetChildByPath("directory")) {
+      // file is contained in the directory of a previous (incremental) diff
+      absPath = fp.getParentDir()
+                    .getPathTo(child->getValueOfFirstChild<QString>(true))
+                    .getPathTo(relPath);
+    }
+    insertModifiedFile(relPath, FileUtils::readFile(absPath));  // can throw
   }
   foreach (const SExpression& node, root.getChildren("removed_file")) {
     QString relPath = node.getValueOfFirstChild<QString>(true);
-    mRemovedFiles.insert(relPath);
-  }
-  foreach (const SExpression& node, root.getChildren("removed_directory")) {
-    QString relPath = node.getValueOfFirstChild<QString>(true);
-    mRemovedDirs.insert(relPath);
+    setFileRemoved(relPath, true);
   }
 }
 
@@ -451,8 +605,265 @@ void TransactionalFileSystem::removeDiff(const QString& type) {
 
 void TransactionalFileSystem::discardChanges() noexcept {
   mModifiedFiles.clear();
+  mModifiedFilesGenerations.clear();
   mRemovedFiles.clear();
   mRemovedDirs.clear();
+  mIndex = IndexNode();
+  discardPreloadedSExpressions("");
+
+  QMutexLocker lock(&mZipMutex);
+  mZip.reset();  // closes the archive
+  mZipFilePath = FilePath();
+  mZipFiles.clear();
+  mZipCache.clear();
+}
+
+void TransactionalFileSystem::discardPreloadedSExpressions(
+    const QString& path) noexcept {
+  // path is either a file or a directory with trailing slash, or empty
+  QMutexLocker lock(&mPreloadedSExpressionsMutex);
+  for (auto it = mPreloadedSExpressions.begin();
+       it != mPreloadedSExpressions.end();) {
+    if (path.isEmpty() || (it.key() == path) ||
+        (path.endsWith('/') && it.key().startsWith(path))) {
+      it = mPreloadedSExpressions.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+const TransactionalFileSystem::IndexNode*
+    TransactionalFileSystem::findIndexNode(const QString& path) const
+    noexcept {
+  const IndexNode* node = &mIndex;
+  foreach (const QString& name, path.split('/', QString::SkipEmptyParts)) {
+    auto it = node->children.constFind(name);
+    if (it == node->children.constEnd()) {
+      return nullptr;
+    }
+    node = it->get();
+  }
+  return node;
+}
+
+QVector<TransactionalFileSystem::IndexNode*>
+    TransactionalFileSystem::createIndexNodes(const QString& path) noexcept {
+  QVector<IndexNode*> nodes = {&mIndex};
+  foreach (const QString& name, path.split('/', QString::SkipEmptyParts)) {
+    std::shared_ptr<IndexNode>& child = nodes.last()->children[name];
+    if (!child) {
+      child = std::make_shared<IndexNode>();
+    }
+    nodes.append(child.get());
+  }
+  return nodes;
+}
+
+void TransactionalFileSystem::insertModifiedFile(
+    const QString& path, const QByteArray& content) noexcept {
+  if (!mModifiedFiles.contains(path)) {
+    QVector<IndexNode*> nodes = createIndexNodes(path);
+    foreach (IndexNode* node, nodes) { ++node->modifiedFilesCount; }
+    nodes.last()->isModifiedFile = true;
+  }
+  mModifiedFiles.insert(path, content);
+  mModifiedFilesGenerations.insert(path, ++mGeneration);
+  forgetZipFile(path);  // content is no longer located in the ZIP archive
+}
+
+void TransactionalFileSystem::removeModifiedFile(const QString& path) noexcept {
+  mModifiedFilesGenerations.remove(path);
+  forgetZipFile(path);
+  if (mModifiedFiles.remove(path) > 0) {
+    QVector<IndexNode*> nodes = createIndexNodes(path);
+    foreach (IndexNode* node, nodes) { --node->modifiedFilesCount; }
+    nodes.last()->isModifiedFile = false;
+  }
+}
+
+void TransactionalFileSystem::setFileRemoved(const QString& path,
+                                             bool           removed) noexcept {
+  if (removed) {
+    mRemovedFiles.insert(path);
+    createIndexNodes(path).last()->isRemovedFile = true;
+  } else if (mRemovedFiles.remove(path)) {
+    createIndexNodes(path).last()->isRemovedFile = false;
+  }
+}
+
+void TransactionalFileSystem::insertRemovedDir(
+    const QString& dirpath) noexcept {
+  // dirpath is either empty or a directory with trailing slash
+  QVector<IndexNode*> nodes = createIndexNodes(dirpath);
+  IndexNode*          dir   = nodes.last();
+
+  // drop all modifications within the directory
+  int removedFilesCount =
+      dir->modifiedFilesCount - (dir->isModifiedFile ? 1 : 0);
+  foreach (IndexNode* node, nodes) {
+    node->modifiedFilesCount -= removedFilesCount;
+  }
+  removeIndexChildren(*dir, dirpath);
+
+  dir->isRemovedDir = true;
+  mRemovedDirs.insert(dirpath);
+}
+
+void TransactionalFileSystem::removeIndexChildren(
+    IndexNode& node, const QString& dirpath) noexcept {
+  for (auto it = node.children.constBegin(); it != node.children.constEnd();
+       ++it) {
+    QString path = dirpath % it.key();
+    if ((*it)->isModifiedFile) {
+      mModifiedFiles.remove(path);
+      mModifiedFilesGenerations.remove(path);
+      forgetZipFile(path);
+    }
+    if ((*it)->isRemovedFile) mRemovedFiles.remove(path);
+    if ((*it)->isRemovedDir) mRemovedDirs.remove(path % "/");
+    removeIndexChildren(**it, path % "/");
+  }
+  node.children.clear();
+}
+
+QByteArray TransactionalFileSystem::readModifiedFile(
+    const QString& path) const {
+  if (mZipFiles.contains(path)) {
+    return readFromZip(path);  // can throw
+  } else {
+    return mModifiedFiles.value(path);
+  }
+}
+
+QByteArray TransactionalFileSystem::readFromZip(const QString& path) const {
+  QString errorMsg = QString(tr("Failed to read file '%1' from '%2'."))
+                         .arg(path, mZipFilePath.toNative());
+
+  QByteArray       data;
+  QuaZipFileInfo64 info;
+  {
+    // QuaZip is not thread-safe, so the archive is accessed exclusively. To
+    // not block other threads during decompression, only the raw data is
+    // read while the mutex is locked.
+    QMutexLocker lock(&mZipMutex);
+    auto         it = mZipCache.constFind(path);
+    if (it != mZipCache.constEnd()) {
+      return *it;
+    }
+    if ((!mZip) ||
+        (!mZip->setCurrentFile(mZipFiles.value(path), QuaZip::csSensitive))) {
+      throw RuntimeError(__FILE__, __LINE__,
+                         QString(tr("File '%1' not found in '%2'."))
+                             .arg(path, mZipFilePath.toNative()));
+    }
+    QuaZipFile file(mZip.get());
+    if ((!mZip->getCurrentFileInfo(&info)) ||
+        (!file.open(QIODevice::ReadOnly, nullptr, nullptr, true))) {
+      throw RuntimeError(__FILE__, __LINE__, errorMsg);
+    }
+    data = file.readAll();
+    file.close();
+    if (file.getZipError() != UNZ_OK) {
+      throw RuntimeError(__FILE__, __LINE__, errorMsg);
+    }
+  }
+
+  QByteArray content;
+  if (info.method == Z_DEFLATED) {
+    content = inflateRaw(data, info.uncompressedSize);  // can throw
+  } else if (info.method == 0) {
+    content = data;  // stored without compression
+  } else {
+    throw RuntimeError(__FILE__, __LINE__, errorMsg);
+  }
+  const Bytef* bytes = reinterpret_cast<const Bytef*>(content.constData());
+  if ((quint64(content.size()) != info.uncompressedSize) ||
+      (crc32(0, bytes, content.size()) != info.crc)) {
+    throw RuntimeError(__FILE__, __LINE__, errorMsg);
+  }
+
+  // Keep the content to decompress every file only once. The archive is
+  // usually small compared to the memory needed for the loaded project.
+  QMutexLocker lock(&mZipMutex);
+  mZipCache.insert(path, content);
+  return content;
+}
+
+void TransactionalFileSystem::forgetZipFile(const QString& path) noexcept {
+  // Also drop the content read by releaseZip(), otherwise it would hide the
+  // same file of another archive loaded later.
+  mZipFiles.remove(path);
+  QMutexLocker lock(&mZipMutex);
+  mZipCache.remove(path);
+}
+
+void TransactionalFileSystem::releaseZip() const {
+  if (!mZip) {
+    return;
+  }
+  // Read all files which are still located in the archive into memory, then
+  // close the archive (e.g. to allow overwriting it).
+  for (auto it = mZipFiles.constBegin(); it != mZipFiles.constEnd(); ++it) {
+    readFromZip(it.key());  // can throw
+  }
+  QMutexLocker lock(&mZipMutex);
+  mZip.reset();
+}
+
+QByteArray TransactionalFileSystem::deflateRaw(const QByteArray& content,
+                                               quint32&          crc) {
+  // zlib does not modify the input, it's just not declared as const
+  Bytef* input = reinterpret_cast<Bytef*>(const_cast<char*>(content.data()));
+  crc          = crc32(0, input, content.size());
+
+  // Same parameters as QuaZip uses, but without zlib header (raw deflate)
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8,
+                   Z_DEFAULT_STRATEGY) != Z_OK) {
+    throw RuntimeError(__FILE__, __LINE__,
+                       tr("Failed to initialize the ZIP compression."));
+  }
+  QByteArray output(deflateBound(&stream, content.size()), Qt::Uninitialized);
+  stream.next_in   = input;
+  stream.avail_in  = content.size();
+  stream.next_out  = reinterpret_cast<Bytef*>(output.data());
+  stream.avail_out = output.size();
+  int result       = deflate(&stream, Z_FINISH);
+  output.resize(stream.total_out);
+  deflateEnd(&stream);
+  if (result != Z_STREAM_END) {
+    throw RuntimeError(__FILE__, __LINE__,
+                       tr("Failed to compress data for the ZIP file."));
+  }
+  return output;
+}
+
+QByteArray TransactionalFileSystem::inflateRaw(const QByteArray& data,
+                                               qint64            size) {
+  QByteArray output(static_cast<int>(size), Qt::Uninitialized);
+  if (size == 0) {
+    return output;
+  }
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+    throw RuntimeError(__FILE__, __LINE__,
+                       tr("Failed to initialize the ZIP decompression."));
+  }
+  // zlib does not modify the input, it's just not declared as const
+  stream.next_in   = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+  stream.avail_in  = data.size();
+  stream.next_out  = reinterpret_cast<Bytef*>(output.data());
+  stream.avail_out = output.size();
+  int result       = inflate(&stream, Z_FINISH);
+  inflateEnd(&stream);
+  if ((result != Z_STREAM_END) || (stream.total_out != quint64(size))) {
+    throw RuntimeError(__FILE__, __LINE__,
+                       tr("Failed to decompress data of the ZIP file."));
+  }
+  return output;
 }
 
 /*******************************************************************************
@@ -25,6 +25,7 @@
  ******************************************************************************/
 #include "directorylock.h"
 #include "filesystem.h"
+#include "sexpression.h"
 
 #include <QtCore>
 
@@ -34,7 +35,7 @@
  *  Namespace / Forward Declarations
  ******************************************************************************/
 
-class QuaZipFile;
+class QuaZip;
 
 namespace librepcb {
 
@@ -95,11 +96,86 @@ public:
   virtual void removeDirRecursively(const QString& path = "") override;
 
   // General Methods
+
+  /**
+   * @brief Load all files of a ZIP archive as modified files
+   *
+   * Only the central directory of the archive is read, the files are
+   * decompressed on first access. Thus the archive is kept open until all
+   * changes are discarded (e.g. by #save()).
+   *
+   * @param fp        The ZIP file to load.
+   *
+   * @throw Exception If the ZIP file could not be opened.
+   */
   void loadFromZip(const FilePath& fp);
+
+  /**
+   * @brief Export the whole file system to a ZIP archive
+   *
+   * The files are read and compressed in parallel, only writing them into
+   * the archive is done sequentially.
+   *
+   * @param fp        The ZIP file to create (overwritten if it exists, even if
+   *                  it's the archive loaded with #loadFromZip()).
+   *
+   * @throw Exception If the ZIP file could not be written.
+   */
   void exportToZip(const FilePath& fp) const;
+
+  /**
+   * @brief Write all unsaved modifications to the autosave directory
+   *
+   * The autosave is incremental: Only files modified since the previous
+   * autosave are written into a new directory, all other files are referenced
+   * in the directories of previous autosaves. Directories which are not
+   * referenced anymore are removed after the new autosave is complete.
+   *
+   * @throw Exception If the autosave could not be written.
+   */
   void autosave();
   void save();
 
+  /**
+   * @brief Read and parse S-Expression files in parallel
+   *
+   * The parsed files are kept in memory until they are fetched with
+   * #readSExpression(), thus the files of a project or library can be parsed
+   * ahead while the objects are still created sequentially.
+   *
+   * @note  Files which can't be read or parsed are silently skipped, the
+   *        error is then raised by #readSExpression() instead.
+   *
+   * @param paths     Paths of the files to parse.
+   */
+  void preloadSExpressions(const QStringList& paths) noexcept;
+
+  /**
+   * @brief Release preloaded documents which were not fetched
+   *
+   * Should be called after loading is finished, otherwise documents
+   * preloaded with #preloadSExpressions() but never read with
+   * #readSExpression() would stay in memory.
+   *
+   * @param path      Path of a file, or of a directory with trailing slash.
+   *                  If empty, all preloaded documents are released.
+   */
+  void discardPreloadedSExpressions(const QString& path = QString()) noexcept;
+
+  /**
+   * @brief Read and parse an S-Expression file
+   *
+   * If the file was preloaded with #preloadSExpressions(), the preloaded
+   * document is returned (and released) instead of parsing the file again.
+   *
+   * @param path      Path of the file to parse.
+   *
+   * @return The parsed document.
+   *
+   * @throw Exception If the file could not be read or parsed.
+   */
+  SExpression readSExpression(const QString& path) const;
+
   // Static Methods
   static std::shared_ptr<TransactionalFileSystem> open(
       const FilePath& filepath, bool writable,
@@ -119,15 +195,52 @@ public:
   }
   static QString cleanPath(QString path) noexcept;
 
+private:  // Types
+  /**
+   * @brief A node of the prefix tree #mIndex
+   *
+   * Every node represents a file or directory path which is either modified
+   * or removed, or a parent directory of such a path.
+   */
+  struct IndexNode {
+    QHash<QString, std::shared_ptr<IndexNode>> children;
+
+    bool isModifiedFile     = false;  ///< Contained in #mModifiedFiles
+    bool isRemovedFile      = false;  ///< Contained in #mRemovedFiles
+    bool isRemovedDir       = false;  ///< Contained in #mRemovedDirs
+    int  modifiedFilesCount = 0;      ///< Modified files within this subtree
+  };
+
 private:  // Methods
   bool isRemoved(const QString& path) const noexcept;
-  void exportDirToZip(QuaZipFile& file, const FilePath& zipFp,
-                      const QString& dir) const;
-  void saveDiff(const QString& type) const;
+  void collectFilesForZip(QStringList& files, const FilePath& zipFp,
+                         const QString& dir) const;
+  void saveDiff(const QString&           type,
+                QHash<QString, QString>* filesDirs = nullptr) const;
   void loadDiff(const FilePath& fp);
   void removeDiff(const QString& type);
   void discardChanges() noexcept;
 
+  // Modification Methods (keep #mIndex in sync with the containers)
+  const IndexNode*    findIndexNode(const QString& path) const noexcept;
+  QVector<IndexNode*> createIndexNodes(const QString& path) noexcept;
+  void                insertModifiedFile(const QString&    path,
+                                         const QByteArray& content) noexcept;
+  void                removeModifiedFile(const QString& path) noexcept;
+  void                setFileRemoved(const QString& path,
+                                     bool           removed) noexcept;
+  void                insertRemovedDir(const QString& dirpath) noexcept;
+  void                removeIndexChildren(IndexNode&     node,
+                                          const QString& dirpath) noexcept;
+
+  // ZIP Methods
+  QByteArray        readModifiedFile(const QString& path) const;
+  QByteArray        readFromZip(const QString& path) const;
+  void              forgetZipFile(const QString& path) noexcept;
+  void              releaseZip() const;
+  static QByteArray deflateRaw(const QByteArray& content, quint32& crc);
+  static QByteArray inflateRaw(const QByteArray& data, qint64 size);
+
 private:  // Data
   FilePath      mFilePath;
   bool          mIsWritable;
@@ -136,8 +249,26 @@ private:  // Data
 
   // File system modifications
   QHash<QString, QByteArray> mModifiedFiles;
+  QHash<QString, quint64>    mModifiedFilesGenerations;
   QSet<QString>              mRemovedFiles;
-  QSet<QString>              mRemovedDirs;
+  QSet<QString>              mRemovedDirs;  ///< With trailing slash
+  IndexNode                  mIndex;        ///< Prefix tree of the paths
+  quint64                    mGeneration;   ///< Incremented on every write
+
+  // Autosave state (see autosave())
+  quint64                 mAutosaveGeneration;  ///< #mGeneration at autosave
+  QHash<QString, QString> mAutosavedFiles;      ///< Directory of each file
+
+  // ZIP archive loaded by loadFromZip(), files are decompressed on demand
+  mutable QMutex                     mZipMutex;
+  mutable std::unique_ptr<QuaZip>    mZip;
+  FilePath                           mZipFilePath;
+  QHash<QString, QString>            mZipFiles;  ///< Path -> name in archive
+  mutable QHash<QString, QByteArray> mZipCache;  ///< Decompressed files
+
+  // Documents parsed by preloadSExpressions(), not fetched yet
+  mutable QMutex                      mPreloadedSExpressionsMutex;
+  mutable QHash<QString, SExpression> mPreloadedSExpressions;
 };
 
 /*******************************************************************************
@@ -60,11 +60,18 @@ SQLiteDatabase::TransactionScopeGuard::~TransactionScopeGuard() noexcept {
  ******************************************************************************/
 
 SQLiteDatabase::SQLiteDatabase(const FilePath& filepath)
+  : SQLiteDatabase(filepath, false) {
+}
+
+SQLiteDatabase::SQLiteDatabase(const FilePath& filepath, bool readOnly)
   : QObject(nullptr)  //, mNestedTransactionCount(0)
 {
   // create database (use random UUID as connection name)
   mDb = QSqlDatabase::addDatabase("QSQLITE", Uuid::createRandom().toStr());
   mDb.setDatabaseName(filepath.toStr());
+  if (readOnly) {
+    mDb.setConnectOptions("QSQLITE_OPEN_READONLY");
+  }
 
   // check if database is valid
   if (!mDb.isValid()) {
@@ -82,7 +89,9 @@ SQLiteDatabase::SQLiteDatabase(const FilePath& filepath)
 
   // set SQLite options
   exec("PRAGMA foreign_keys = ON");  // can throw
-  enableSqliteWriteAheadLogging();   // can throw
+  if (!readOnly) {
+    enableSqliteWriteAheadLogging();  // can throw
+  }
 
   // check if all required features are available
   Q_ASSERT(mDb.driver() && mDb.driver()->hasFeature(QSqlDriver::Transactions));
@@ -93,7 +102,40 @@ SQLiteDatabase::SQLiteDatabase(const FilePath& filepath)
 }
 
 SQLiteDatabase::~SQLiteDatabase() noexcept {
+  // remove the connection, otherwise every instance would leak one
+  QString connectionName = mDb.connectionName();
+  mStatementCache.clear();  // release all statements before closing
   mDb.close();
+  mDb = QSqlDatabase();
+  QSqlDatabase::removeDatabase(connectionName);
+}
+
+/*******************************************************************************
+ *  Getters
+ ******************************************************************************/
+
+QString SQLiteDatabase::getPragma(const QString& name) {
+  if (!QRegularExpression("\\A[a-z_]+\\z").match(name).hasMatch()) {
+    throw LogicError(__FILE__, __LINE__,
+                     QString("Invalid SQLite pragma: %1").arg(name));
+  }
+  QSqlQuery query = prepareQuery("PRAGMA " % name);  // can throw
+  exec(query);                                       // can throw
+  return query.first() ? query.value(0).toString() : QString();
+}
+
+/*******************************************************************************
+ *  Setters
+ ******************************************************************************/
+
+void SQLiteDatabase::setPragma(const QString& name, const QString& value) {
+  if ((!QRegularExpression("\\A[a-z_]+\\z").match(name).hasMatch()) ||
+      (!QRegularExpression("\\A-?[A-Za-z0-9_]+\\z").match(value).hasMatch())) {
+    throw LogicError(__FILE__, __LINE__,
+                     QString("Invalid SQLite pragma: %1=%2").arg(name, value));
+  }
+  QSqlQuery query = prepareQuery("PRAGMA " % name % " = " % value);
+  exec(query);  // can throw
 }
 
 /*******************************************************************************
@@ -160,6 +202,16 @@ QSqlQuery SQLiteDatabase::prepareQuery(const QString& query) const {
   return q;
 }
 
+QSqlQuery SQLiteDatabase::prepareCachedQuery(const QString& query) const {
+  auto it = mStatementCache.find(query);
+  if (it == mStatementCache.end()) {
+    it = mStatementCache.insert(query, prepareQuery(query));  // can throw
+  } else {
+    it->finish();  // reset the statement to release locks of the last run
+  }
+  return *it;
+}
+
 int SQLiteDatabase::count(QSqlQuery& query) {
   exec(query);  // can throw
 
@@ -204,6 +256,45 @@ void SQLiteDatabase::exec(const QString& query) {
   exec(q);
 }
 
+void SQLiteDatabase::insertBatch(const QString&               table,
+                                 const QStringList&           columns,
+                                 const QVector<QVariantList>& rows) {
+  if (rows.isEmpty()) {
+    return;
+  }
+
+  // QSqlQuery::execBatch() expects the values column by column
+  QVector<QVariantList> values(columns.count());
+  foreach (const QVariantList& row, rows) {
+    if (row.count() != columns.count()) {
+      throw LogicError(__FILE__, __LINE__,
+                       QString("Wrong number of values for table %1.")
+                           .arg(table));
+    }
+    for (int i = 0; i < row.count(); ++i) {
+      values[i].append(row.at(i));
+    }
+  }
+
+  QStringList placeholders;
+  for (int i = 0; i < columns.count(); ++i) {
+    placeholders.append("?");
+  }
+  QSqlQuery query = prepareCachedQuery(
+      "INSERT INTO " % table % " (" % columns.join(", ") % ") VALUES (" %
+      placeholders.join(", ") % ")");  // can throw
+  for (int i = 0; i < values.count(); ++i) {
+    query.bindValue(i, values.at(i));
+  }
+  if (!query.execBatch()) {
+    qDebug() << query.lastError().databaseText();
+    qDebug() << query.lastError().driverText();
+    throw RuntimeError(__FILE__, __LINE__,
+                       QString(tr("Error while executing SQL query: %1"))
+                           .arg(query.lastQuery()));
+  }
+}
+
 /*******************************************************************************
  *  Private Methods
  ******************************************************************************/
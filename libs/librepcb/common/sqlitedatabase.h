@@ -64,8 +64,38 @@ public:
   SQLiteDatabase()                            = delete;
   SQLiteDatabase(const SQLiteDatabase& other) = delete;
   SQLiteDatabase(const FilePath& filepath);
+
+  /**
+   * @brief Open a database connection, optionally read-only
+   *
+   * @note  For read-only connections, the database must already exist and be
+   *        in WAL mode since a read-only connection can't change the journal
+   *        mode.
+   *
+   * @param filepath  Path to the database file.
+   * @param readOnly  If true, the connection is opened read-only.
+   */
+  SQLiteDatabase(const FilePath& filepath, bool readOnly);
   ~SQLiteDatabase() noexcept;
 
+  // Getters
+  QString getPragma(const QString& name);
+
+  // Setters
+
+  /**
+   * @brief Set an SQLite pragma of this connection
+   *
+   * Useful pragmas to tune bulk writes are "synchronous", "cache_size",
+   * "mmap_size" and "temp_store".
+   *
+   * @param name    Name of the pragma, e.g. "cache_size".
+   * @param value   The new value, e.g. "-16384".
+   *
+   * @see https://sqlite.org/pragma.html
+   */
+  void setPragma(const QString& name, const QString& value);
+
   // SQL Commands
   void beginTransaction();
   void commitTransaction();
@@ -74,10 +104,36 @@ public:
 
   // General Methods
   QSqlQuery prepareQuery(const QString& query) const;
-  int       count(QSqlQuery& query);
-  int       insert(QSqlQuery& query);
-  void      exec(QSqlQuery& query);
-  void      exec(const QString& query);
+
+  /**
+   * @brief Get a prepared query from the statement cache of this connection
+   *
+   * The first call prepares the query, subsequent calls with the same SQL
+   * text reuse the prepared statement. The returned object shares the
+   * statement with the cache, so it must not be used anymore after the same
+   * SQL text has been requested again.
+   *
+   * @param query   The SQL text.
+   *
+   * @return The prepared query, with the previous result set released.
+   */
+  QSqlQuery prepareCachedQuery(const QString& query) const;
+
+  int  count(QSqlQuery& query);
+  int  insert(QSqlQuery& query);
+  void exec(QSqlQuery& query);
+  void exec(const QString& query);
+
+  /**
+   * @brief Insert multiple rows into a table with a single prepared statement
+   *
+   * @param table     Name of the table.
+   * @param columns   Names of the columns to insert.
+   * @param rows      Values of all rows, each containing the values in the
+   *                  same order as `columns`.
+   */
+  void insertBatch(const QString& table, const QStringList& columns,
+                   const QVector<QVariantList>& rows);
 
   // Operator Overloadings
   SQLiteDatabase& operator=(const SQLiteDatabase& rhs) = delete;
@@ -104,7 +160,8 @@ private:  // Methods
   QHash<QString, QString> getSqliteCompileOptions();
 
 private:  // Data
-  QSqlDatabase mDb;
+  QSqlDatabase                      mDb;
+  mutable QHash<QString, QSqlQuery> mStatementCache;  ///< Key: SQL text
   // int mNestedTransactionCount;
 };
 
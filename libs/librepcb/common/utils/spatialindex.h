@@ -0,0 +1,257 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBREPCB_SPATIALINDEX_H
+#define LIBREPCB_SPATIALINDEX_H
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+#include "../units/all_length_units.h"
+
+#include <QtCore>
+
+#include <algorithm>
+
+/*******************************************************************************
+ *  Namespace / Forward Declarations
+ ******************************************************************************/
+namespace librepcb {
+
+/*******************************************************************************
+ *  Class SpatialIndex
+ ******************************************************************************/
+
+/**
+ * @brief A uniform grid index to find items by their bounding rectangle
+ *
+ * Every item is registered in all grid cells touched by its bounding
+ * rectangle, so a query only needs to look at the items in the cells touched
+ * by the query rectangle instead of at all items. Items which would cover a
+ * lot of cells (e.g. huge polygons) are kept in a separate list which is
+ * checked on every query.
+ *
+ * The items returned by #query() are always sorted by the order in which they
+ * were inserted, thus the result is deterministic and independent of the cell
+ * layout. Moving an item with #insert() keeps its original order.
+ *
+ * @tparam T  The item type. It must be usable as a key of QHash, typically
+ *            it's a pointer to an object.
+ */
+template <typename T>
+class SpatialIndex final {
+public:
+  // Constructors / Destructor
+  SpatialIndex()                          = delete;
+  SpatialIndex(const SpatialIndex& other) = default;
+  explicit SpatialIndex(const PositiveLength& cellSize) noexcept
+    : mCellSize(cellSize->toNm()), mNextSerial(0) {}
+  ~SpatialIndex() noexcept {}
+
+  // Getters
+  int  count() const noexcept { return mEntries.count(); }
+  bool isEmpty() const noexcept { return mEntries.isEmpty(); }
+  bool contains(const T& item) const noexcept {
+    return mEntries.contains(item);
+  }
+
+  // General Methods
+
+  /**
+   * @brief Add an item or update the bounding rectangle of an existing item
+   *
+   * @param item    The item to add or update.
+   * @param p1      One corner of the bounding rectangle of the item.
+   * @param p2      The opposite corner of the bounding rectangle.
+   */
+  void insert(const T& item, const Point& p1, const Point& p2) noexcept {
+    quint64 serial = mNextSerial;
+    auto    it     = mEntries.find(item);
+    if (it != mEntries.end()) {
+      serial = it->serial;  // keep the order of existing items
+      remove(item);
+    } else {
+      ++mNextSerial;
+    }
+    Entry entry = {qMin(p1.getX(), p2.getX()).toNm(),
+                   qMin(p1.getY(), p2.getY()).toNm(),
+                   qMax(p1.getX(), p2.getX()).toNm(),
+                   qMax(p1.getY(), p2.getY()).toNm(),
+                   serial,
+                   false};
+    qint64 x1 = cellIndex(entry.minX), x2 = cellIndex(entry.maxX);
+    qint64 y1 = cellIndex(entry.minY), y2 = cellIndex(entry.maxY);
+    entry.large = cellCount(x1, y1, x2, y2) > sMaxCellsPerItem;
+    if (entry.large) {
+      mLargeItems.insert(item);
+    } else {
+      for (qint64 x = x1; x <= x2; ++x) {
+        for (qint64 y = y1; y <= y2; ++y) {
+          mCells[Cell(x, y)].append(item);
+        }
+      }
+    }
+    mEntries.insert(item, entry);
+  }
+
+  /**
+   * @brief Remove an item (does nothing if it is not contained)
+   *
+   * @param item    The item to remove.
+   */
+  void remove(const T& item) noexcept {
+    auto it = mEntries.find(item);
+    if (it == mEntries.end()) return;
+    if (it->large) {
+      mLargeItems.remove(item);
+    } else {
+      qint64 x1 = cellIndex(it->minX), x2 = cellIndex(it->maxX);
+      qint64 y1 = cellIndex(it->minY), y2 = cellIndex(it->maxY);
+      for (qint64 x = x1; x <= x2; ++x) {
+        for (qint64 y = y1; y <= y2; ++y) {
+          auto cell = mCells.find(Cell(x, y));
+          if (cell == mCells.end()) continue;
+          cell->removeOne(item);
+          if (cell->isEmpty()) mCells.erase(cell);
+        }
+      }
+    }
+    mEntries.erase(it);
+  }
+
+  /**
+   * @brief Remove all items
+   */
+  void clear() noexcept {
+    mEntries.clear();
+    mCells.clear();
+    mLargeItems.clear();
+  }
+
+  /**
+   * @brief Get all items whose bounding rectangle intersects a rectangle
+   *
+   * @param p1      One corner of the rectangle to look at.
+   * @param p2      The opposite corner of the rectangle.
+   *
+   * @return All items touching the rectangle, in the order of insertion.
+   */
+  QList<T> query(const Point& p1, const Point& p2) const noexcept {
+    LengthBase_t minX = qMin(p1.getX(), p2.getX()).toNm();
+    LengthBase_t minY = qMin(p1.getY(), p2.getY()).toNm();
+    LengthBase_t maxX = qMax(p1.getX(), p2.getX()).toNm();
+    LengthBase_t maxY = qMax(p1.getY(), p2.getY()).toNm();
+
+    QVector<QPair<quint64, T>> result;
+    QSet<T>                    visited;
+    auto                       check = [&](const T& item) {
+      if (visited.contains(item)) return;
+      visited.insert(item);
+      const Entry e = mEntries.value(item);
+      if ((e.minX <= maxX) && (minX <= e.maxX) && (e.minY <= maxY) &&
+          (minY <= e.maxY)) {
+        result.append(qMakePair(e.serial, item));
+      }
+    };
+
+    qint64 x1 = cellIndex(minX), x2 = cellIndex(maxX);
+    qint64 y1 = cellIndex(minY), y2 = cellIndex(maxY);
+    if (cellCount(x1, y1, x2, y2) > mCells.count()) {
+      // the query rect is larger than the occupied area, so it's cheaper to
+      // iterate over all occupied cells
+      for (auto it = mCells.constBegin(); it != mCells.constEnd(); ++it) {
+        if ((it.key().first >= x1) && (it.key().first <= x2) &&
+            (it.key().second >= y1) && (it.key().second <= y2)) {
+          foreach (const T& item, it.value()) { check(item); }
+        }
+      }
+    } else {
+      for (qint64 x = x1; x <= x2; ++x) {
+        for (qint64 y = y1; y <= y2; ++y) {
+          auto cell = mCells.constFind(Cell(x, y));
+          if (cell == mCells.constEnd()) continue;
+          foreach (const T& item, cell.value()) { check(item); }
+        }
+      }
+    }
+    foreach (const T& item, mLargeItems) { check(item); }
+
+    std::sort(result.begin(), result.end(),
+              [](const QPair<quint64, T>& a, const QPair<quint64, T>& b) {
+                return a.first < b.first;
+              });
+    QList<T> items;
+    items.reserve(result.count());
+    for (const QPair<quint64, T>& pair : result) { items.append(pair.second); }
+    return items;
+  }
+
+  /**
+   * @brief Get all items whose bounding rectangle contains a point
+   *
+   * @param pos     The position to look at.
+   *
+   * @return All items at the given position, in the order of insertion.
+   */
+  QList<T> query(const Point& pos) const noexcept { return query(pos, pos); }
+
+  // Operator Overloadings
+  SpatialIndex& operator=(const SpatialIndex& rhs) = default;
+
+private:  // Types
+  typedef QPair<qint64, qint64> Cell;
+  struct Entry {
+    LengthBase_t minX;
+    LengthBase_t minY;
+    LengthBase_t maxX;
+    LengthBase_t maxY;
+    quint64      serial;
+    bool         large;  ///< Whether the item is stored in #mLargeItems
+  };
+
+private:  // Methods
+  qint64 cellIndex(LengthBase_t value) const noexcept {
+    // round towards negative infinity
+    return (value >= 0) ? (value / mCellSize)
+                        : (-((-value - 1) / mCellSize) - 1);
+  }
+
+  static qreal cellCount(qint64 x1, qint64 y1, qint64 x2,
+                         qint64 y2) noexcept {
+    // floating point to avoid overflows with huge rectangles
+    return (qreal(x2) - qreal(x1) + 1) * (qreal(y2) - qreal(y1) + 1);
+  }
+
+private:  // Data
+  static const qint64 sMaxCellsPerItem = 64;
+
+  LengthBase_t          mCellSize;
+  quint64               mNextSerial;
+  QHash<T, Entry>       mEntries;
+  QHash<Cell, QList<T>> mCells;
+  QSet<T>               mLargeItems;
+};
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace librepcb
+
+#endif  // LIBREPCB_SPATIALINDEX_H
@@ -49,6 +49,7 @@ SOURCES += \
     library.cpp \
     librarybaseelement.cpp \
     librarybaseelementcheck.cpp \
+    librarybaseelementheader.cpp \
     libraryelement.cpp \
     libraryelementcheck.cpp \
     msg/libraryelementcheckmessage.cpp \
@@ -121,6 +122,7 @@ HEADERS += \
     library.h \
     librarybaseelement.h \
     librarybaseelementcheck.h \
+    librarybaseelementheader.h \
     libraryelement.h \
     libraryelementcheck.h \
     msg/libraryelementcheckmessage.h \
@@ -76,43 +76,10 @@ LibraryBaseElement::LibraryBaseElement(
         "unknown")),  // just for initialization, will be overwritten
     mDescriptions(""),
     mKeywords("") {
-  // determine the filename of the version file
-  QString versionFileName = ".librepcb-" % mShortElementName;
-
-  // check if the directory is a library element
-  if (!mDirectory->fileExists(versionFileName)) {
-    throw RuntimeError(
-        __FILE__, __LINE__,
-        QString(tr("Directory is not a library element of type %1: \"%2\""))
-            .arg(mLongElementName, mDirectory->getAbsPath().toNative()));
-  }
-
-  // check directory name
-  QString dirUuidStr = mDirectory->getAbsPath().getFilename();
-  if (mDirectoryNameMustBeUuid && (!Uuid::isValid(dirUuidStr))) {
-    throw RuntimeError(__FILE__, __LINE__,
-                       QString(tr("Directory name is not a valid UUID: \"%1\""))
-                           .arg(mDirectory->getAbsPath().toNative()));
-  }
-
-  // read version number from version file
-  VersionFile versionFile =
-      VersionFile::fromByteArray(mDirectory->read(versionFileName));
-  if (versionFile.getVersion() > qApp->getAppVersion()) {
-    throw RuntimeError(
-        __FILE__, __LINE__,
-        QString(
-            tr("The library element %1 was created with a newer application "
-               "version. You need at least LibrePCB version %2 to open it."))
-            .arg(mDirectory->getAbsPath().toNative())
-            .arg(versionFile.getVersion().toPrettyStr(3)));
-  }
-
-  // open main file
-  QString  sexprFileName = mLongElementName % ".lp";
-  FilePath sexprFilePath = mDirectory->getAbsPath(sexprFileName);
+  // check the directory and open main file
   mLoadingFileDocument =
-      SExpression::parse(mDirectory->read(sexprFileName), sexprFilePath);
+      loadMainFile(*mDirectory, mDirectoryNameMustBeUuid, mShortElementName,
+                   mLongElementName);  // can throw
 
   // read attributes
   mUuid         = mLoadingFileDocument.getChildByIndex(0).getValue<Uuid>();
@@ -125,16 +92,6 @@ LibraryBaseElement::LibraryBaseElement(
   mNames        = LocalizedNameMap(mLoadingFileDocument);
   mDescriptions = LocalizedDescriptionMap(mLoadingFileDocument);
   mKeywords     = LocalizedKeywordsMap(mLoadingFileDocument);
-
-  // check if the UUID equals to the directory basename
-  if (mDirectoryNameMustBeUuid && (mUuid.toStr() != dirUuidStr)) {
-    qDebug() << mUuid.toStr() << "!=" << dirUuidStr;
-    throw RuntimeError(
-        __FILE__, __LINE__,
-        QString(
-            tr("UUID mismatch between element directory and main file: \"%1\""))
-            .arg(sexprFilePath.toNative()));
-  }
 }
 
 LibraryBaseElement::~LibraryBaseElement() noexcept {
@@ -213,6 +170,70 @@ void LibraryBaseElement::serialize(SExpression& root) const {
   root.appendChild("deprecated", mIsDeprecated, true);
 }
 
+/*******************************************************************************
+ *  Static Methods
+ ******************************************************************************/
+
+SExpression LibraryBaseElement::loadMainFile(
+    const TransactionalDirectory& directory, bool dirnameMustBeUuid,
+    const QString& shortElementName, const QString& longElementName,
+    const QSet<QByteArray>* rootChildren) {
+  // determine the filename of the version file
+  QString versionFileName = ".librepcb-" % shortElementName;
+
+  // check if the directory is a library element
+  if (!directory.fileExists(versionFileName)) {
+    throw RuntimeError(
+        __FILE__, __LINE__,
+        QString(tr("Directory is not a library element of type %1: \"%2\""))
+            .arg(longElementName, directory.getAbsPath().toNative()));
+  }
+
+  // check directory name
+  QString dirUuidStr = directory.getAbsPath().getFilename();
+  if (dirnameMustBeUuid && (!Uuid::isValid(dirUuidStr))) {
+    throw RuntimeError(__FILE__, __LINE__,
+                       QString(tr("Directory name is not a valid UUID: \"%1\""))
+                           .arg(directory.getAbsPath().toNative()));
+  }
+
+  // read version number from version file
+  VersionFile versionFile =
+      VersionFile::fromByteArray(directory.read(versionFileName));
+  if (versionFile.getVersion() > qApp->getAppVersion()) {
+    throw RuntimeError(
+        __FILE__, __LINE__,
+        QString(
+            tr("The library element %1 was created with a newer application "
+               "version. You need at least LibrePCB version %2 to open it."))
+            .arg(directory.getAbsPath().toNative())
+            .arg(versionFile.getVersion().toPrettyStr(3)));
+  }
+
+  // open main file
+  QString     sexprFileName = longElementName % ".lp";
+  FilePath    sexprFilePath = directory.getAbsPath(sexprFileName);
+  SExpression root;
+  if (rootChildren) {
+    root = SExpression::parse(directory.read(sexprFileName), sexprFilePath,
+                              *rootChildren);
+  } else {
+    root = directory.readSExpression(sexprFileName);  // maybe preloaded
+  }
+
+  // check if the UUID equals to the directory basename
+  Uuid uuid = root.getChildByIndex(0).getValue<Uuid>();
+  if (dirnameMustBeUuid && (uuid.toStr() != dirUuidStr)) {
+    qDebug() << uuid.toStr() << "!=" << dirUuidStr;
+    throw RuntimeError(
+        __FILE__, __LINE__,
+        QString(
+            tr("UUID mismatch between element directory and main file: \"%1\""))
+            .arg(sexprFilePath.toNative()));
+  }
+  return root;
+}
+
 /*******************************************************************************
  *  End of File
  ******************************************************************************/
@@ -116,6 +116,28 @@ public:
   LibraryBaseElement& operator=(const LibraryBaseElement& rhs) = delete;
 
   // Static Methods
+
+  /**
+   * @brief Check a library element directory and parse its main file
+   *
+   * @param directory           The directory of the library element.
+   * @param dirnameMustBeUuid   Whether the directory name must be the UUID.
+   * @param shortElementName    Short name of the element type, e.g. "sym".
+   * @param longElementName     Long name of the element type, e.g. "symbol".
+   * @param rootChildren        If not nullptr, only these children of the
+   *                            root node are parsed (see
+   *                            librepcb::SExpression::parse()).
+   *
+   * @return The root node of the main file
+   *
+   * @throw Exception if the directory is not a valid element of this type or
+   *        if the main file could not be parsed.
+   */
+  static SExpression loadMainFile(
+      const TransactionalDirectory& directory, bool dirnameMustBeUuid,
+      const QString& shortElementName, const QString& longElementName,
+      const QSet<QByteArray>* rootChildren = nullptr);
+
   template <typename ElementType>
   static bool isValidElementDirectory(const FilePath& dir) noexcept {
     return dir.getPathTo(".librepcb-" % ElementType::getShortElementName())
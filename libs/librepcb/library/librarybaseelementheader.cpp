@@ -0,0 +1,111 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+#include "librarybaseelementheader.h"
+
+#include "librarybaseelement.h"
+
+#include <librepcb/common/fileio/sexpression.h>
+
+#include <QtCore>
+
+/*******************************************************************************
+ *  Namespace
+ ******************************************************************************/
+namespace librepcb {
+namespace library {
+
+/*******************************************************************************
+ *  Constructors / Destructor
+ ******************************************************************************/
+
+LibraryBaseElementHeader::LibraryBaseElementHeader(
+    const TransactionalDirectory& directory, bool dirnameMustBeUuid,
+    const QString& shortElementName, const QString& longElementName)
+  : LibraryBaseElementHeader(LibraryBaseElement::loadMainFile(
+        directory, dirnameMustBeUuid, shortElementName, longElementName,
+        &sRootChildren)) {  // can throw
+}
+
+LibraryBaseElementHeader::LibraryBaseElementHeader(const SExpression& root)
+  : mUuid(root.getChildByIndex(0).getValue<Uuid>()),
+    mVersion(root.getValueByPath<Version>("version")),
+    mAuthor(root.getValueByPath<QString>("author")),
+    mCreated(root.getValueByPath<QDateTime>("created")),
+    mIsDeprecated(root.getValueByPath<bool>("deprecated")),
+    mNames(root),
+    mDescriptions(root),
+    mKeywords(root),
+    mCategories(),
+    mParentUuid(),
+    mComponentUuid(),
+    mPackageUuid() {
+  foreach (const SExpression& node, root.getChildren("category")) {
+    mCategories.insert(node.getValueOfFirstChild<Uuid>());
+  }
+  if (const SExpression* node = root.tryGetChildByPath("parent")) {
+    mParentUuid = node->getValueOfFirstChild<tl::optional<Uuid>>();
+  }
+  if (const SExpression* node = root.tryGetChildByPath("component")) {
+    mComponentUuid = node->getValueOfFirstChild<Uuid>();
+  }
+  if (const SExpression* node = root.tryGetChildByPath("package")) {
+    mPackageUuid = node->getValueOfFirstChild<Uuid>();
+  }
+}
+
+LibraryBaseElementHeader::~LibraryBaseElementHeader() noexcept {
+}
+
+/*******************************************************************************
+ *  Getters
+ ******************************************************************************/
+
+QStringList LibraryBaseElementHeader::getAllAvailableLocales() const
+    noexcept {
+  QStringList list;
+  list.append(mNames.keys());
+  list.append(mDescriptions.keys());
+  list.append(mKeywords.keys());
+  list.removeDuplicates();
+  list.sort(Qt::CaseSensitive);
+  return list;
+}
+
+/*******************************************************************************
+ *  Static Variables
+ ******************************************************************************/
+
+// All root nodes of the main files which contain metadata, see the
+// serialize() methods of all library element classes.
+const QSet<QByteArray> LibraryBaseElementHeader::sRootChildren = {
+    "name",     "description", "keywords", "author", "version",
+    "created",  "deprecated",  "category", "parent", "component",
+    "package",
+};
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace library
+}  // namespace librepcb
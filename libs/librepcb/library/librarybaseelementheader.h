@@ -0,0 +1,152 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBREPCB_LIBRARY_LIBRARYBASEELEMENTHEADER_H
+#define LIBREPCB_LIBRARY_LIBRARYBASEELEMENTHEADER_H
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+#include <librepcb/common/fileio/serializablekeyvaluemap.h>
+#include <librepcb/common/fileio/sexpression.h>
+#include <librepcb/common/fileio/transactionaldirectory.h>
+#include <librepcb/common/uuid.h>
+#include <librepcb/common/version.h>
+
+#include <QtCore>
+
+#include <optional/tl/optional.hpp>
+
+/*******************************************************************************
+ *  Namespace / Forward Declarations
+ ******************************************************************************/
+namespace librepcb {
+namespace library {
+
+/*******************************************************************************
+ *  Class LibraryBaseElementHeader
+ ******************************************************************************/
+
+/**
+ * @brief The metadata of a library element, read without loading the element
+ *
+ * Reads only the metadata nodes of the element's main file (UUID, version,
+ * names, categories, ...). All other nodes like symbol graphics or package
+ * footprints are skipped by the parser, so this is much faster than loading
+ * the whole element, e.g. to index library elements.
+ *
+ * The directory is validated the same way as in
+ * librepcb::library::LibraryBaseElement, i.e. reading the header of an
+ * invalid element throws the same exceptions as loading it.
+ */
+class LibraryBaseElementHeader final {
+public:
+  // Constructors / Destructor
+  LibraryBaseElementHeader()                                      = delete;
+  LibraryBaseElementHeader(const LibraryBaseElementHeader& other) = default;
+  LibraryBaseElementHeader(const TransactionalDirectory& directory,
+                           bool                          dirnameMustBeUuid,
+                           const QString&                shortElementName,
+                           const QString&                longElementName);
+  ~LibraryBaseElementHeader() noexcept;
+
+  // Getters
+  const Uuid&      getUuid() const noexcept { return mUuid; }
+  const Version&   getVersion() const noexcept { return mVersion; }
+  const QString&   getAuthor() const noexcept { return mAuthor; }
+  const QDateTime& getCreated() const noexcept { return mCreated; }
+  bool             isDeprecated() const noexcept { return mIsDeprecated; }
+  const LocalizedNameMap&        getNames() const noexcept { return mNames; }
+  const LocalizedDescriptionMap& getDescriptions() const noexcept {
+    return mDescriptions;
+  }
+  const LocalizedKeywordsMap& getKeywords() const noexcept { return mKeywords; }
+  QStringList                 getAllAvailableLocales() const noexcept;
+
+  /// Categories of library elements (empty for categories and libraries)
+  const QSet<Uuid>& getCategories() const noexcept { return mCategories; }
+
+  /// Parent of library categories (also nullopt for root categories)
+  const tl::optional<Uuid>& getParentUuid() const noexcept {
+    return mParentUuid;
+  }
+
+  /// Component of devices (nullopt for all other element types)
+  const tl::optional<Uuid>& getComponentUuid() const noexcept {
+    return mComponentUuid;
+  }
+
+  /// Package of devices (nullopt for all other element types)
+  const tl::optional<Uuid>& getPackageUuid() const noexcept {
+    return mPackageUuid;
+  }
+
+  // Operator Overloadings
+  LibraryBaseElementHeader& operator=(const LibraryBaseElementHeader& rhs) =
+      default;
+
+  // Static Methods
+
+  /**
+   * @brief Read the header of a library element stored in a directory named
+   *        by its UUID (i.e. all element types except libraries)
+   *
+   * @tparam ElementType  The type of the library element, e.g. Symbol.
+   *
+   * @param directory     The directory of the library element.
+   *
+   * @return The metadata of the element
+   */
+  template <typename ElementType>
+  static LibraryBaseElementHeader read(
+      const TransactionalDirectory& directory) {
+    return LibraryBaseElementHeader(directory, true,
+                                    ElementType::getShortElementName(),
+                                    ElementType::getLongElementName());
+  }
+
+private:  // Methods
+  explicit LibraryBaseElementHeader(const SExpression& root);
+
+private:  // Data
+  Uuid                    mUuid;
+  Version                 mVersion;
+  QString                 mAuthor;
+  QDateTime               mCreated;
+  bool                    mIsDeprecated;
+  LocalizedNameMap        mNames;
+  LocalizedDescriptionMap mDescriptions;
+  LocalizedKeywordsMap    mKeywords;
+  QSet<Uuid>              mCategories;
+  tl::optional<Uuid>      mParentUuid;
+  tl::optional<Uuid>      mComponentUuid;
+  tl::optional<Uuid>      mPackageUuid;
+
+  /// Names of the root nodes to parse
+  static const QSet<QByteArray> sRootChildren;
+};
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace library
+}  // namespace librepcb
+
+#endif  // LIBREPCB_LIBRARY_LIBRARYBASEELEMENTHEADER_H
@@ -54,7 +54,8 @@ ComponentChooserDialog::ComponentChooserDialog(
   : QDialog(parent),
     mWorkspace(ws),
     mLayerProvider(layerProvider),
-    mUi(new Ui::ComponentChooserDialog) {
+    mUi(new Ui::ComponentChooserDialog),
+    mSearch(ws.getLibraryDb()) {
   mUi->setupUi(this);
   mGraphicsScene.reset(new GraphicsScene());
   mUi->graphicsView->setScene(mGraphicsScene.data());
@@ -129,11 +130,19 @@ void ComponentChooserDialog::listComponents_itemDoubleClicked(
 void ComponentChooserDialog::searchComponents(const QString& input) {
   setSelectedCategory(tl::nullopt);
 
-  // min. 2 chars to avoid freeze on entering first character due to huge result
+  // min. 2 chars to avoid huge results on entering the first character
   if (input.length() > 1) {
-    QList<Uuid> components =
-        mWorkspace.getLibraryDb().getElementsBySearchKeyword<Component>(input);
-    foreach (const Uuid& uuid, components) {
+    mSearch.start(input);  // the result is added in searchFinished()
+  }
+}
+
+void ComponentChooserDialog::searchFinished(
+    const workspace::WorkspaceLibrarySearch::Result& result) noexcept {
+  try {
+    if (!result.error.isEmpty()) {
+      throw RuntimeError(__FILE__, __LINE__, result.error);
+    }
+    foreach (const Uuid& uuid, result.get<Component>()) {
       FilePath fp =
           mWorkspace.getLibraryDb().getLatestComponent(uuid);  // can throw
       QString name;
@@ -144,6 +153,8 @@ void ComponentChooserDialog::searchComponents(const QString& input) {
       item->setData(Qt::UserRole, uuid.toStr());
       mUi->listComponents->addItem(item);
     }
+  } catch (const Exception& e) {
+    QMessageBox::critical(this, tr("Error"), e.getMsg());
   }
 }
 
@@ -153,6 +164,7 @@ void ComponentChooserDialog::setSelectedCategory(
 
   setSelectedComponent(tl::nullopt);
   mUi->listComponents->clear();
+  mSearch.cancel();
 
   mSelectedCategoryUuid = uuid;
   try {
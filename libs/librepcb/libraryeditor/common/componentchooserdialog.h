@@ -25,6 +25,7 @@
  ******************************************************************************/
 #include <librepcb/common/fileio/filepath.h>
 #include <librepcb/common/uuid.h>
+#include <librepcb/workspace/library/workspacelibrarysearch.h>
 
 #include <QtCore>
 #include <QtWidgets>
@@ -90,6 +91,8 @@ private:  // Methods
                                          QListWidgetItem* previous) noexcept;
   void listComponents_itemDoubleClicked(QListWidgetItem* item) noexcept;
   void searchComponents(const QString& input);
+  void searchFinished(
+      const workspace::WorkspaceLibrarySearch::Result& result) noexcept;
   void setSelectedCategory(const tl::optional<Uuid>& uuid) noexcept;
   void setSelectedComponent(const tl::optional<Uuid>& uuid) noexcept;
   void updatePreview(const FilePath& fp) noexcept;
@@ -100,6 +103,7 @@ private:  // Data
   const workspace::Workspace&                mWorkspace;
   const IF_GraphicsLayerProvider*            mLayerProvider;
   QScopedPointer<Ui::ComponentChooserDialog> mUi;
+  workspace::WorkspaceLibrarySearch           mSearch;
   QScopedPointer<QAbstractItemModel>         mCategoryTreeModel;
   tl::optional<Uuid>                         mSelectedCategoryUuid;
   tl::optional<Uuid>                         mSelectedComponentUuid;
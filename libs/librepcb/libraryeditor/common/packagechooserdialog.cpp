@@ -53,7 +53,8 @@ PackageChooserDialog::PackageChooserDialog(
   : QDialog(parent),
     mWorkspace(ws),
     mLayerProvider(layerProvider),
-    mUi(new Ui::PackageChooserDialog) {
+    mUi(new Ui::PackageChooserDialog),
+    mSearch(ws.getLibraryDb()) {
   mUi->setupUi(this);
 
   mGraphicsScene.reset(new GraphicsScene());
@@ -129,11 +130,19 @@ void PackageChooserDialog::listPackages_itemDoubleClicked(
 void PackageChooserDialog::searchPackages(const QString& input) {
   setSelectedCategory(tl::nullopt);
 
-  // min. 2 chars to avoid freeze on entering first character due to huge result
+  // min. 2 chars to avoid huge results on entering the first character
   if (input.length() > 1) {
-    QList<Uuid> packages =
-        mWorkspace.getLibraryDb().getElementsBySearchKeyword<Package>(input);
-    foreach (const Uuid& uuid, packages) {
+    mSearch.start(input);  // the result is added in searchFinished()
+  }
+}
+
+void PackageChooserDialog::searchFinished(
+    const workspace::WorkspaceLibrarySearch::Result& result) noexcept {
+  try {
+    if (!result.error.isEmpty()) {
+      throw RuntimeError(__FILE__, __LINE__, result.error);
+    }
+    foreach (const Uuid& uuid, result.get<Package>()) {
       FilePath fp =
           mWorkspace.getLibraryDb().getLatestPackage(uuid);  // can throw
       QString name;
@@ -144,6 +153,8 @@ void PackageChooserDialog::searchPackages(const QString& input) {
       item->setData(Qt::UserRole, uuid.toStr());
       mUi->listPackages->addItem(item);
     }
+  } catch (const Exception& e) {
+    QMessageBox::critical(this, tr("Error"), e.getMsg());
   }
 }
 
@@ -153,6 +164,7 @@ void PackageChooserDialog::setSelectedCategory(
 
   setSelectedPackage(tl::nullopt);
   mUi->listPackages->clear();
+  mSearch.cancel();
 
   mSelectedCategoryUuid = uuid;
 
@@ -25,6 +25,7 @@
  ******************************************************************************/
 #include <librepcb/common/fileio/filepath.h>
 #include <librepcb/common/uuid.h>
+#include <librepcb/workspace/library/workspacelibrarysearch.h>
 
 #include <QtCore>
 #include <QtWidgets>
@@ -87,6 +88,8 @@ private:  // Methods
                                        QListWidgetItem* previous) noexcept;
   void listPackages_itemDoubleClicked(QListWidgetItem* item) noexcept;
   void searchPackages(const QString& input);
+  void searchFinished(
+      const workspace::WorkspaceLibrarySearch::Result& result) noexcept;
   void setSelectedCategory(const tl::optional<Uuid>& uuid) noexcept;
   void setSelectedPackage(const tl::optional<Uuid>& uuid) noexcept;
   void updatePreview(const FilePath& fp) noexcept;
@@ -97,6 +100,7 @@ private:  // Data
   const workspace::Workspace&              mWorkspace;
   const IF_GraphicsLayerProvider*          mLayerProvider;
   QScopedPointer<Ui::PackageChooserDialog> mUi;
+  workspace::WorkspaceLibrarySearch         mSearch;
   QScopedPointer<QAbstractItemModel>       mCategoryTreeModel;
   tl::optional<Uuid>                       mSelectedCategoryUuid;
   tl::optional<Uuid>                       mSelectedPackageUuid;
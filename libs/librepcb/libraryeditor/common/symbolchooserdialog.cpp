@@ -54,6 +54,7 @@ SymbolChooserDialog::SymbolChooserDialog(
     mWorkspace(ws),
     mLayerProvider(layerProvider),
     mUi(new Ui::SymbolChooserDialog),
+    mSearch(ws.getLibraryDb()),
     mPreviewScene(new GraphicsScene()) {
   mUi->setupUi(this);
   mUi->graphicsView->setScene(mPreviewScene.data());
@@ -72,6 +73,9 @@ SymbolChooserDialog::SymbolChooserDialog(
           &SymbolChooserDialog::listSymbols_itemDoubleClicked);
   connect(mUi->edtSearch, &QLineEdit::textChanged, this,
           &SymbolChooserDialog::searchEditTextChanged);
+  mSearch.addElementType<Symbol>();
+  connect(&mSearch, &workspace::WorkspaceLibrarySearch::finished, this,
+          &SymbolChooserDialog::searchFinished);
 
   setSelectedSymbol(FilePath());
 }
@@ -146,11 +150,19 @@ void SymbolChooserDialog::listSymbols_itemDoubleClicked(
 void SymbolChooserDialog::searchSymbols(const QString& input) {
   setSelectedCategory(tl::nullopt);
 
-  // min. 2 chars to avoid freeze on entering first character due to huge result
+  // min. 2 chars to avoid huge results on entering the first character
   if (input.length() > 1) {
-    QList<Uuid> symbols =
-        mWorkspace.getLibraryDb().getElementsBySearchKeyword<Symbol>(input);
-    foreach (const Uuid& uuid, symbols) {
+    mSearch.start(input);  // the result is added in searchFinished()
+  }
+}
+
+void SymbolChooserDialog::searchFinished(
+    const workspace::WorkspaceLibrarySearch::Result& result) noexcept {
+  try {
+    if (!result.error.isEmpty()) {
+      throw RuntimeError(__FILE__, __LINE__, result.error);
+    }
+    foreach (const Uuid& uuid, result.get<Symbol>()) {
       FilePath fp =
           mWorkspace.getLibraryDb().getLatestSymbol(uuid);  // can throw
       QString name;
@@ -161,6 +173,8 @@ void SymbolChooserDialog::searchSymbols(const QString& input) {
       item->setData(Qt::UserRole, fp.toStr());
       mUi->listSymbols->addItem(item);
     }
+  } catch (const Exception& e) {
+    QMessageBox::critical(this, tr("Error"), e.getMsg());
   }
 }
 
@@ -170,6 +184,7 @@ void SymbolChooserDialog::setSelectedCategory(
 
   setSelectedSymbol(FilePath());
   mUi->listSymbols->clear();
+  mSearch.cancel();
 
   mSelectedCategoryUuid = uuid;
 
@@ -25,6 +25,7 @@
  ******************************************************************************/
 #include <librepcb/common/fileio/filepath.h>
 #include <librepcb/common/uuid.h>
+#include <librepcb/workspace/library/workspacelibrarysearch.h>
 
 #include <QtCore>
 #include <QtWidgets>
@@ -87,6 +88,8 @@ private:  // Methods
                                       QListWidgetItem* previous) noexcept;
   void listSymbols_itemDoubleClicked(QListWidgetItem* item) noexcept;
   void searchSymbols(const QString& input);
+  void searchFinished(
+      const workspace::WorkspaceLibrarySearch::Result& result) noexcept;
   void setSelectedCategory(const tl::optional<Uuid>& uuid) noexcept;
   void setSelectedSymbol(const FilePath& fp) noexcept;
   void accept() noexcept override;
@@ -96,6 +99,7 @@ private:  // Data
   const workspace::Workspace&             mWorkspace;
   const IF_GraphicsLayerProvider&         mLayerProvider;
   QScopedPointer<Ui::SymbolChooserDialog> mUi;
+  workspace::WorkspaceLibrarySearch       mSearch;
   QScopedPointer<QAbstractItemModel>      mCategoryTreeModel;
   QScopedPointer<GraphicsScene>           mPreviewScene;
   tl::optional<Uuid>                      mSelectedCategoryUuid;
@@ -54,6 +54,8 @@ LibraryManager::LibraryManager(workspace::Workspace& ws,
     mCurrentWidget(nullptr),
     mSelectedLibrary() {
   mUi->setupUi(this);
+  connect(&mLibraryListWatcher, &QFutureWatcher<LibraryList>::finished, this,
+          &LibraryManager::libraryListLoaded);
   connect(mUi->btnClose, &QPushButton::clicked, this, &QMainWindow::close);
   connect(mUi->lstLibraries, &QListWidget::currentItemChanged, this,
           &LibraryManager::currentListItemChanged);
@@ -115,7 +117,20 @@ void LibraryManager::clearLibraryList() noexcept {
 }
 
 void LibraryManager::updateLibraryList() noexcept {
-  FilePath selectedLibrary = mSelectedLibrary;
+  // Load the list in a background thread since reading all the names and
+  // icons from the database takes a while with many libraries. If the list is
+  // updated again in the meantime, the previous result is simply discarded.
+  const workspace::WorkspaceLibraryDb& db = mWorkspace.getLibraryDb();
+
+  QStringList localeOrder =
+      mWorkspace.getSettings().getLibLocaleOrder().getLocaleOrder();
+  mLibraryListWatcher.setFuture(db.runAsync(
+      [&db, localeOrder]() { return loadLibraryList(db, localeOrder); }));
+}
+
+void LibraryManager::libraryListLoaded() noexcept {
+  LibraryList list            = mLibraryListWatcher.result();
+  FilePath    selectedLibrary = mSelectedLibrary;
 
   clearLibraryList();
 
@@ -125,26 +140,13 @@ void LibraryManager::updateLibraryList() noexcept {
   widgets.append(new LibraryListWidgetItem(mWorkspace, FilePath()));
 
   // add all existing libraries
-  try {
-    QMultiMap<Version, FilePath> libraries =
-        mWorkspace.getLibraryDb().getLibraries();  // can throw
-
-    foreach (const FilePath& libDir, libraries) {
-      QString name, description, keywords;
-      mWorkspace.getLibraryDb().getElementTranslations<Library>(
-          libDir, mWorkspace.getSettings().getLibLocaleOrder().getLocaleOrder(),
-          &name, &description, &keywords);  // can throw
-      QPixmap icon;
-      mWorkspace.getLibraryDb().getLibraryMetadata(libDir, &icon);  // can throw
-
-      LibraryListWidgetItem* widget = new LibraryListWidgetItem(
-          mWorkspace, libDir, name, description, icon);
-      connect(widget, &LibraryListWidgetItem::openLibraryEditorTriggered, this,
-              &LibraryManager::openLibraryEditorTriggered);
-      widgets.append(widget);
-    }
-  } catch (const Exception& e) {
-    QMessageBox::critical(this, tr("Could not load library list"), e.getMsg());
+  foreach (const LibraryListEntry& entry, list.libraries) {
+    LibraryListWidgetItem* widget = new LibraryListWidgetItem(
+        mWorkspace, entry.libDir, entry.name, entry.description,
+        QPixmap::fromImage(entry.icon));
+    connect(widget, &LibraryListWidgetItem::openLibraryEditorTriggered, this,
+            &LibraryManager::openLibraryEditorTriggered);
+    widgets.append(widget);
   }
 
   // sort all list widget items
@@ -165,6 +167,10 @@ void LibraryManager::updateLibraryList() noexcept {
 
   // select the previously selected library
   mUi->lstLibraries->setCurrentRow(selectedLibraryIndex);
+
+  if (!list.error.isEmpty()) {
+    QMessageBox::critical(this, tr("Could not load library list"), list.error);
+  }
 }
 
 void LibraryManager::currentListItemChanged(
@@ -214,6 +220,26 @@ void LibraryManager::libraryAddedSlot(const FilePath& libDir) noexcept {
  *  Static Methods
  ******************************************************************************/
 
+LibraryManager::LibraryList LibraryManager::loadLibraryList(
+    const workspace::WorkspaceLibraryDb& db,
+    const QStringList&                   localeOrder) noexcept {
+  LibraryList list;
+  try {
+    QMultiMap<Version, FilePath> libraries = db.getLibraries();  // can throw
+    foreach (const FilePath& libDir, libraries) {
+      LibraryListEntry entry;
+      entry.libDir = libDir;
+      db.getElementTranslations<Library>(libDir, localeOrder, &entry.name,
+                                         &entry.description);  // can throw
+      db.getLibraryMetadata(libDir, &entry.icon);              // can throw
+      list.libraries.append(entry);
+    }
+  } catch (const Exception& e) {
+    list.error = e.getMsg();
+  }
+  return list;
+}
+
 bool LibraryManager::widgetsLessThan(const LibraryListWidgetItem* a,
                                      const LibraryListWidgetItem* b) noexcept {
   Q_ASSERT(a && b);
@@ -35,6 +35,7 @@ namespace librepcb {
 
 namespace workspace {
 class Workspace;
+class WorkspaceLibraryDb;
 }
 
 namespace library {
@@ -73,16 +74,31 @@ public:
   // Operator Overloadings
   LibraryManager& operator=(const LibraryManager& rhs) = delete;
 
+private:  // Types
+  struct LibraryListEntry {
+    FilePath libDir;
+    QString  name;
+    QString  description;
+    QImage   icon;  ///< QPixmap must not be used outside the GUI thread
+  };
+  struct LibraryList {
+    QList<LibraryListEntry> libraries;
+    QString                 error;  ///< Empty if successful
+  };
+
 private:  // Methods
   void closeEvent(QCloseEvent* event) noexcept override;
   void clearLibraryList() noexcept;
   void updateLibraryList() noexcept;
+  void libraryListLoaded() noexcept;
   void currentListItemChanged(QListWidgetItem* current,
                               QListWidgetItem* previous) noexcept;
   void libraryAddedSlot(const FilePath& libDir) noexcept;
 
-  static bool widgetsLessThan(const LibraryListWidgetItem* a,
-                              const LibraryListWidgetItem* b) noexcept;
+  static LibraryList loadLibraryList(const workspace::WorkspaceLibraryDb& db,
+                                     const QStringList& localeOrder) noexcept;
+  static bool        widgetsLessThan(const LibraryListWidgetItem* a,
+                                     const LibraryListWidgetItem* b) noexcept;
 
 signals:
   void openLibraryEditorTriggered(const FilePath& libDir);
@@ -93,6 +109,7 @@ private:  // Data
   QScopedPointer<AddLibraryWidget>   mAddLibraryWidget;
   QWidget*                           mCurrentWidget;
   FilePath                           mSelectedLibrary;
+  QFutureWatcher<LibraryList>        mLibraryListWatcher;
 };
 
 /*******************************************************************************
@@ -10,7 +10,7 @@ TARGET = librepcblibrarymanager
 # Use common project definitions
 include(../../../common.pri)
 
-QT += core widgets xml sql printsupport network
+QT += core widgets xml sql printsupport network concurrent
 
 CONFIG += staticlib
 
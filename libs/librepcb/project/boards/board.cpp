@@ -30,6 +30,8 @@
 #include "boardairwiresbuilder.h"
 #include "boardfabricationoutputsettings.h"
 #include "boardlayerstack.h"
+#include "boardobstacleindex.h"
+#include "boardplanefragmentsbuilder.h"
 #include "boardselectionquery.h"
 #include "boardusersettings.h"
 #include "items/bi_airwire.h"
@@ -56,6 +58,7 @@
 #include <librepcb/library/cmp/component.h>
 #include <librepcb/library/pkg/footprint.h>
 
+#include <QtConcurrent/QtConcurrent>
 #include <QtCore>
 #include <QtWidgets>
 
@@ -76,6 +79,9 @@ Board::Board(const Board&                            other,
     mProject(other.getProject()),
     mDirectory(std::move(directory)),
     mIsAddedToProject(false),
+    mRevision(1),
+    mSavedRevision(0),
+    mItemIndex(PositiveLength(2000000)),
     mUuid(Uuid::createRandom()),
     mName(name),
     mDefaultFontFileName(other.mDefaultFontFileName) {
@@ -153,6 +159,8 @@ Board::Board(const Board&                            other,
             &Board::updateErcMessages);
     connect(&mProject.getCircuit(), &Circuit::componentRemoved, this,
             &Board::updateErcMessages);
+    connect(&mAirWiresJobsWatcher, &QFutureWatcher<void>::finished, this,
+            &Board::airWiresJobsFinished);
   } catch (...) {
     // free the allocated memory in the reverse order of their allocation...
     qDeleteAll(mErcMsgListUnplacedComponentInstances);
@@ -188,6 +196,9 @@ Board::Board(Project&                                project,
     mProject(project),
     mDirectory(std::move(directory)),
     mIsAddedToProject(false),
+    mRevision(1),
+    mSavedRevision(0),
+    mItemIndex(PositiveLength(2000000)),
     mUuid(Uuid::createRandom()),
     mName("New Board") {
   try {
@@ -224,8 +235,8 @@ Board::Board(Project&                                project,
                       Path::rect(Point(0, 0), Point(100000000, 80000000)));
       mPolygons.append(new BI_Polygon(*this, polygon));
     } else {
-      SExpression root = SExpression::parse(
-          mDirectory->read(getFilePath().getFilename()), getFilePath());
+      SExpression root =
+          mDirectory->readSExpression(getFilePath().getFilename());
 
       // the board seems to be ready to open, so we will create all needed
       // objects
@@ -255,10 +266,8 @@ Board::Board(Project&                                project,
 
       // load user settings
       try {
-        QString     userSettingsFp = "settings.user.lp";
         SExpression userSettingsRoot =
-            SExpression::parse(mDirectory->read(userSettingsFp),
-                               mDirectory->getAbsPath(userSettingsFp));
+            mDirectory->readSExpression("settings.user.lp");
         mUserSettings.reset(new BoardUserSettings(*this, userSettingsRoot));
       } catch (const Exception&) {
         // Project user settings are normally not put under version control and
@@ -321,7 +330,16 @@ Board::Board(Project&                                project,
       }
     }
 
-    rebuildAllPlanes();
+    // Restore the plane fragments from the cache and rebuild the outdated
+    // planes later in the event loop to not delay opening the project.
+    if (!create) {
+      loadPlanesCache();
+    }
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 4, 0))
+    QTimer::singleShot(0, this, &Board::rebuildOutdatedPlanes);
+#else
+    QTimer::singleShot(0, this, SLOT(rebuildOutdatedPlanes()));
+#endif
     updateErcMessages();
     updateIcon();
 
@@ -333,6 +351,8 @@ Board::Board(Project&                                project,
             &Board::updateErcMessages);
     connect(&mProject.getCircuit(), &Circuit::componentRemoved, this,
             &Board::updateErcMessages);
+    connect(&mAirWiresJobsWatcher, &QFutureWatcher<void>::finished, this,
+            &Board::airWiresJobsFinished);
   } catch (...) {
     // free the allocated memory in the reverse order of their allocation...
     qDeleteAll(mErcMsgListUnplacedComponentInstances);
@@ -364,6 +384,14 @@ Board::Board(Project&                                project,
 Board::~Board() noexcept {
   Q_ASSERT(!mIsAddedToProject);
 
+  // The worker thread only accesses the jobs, but their results must not
+  // arrive while the items are deleted.
+  disconnect(&mAirWiresJobsWatcher, nullptr, this, nullptr);
+  mAirWiresJobsWatcher.waitForFinished();
+  mRunningAirWiresJobs.clear();
+  mPendingAirWiresJobs.clear();
+  mAirWiresBuilders.clear();
+
   qDeleteAll(mErcMsgListUnplacedComponentInstances);
   mErcMsgListUnplacedComponentInstances.clear();
 
@@ -406,7 +434,8 @@ bool Board::isEmpty() const noexcept {
 }
 
 QList<BI_Base*> Board::getItemsAtScenePos(const Point& pos) const noexcept {
-  QPointF scenePosPx = pos.toPxQPointF();
+  QPointF         scenePosPx = pos.toPxQPointF();
+  QList<BI_Base*> candidates = getItemIndexCandidates(pos);
   QList<BI_Base*>
       list;  // Note: The order of adding the items is very important (the
              // top most item must appear as the first item in the list)!
@@ -421,8 +450,23 @@ QList<BI_Base*> Board::getItemsAtScenePos(const Point& pos) const noexcept {
   foreach (BI_NetLine* netline, getNetLinesAtScenePos(pos, nullptr, nullptr)) {
     list.append(netline);
   }
-  // footprints & pads
-  foreach (BI_Device* device, mDeviceInstances) {
+  // footprints & pads (devices sorted like mDeviceInstances)
+  QMap<Uuid, BI_Device*> devices;
+  foreach (BI_Base* item, candidates) {
+    BI_Footprint* footprint = nullptr;
+    if (item->getType() == BI_Base::Type_t::Footprint) {
+      footprint = static_cast<BI_Footprint*>(item);
+    } else if (item->getType() == BI_Base::Type_t::FootprintPad) {
+      footprint = &static_cast<BI_FootprintPad*>(item)->getFootprint();
+    } else if (item->getType() == BI_Base::Type_t::StrokeText) {
+      footprint = static_cast<BI_StrokeText*>(item)->getFootprint();
+    }
+    if (footprint) {
+      BI_Device& device = footprint->getDeviceInstance();
+      devices.insert(device.getComponentInstanceUuid(), &device);
+    }
+  }
+  foreach (BI_Device* device, devices) {
     BI_Footprint& footprint = device->getFootprint();
     if (footprint.isSelectable() &&
         footprint.getGrabAreaScenePx().contains(scenePosPx)) {
@@ -453,34 +497,37 @@ QList<BI_Base*> Board::getItemsAtScenePos(const Point& pos) const noexcept {
       }
     }
   }
-  // planes
-  foreach (BI_Plane* planes, mPlanes) {
-    if (planes->isSelectable() &&
-        planes->getGrabAreaScenePx().contains(scenePosPx)) {
-      list.append(planes);
-    }
-  }
-  // polygons
-  foreach (BI_Polygon* polygon, mPolygons) {
-    if (polygon->isSelectable() &&
-        polygon->getGrabAreaScenePx().contains(scenePosPx)) {
-      list.append(polygon);
-    }
-  }
-  // texts
-  foreach (BI_StrokeText* text, mStrokeTexts) {
-    if (text->isSelectable() &&
-        text->getGrabAreaScenePx().contains(scenePosPx)) {
-      list.append(text);
+  // planes, polygons, texts & holes
+  QList<BI_Base*> planes, polygons, texts, holes;
+  foreach (BI_Base* item, candidates) {
+    QList<BI_Base*>* target = nullptr;
+    switch (item->getType()) {
+      case BI_Base::Type_t::Plane:
+        target = &planes;
+        break;
+      case BI_Base::Type_t::Polygon:
+        target = &polygons;
+        break;
+      case BI_Base::Type_t::StrokeText:
+        if (!static_cast<BI_StrokeText*>(item)->getFootprint()) {
+          target = &texts;
+        }
+        break;
+      case BI_Base::Type_t::Hole:
+        target = &holes;
+        break;
+      default:
+        break;
     }
-  }
-  // holes
-  foreach (BI_Hole* hole, mHoles) {
-    if (hole->isSelectable() &&
-        hole->getGrabAreaScenePx().contains(scenePosPx)) {
-      list.append(hole);
+    if (target && item->isSelectable() &&
+        item->getGrabAreaScenePx().contains(scenePosPx)) {
+      target->append(item);
     }
   }
+  list += planes;
+  list += polygons;
+  list += texts;
+  list += holes;
   return list;
 }
 
@@ -488,9 +535,13 @@ QList<BI_Via*> Board::getViasAtScenePos(const Point&     pos,
                                         const NetSignal* netsignal) const
     noexcept {
   QList<BI_Via*> list;
-  foreach (BI_NetSegment* segment, mNetSegments) {
-    if ((!netsignal) || (&segment->getNetSignal() == netsignal)) {
-      segment->getViasAtScenePos(pos, list);
+  foreach (BI_Base* item, getItemIndexCandidates(pos)) {
+    if (item->getType() != BI_Base::Type_t::Via) continue;
+    BI_Via* via = static_cast<BI_Via*>(item);
+    if (via->isSelectable() &&
+        via->getGrabAreaScenePx().contains(pos.toPxQPointF()) &&
+        ((!netsignal) || (&via->getNetSignalOfNetSegment() == netsignal))) {
+      list.append(via);
     }
   }
   return list;
@@ -500,9 +551,15 @@ QList<BI_NetPoint*> Board::getNetPointsAtScenePos(
     const Point& pos, const GraphicsLayer* layer,
     const NetSignal* netsignal) const noexcept {
   QList<BI_NetPoint*> list;
-  foreach (BI_NetSegment* segment, mNetSegments) {
-    if ((!netsignal) || (&segment->getNetSignal() == netsignal)) {
-      segment->getNetPointsAtScenePos(pos, layer, list);
+  foreach (BI_Base* item, getItemIndexCandidates(pos)) {
+    if (item->getType() != BI_Base::Type_t::NetPoint) continue;
+    BI_NetPoint* netpoint = static_cast<BI_NetPoint*>(item);
+    if (netpoint->isSelectable() &&
+        netpoint->getGrabAreaScenePx().contains(pos.toPxQPointF()) &&
+        ((!layer) || (netpoint->getLayerOfLines() == layer)) &&
+        ((!netsignal) ||
+         (&netpoint->getNetSignalOfNetSegment() == netsignal))) {
+      list.append(netpoint);
     }
   }
   return list;
@@ -512,9 +569,15 @@ QList<BI_NetLine*> Board::getNetLinesAtScenePos(
     const Point& pos, const GraphicsLayer* layer,
     const NetSignal* netsignal) const noexcept {
   QList<BI_NetLine*> list;
-  foreach (BI_NetSegment* segment, mNetSegments) {
-    if ((!netsignal) || (&segment->getNetSignal() == netsignal)) {
-      segment->getNetLinesAtScenePos(pos, layer, list);
+  foreach (BI_Base* item, getItemIndexCandidates(pos)) {
+    if (item->getType() != BI_Base::Type_t::NetLine) continue;
+    BI_NetLine* netline = static_cast<BI_NetLine*>(item);
+    if (netline->isSelectable() &&
+        netline->getGrabAreaScenePx().contains(pos.toPxQPointF()) &&
+        ((!layer) || (&netline->getLayer() == layer)) &&
+        ((!netsignal) ||
+         (&netline->getNetSignalOfNetSegment() == netsignal))) {
+      list.append(netline);
     }
   }
   return list;
@@ -524,14 +587,14 @@ QList<BI_FootprintPad*> Board::getPadsAtScenePos(
     const Point& pos, const GraphicsLayer* layer,
     const NetSignal* netsignal) const noexcept {
   QList<BI_FootprintPad*> list;
-  foreach (BI_Device* device, mDeviceInstances) {
-    foreach (BI_FootprintPad* pad, device->getFootprint().getPads()) {
-      if (pad->isSelectable() &&
-          pad->getGrabAreaScenePx().contains(pos.toPxQPointF()) &&
-          ((!layer) || (pad->isOnLayer(layer->getName()))) &&
-          ((!netsignal) || (pad->getCompSigInstNetSignal() == netsignal))) {
-        list.append(pad);
-      }
+  foreach (BI_Base* item, getItemIndexCandidates(pos)) {
+    if (item->getType() != BI_Base::Type_t::FootprintPad) continue;
+    BI_FootprintPad* pad = static_cast<BI_FootprintPad*>(item);
+    if (pad->isSelectable() &&
+        pad->getGrabAreaScenePx().contains(pos.toPxQPointF()) &&
+        ((!layer) || (pad->isOnLayer(layer->getName()))) &&
+        ((!netsignal) || (pad->getCompSigInstNetSignal() == netsignal))) {
+      list.append(pad);
     }
   }
   return list;
@@ -562,6 +625,7 @@ QList<BI_Base*> Board::getAllItems() const noexcept {
 
 void Board::setGridProperties(const GridProperties& grid) noexcept {
   *mGridProperties = grid;
+  incrementRevision();
 }
 
 /*******************************************************************************
@@ -589,6 +653,7 @@ void Board::addDeviceInstance(BI_Device& instance) {
   // add to board
   instance.addToBoard();  // can throw
   mDeviceInstances.insert(instance.getComponentInstanceUuid(), &instance);
+  incrementRevision();
   updateErcMessages();
   emit deviceAdded(instance);
 }
@@ -601,6 +666,7 @@ void Board::removeDeviceInstance(BI_Device& instance) {
   // remove from board
   instance.removeFromBoard();  // can throw
   mDeviceInstances.remove(instance.getComponentInstanceUuid());
+  incrementRevision();
   updateErcMessages();
   emit deviceRemoved(instance);
 }
@@ -631,6 +697,7 @@ void Board::addNetSegment(BI_NetSegment& netsegment) {
   // add to board
   netsegment.addToBoard();  // can throw
   mNetSegments.append(&netsegment);
+  incrementRevision();
 }
 
 void Board::removeNetSegment(BI_NetSegment& netsegment) {
@@ -640,6 +707,7 @@ void Board::removeNetSegment(BI_NetSegment& netsegment) {
   // remove from board
   netsegment.removeFromBoard();  // can throw
   mNetSegments.removeOne(&netsegment);
+  incrementRevision();
 }
 
 /*******************************************************************************
@@ -653,6 +721,7 @@ void Board::addPlane(BI_Plane& plane) {
   }
   plane.addToBoard();  // can throw
   mPlanes.append(&plane);
+  incrementRevision();
 }
 
 void Board::removePlane(BI_Plane& plane) {
@@ -661,15 +730,63 @@ void Board::removePlane(BI_Plane& plane) {
   }
   plane.removeFromBoard();  // can throw
   mPlanes.removeOne(&plane);
+  incrementRevision();
 }
 
-void Board::rebuildAllPlanes() noexcept {
+void Board::rebuildAllPlanes(bool force) noexcept {
   QList<BI_Plane*> planes = mPlanes;
   qSort(planes.begin(), planes.end(),
         [](const BI_Plane* p1, const BI_Plane* p2) {
           return !(*p1 < *p2);
         });  // sort by priority (highest priority first)
-  foreach (BI_Plane* plane, planes) { plane->rebuild(); }
+
+  // Split the planes into stages: each plane is put into the first stage after
+  // all the planes it depends on. Thus planes within the same stage do not
+  // depend on each other and can be built in parallel.
+  QVector<int>            planeStages(planes.count(), 0);
+  QList<QList<BI_Plane*>> stages;
+  for (int i = 0; i < planes.count(); ++i) {
+    for (int k = 0; k < i; ++k) {
+      if (BoardPlaneFragmentsBuilder::dependsOn(*planes.at(i),
+                                                *planes.at(k))) {
+        planeStages[i] = qMax(planeStages[i], planeStages[k] + 1);
+      }
+    }
+    while (stages.count() <= planeStages[i]) {
+      stages.append(QList<BI_Plane*>());
+    }
+    stages[planeStages[i]].append(planes.at(i));
+  }
+
+  // Index all obstacles once, shared by all builders (read-only).
+  QSet<QString> layers;
+  foreach (const BI_Plane* plane, planes) {
+    layers.insert(*plane->getLayerName());
+  }
+  std::shared_ptr<const BoardObstacleIndex> obstacles =
+      std::make_shared<BoardObstacleIndex>(*this, layers);
+
+  // Build the planes of each stage in the global thread pool, but commit the
+  // results in this thread before the next stage is started since the
+  // builders of the next stage read the fragments of the previous stages.
+  // Planes whose inputs were not modified are skipped by the builders.
+  foreach (const QList<BI_Plane*>& stage, stages) {
+    QList<std::shared_ptr<BoardPlaneFragmentsBuilder>> builders;
+    QList<QFuture<bool>>                               futures;
+    foreach (BI_Plane* plane, stage) {
+      auto builder =
+          std::make_shared<BoardPlaneFragmentsBuilder>(*plane, obstacles);
+      builders.append(builder);
+      futures.append(QtConcurrent::run(
+          [builder, force]() { return builder->buildFragments(force); }));
+    }
+    for (int i = 0; i < stage.count(); ++i) {
+      if (futures.at(i).result()) {
+        stage.at(i)->setFragments(builders.at(i)->getFragments(),
+                                  builders.at(i)->getInputHash());
+      }
+    }
+  }
 }
 
 /*******************************************************************************
@@ -683,6 +800,7 @@ void Board::addPolygon(BI_Polygon& polygon) {
   }
   polygon.addToBoard();  // can throw
   mPolygons.append(&polygon);
+  incrementRevision();
 }
 
 void Board::removePolygon(BI_Polygon& polygon) {
@@ -691,6 +809,7 @@ void Board::removePolygon(BI_Polygon& polygon) {
   }
   polygon.removeFromBoard();  // can throw
   mPolygons.removeOne(&polygon);
+  incrementRevision();
 }
 
 /*******************************************************************************
@@ -704,6 +823,7 @@ void Board::addStrokeText(BI_StrokeText& text) {
   }
   text.addToBoard();  // can throw
   mStrokeTexts.append(&text);
+  incrementRevision();
 }
 
 void Board::removeStrokeText(BI_StrokeText& text) {
@@ -712,6 +832,7 @@ void Board::removeStrokeText(BI_StrokeText& text) {
   }
   text.removeFromBoard();  // can throw
   mStrokeTexts.removeOne(&text);
+  incrementRevision();
 }
 
 /*******************************************************************************
@@ -725,6 +846,7 @@ void Board::addHole(BI_Hole& hole) {
   }
   hole.addToBoard();  // can throw
   mHoles.append(&hole);
+  incrementRevision();
 }
 
 void Board::removeHole(BI_Hole& hole) {
@@ -733,12 +855,25 @@ void Board::removeHole(BI_Hole& hole) {
   }
   hole.removeFromBoard();  // can throw
   mHoles.removeOne(&hole);
+  incrementRevision();
 }
 
 /*******************************************************************************
  *  AirWire Methods
  ******************************************************************************/
 
+/**
+ * @brief A snapshot of a net signal whose airwires are calculated in a worker
+ *        thread
+ */
+struct Board::AirWiresJob {
+  NetSignal*                            netsignal;  ///< Not accessed by worker
+  std::shared_ptr<BoardAirWiresBuilder> builder;
+  BoardAirWiresBuilder::Snapshot        snapshot;
+  QVector<QPair<Point, Point>>          airwires;  ///< Result of the worker
+  bool outdated;  ///< Whether a newer snapshot exists (only used by GUI thread)
+};
+
 void Board::triggerAirWiresRebuild() noexcept {
   if (!mIsAddedToProject) {
     return;
@@ -746,24 +881,30 @@ void Board::triggerAirWiresRebuild() noexcept {
 
   try {
     foreach (NetSignal* netsignal, mScheduledNetSignalsForAirWireRebuild) {
-      // remove old airwires
-      while (BI_AirWire* airWire = mAirWires.take(netsignal)) {
-        airWire->removeFromBoard();  // can throw
-        delete airWire;
+      // results of currently running jobs are outdated now
+      foreach (const std::shared_ptr<AirWiresJob>& job, mRunningAirWiresJobs) {
+        if (job->netsignal == netsignal) {
+          job->outdated = true;
+        }
       }
 
       if (netsignal && netsignal->isAddedToCircuit()) {
-        // calculate new airwires
-        BoardAirWiresBuilder         builder(*this, *netsignal);
-        QVector<QPair<Point, Point>> airwires = builder.buildAirWires();
-
-        // add new airwires
-        foreach (const auto& points, airwires) {
-          QScopedPointer<BI_AirWire> airWire(
-              new BI_AirWire(*this, *netsignal, points.first, points.second));
-          airWire->addToBoard();  // can throw
-          mAirWires.insertMulti(netsignal, airWire.take());
+        // take a snapshot of the net signal to calculate the airwires in a
+        // worker thread (the builder is kept for the next rebuild to allow
+        // incremental calculations, e.g. while moving a device)
+        std::shared_ptr<BoardAirWiresBuilder>& builder =
+            mAirWiresBuilders[netsignal];
+        if (!builder) {
+          builder.reset(new BoardAirWiresBuilder(*this, *netsignal));
         }
+        std::shared_ptr<AirWiresJob> job(new AirWiresJob{
+            netsignal, builder, builder->takeSnapshot(), {}, false});
+        mPendingAirWiresJobs.insert(netsignal, job);  // replace older snapshot
+      } else {
+        // net signal was removed, so remove its airwires immediately
+        mAirWiresBuilders.remove(netsignal);
+        mPendingAirWiresJobs.remove(netsignal);
+        updateAirWires(netsignal, {});  // can throw
       }
     }
     mScheduledNetSignalsForAirWireRebuild.clear();
@@ -771,6 +912,7 @@ void Board::triggerAirWiresRebuild() noexcept {
                e) {  // std::exception because of the many std containers...
     qCritical() << "Failed to build airwires:" << e.what();
   }
+  startAirWiresJobs();
 }
 
 void Board::forceAirWiresRebuild() noexcept {
@@ -780,6 +922,94 @@ void Board::forceAirWiresRebuild() noexcept {
   triggerAirWiresRebuild();
 }
 
+bool Board::isAirWiresRebuildInProgress() const noexcept {
+  return (!mRunningAirWiresJobs.isEmpty()) || (!mPendingAirWiresJobs.isEmpty());
+}
+
+void Board::startAirWiresJobs() noexcept {
+  if (mAirWiresJobsWatcher.isRunning() || mPendingAirWiresJobs.isEmpty()) {
+    return;  // will be called again when the running jobs are finished
+  }
+
+  // Note: The jobs are processed sequentially in a single worker thread
+  // because a builder must not be used by several threads at the same time.
+  mRunningAirWiresJobs = mPendingAirWiresJobs.values();
+  mPendingAirWiresJobs.clear();
+  QList<std::shared_ptr<AirWiresJob>> jobs = mRunningAirWiresJobs;
+  mAirWiresJobsWatcher.setFuture(QtConcurrent::run([jobs]() {
+    foreach (const std::shared_ptr<AirWiresJob>& job, jobs) {
+      job->airwires = job->builder->buildAirWires(job->snapshot);
+    }
+  }));
+}
+
+void Board::airWiresJobsFinished() noexcept {
+  QList<std::shared_ptr<AirWiresJob>> jobs = mRunningAirWiresJobs;
+  mRunningAirWiresJobs.clear();
+  if (mIsAddedToProject) {
+    try {
+      foreach (const std::shared_ptr<AirWiresJob>& job, jobs) {
+        // drop results of net signals which were modified in the meantime
+        if ((!job->outdated) &&
+            (!mScheduledNetSignalsForAirWireRebuild.contains(job->netsignal))) {
+          updateAirWires(job->netsignal, job->airwires);  // can throw
+        }
+      }
+    } catch (const std::exception& e) {
+      qCritical() << "Failed to build airwires:" << e.what();
+    }
+  }
+  startAirWiresJobs();
+}
+
+void Board::updateAirWires(NetSignal*                          netsignal,
+                           const QVector<QPair<Point, Point>>& airwires) {
+  // keep unchanged airwires to avoid recreating their graphics items
+  QMultiHash<QPair<Point, Point>, BI_AirWire*> oldAirWires;
+  while (BI_AirWire* airWire = mAirWires.take(netsignal)) {
+    oldAirWires.insert(qMakePair(airWire->getP1(), airWire->getP2()), airWire);
+  }
+  foreach (const auto& points, airwires) {
+    BI_AirWire* airWire = oldAirWires.take(points);
+    if (!airWire) {
+      airWire = oldAirWires.take(qMakePair(points.second, points.first));
+    }
+    if (airWire) {
+      mAirWires.insertMulti(netsignal, airWire);
+    } else {
+      QScopedPointer<BI_AirWire> newAirWire(
+          new BI_AirWire(*this, *netsignal, points.first, points.second));
+      newAirWire->addToBoard();  // can throw
+      mAirWires.insertMulti(netsignal, newAirWire.take());
+    }
+  }
+
+  // remove old airwires
+  foreach (BI_AirWire* airWire, oldAirWires) {
+    airWire->removeFromBoard();  // can throw
+    delete airWire;
+  }
+}
+
+/*******************************************************************************
+ *  Spatial Index Methods
+ ******************************************************************************/
+
+void Board::scheduleItemIndexUpdate(BI_Base& item) noexcept {
+  if (item.isAddedToBoard()) {
+    if (!mItemIndexQueueSet.contains(&item)) {
+      mItemIndexQueue.append(&item);
+      mItemIndexQueueSet.insert(&item);
+    }
+  } else {
+    // remove immediately since the item might be deleted afterwards
+    if (mItemIndexQueueSet.remove(&item)) {
+      mItemIndexQueue.removeOne(&item);
+    }
+    mItemIndex.remove(&item);
+  }
+}
+
 /*******************************************************************************
  *  General Methods
  ******************************************************************************/
@@ -819,17 +1049,36 @@ void Board::removeFromProject() {
 
 void Board::save() {
   if (mIsAddedToProject) {
-    // save board file
-    SExpression brdDoc(serializeToDomElement("librepcb_board"));  // can throw
-    mDirectory->write(getFilePath().getFilename(),
-                      brdDoc.toByteArray());  // can throw
+    // save board file (only if it was modified since the last save)
+    if (mRevision != mSavedRevision) {
+      SExpression brdDoc(serializeToDomElement("librepcb_board"));  // can throw
+      mDirectory->write(getFilePath().getFilename(),
+                        brdDoc.toByteArray());  // can throw
+      mSavedRevision = mRevision;
+    }
 
     // save user settings
     SExpression usrDoc(mUserSettings->serializeToDomElement(
         "librepcb_board_user_settings"));                         // can throw
     mDirectory->write("settings.user.lp", usrDoc.toByteArray());  // can throw
+
+    // save plane fragments cache (only if some fragments were modified)
+    if (!mPlanes.isEmpty()) {
+      QByteArray cacheHash = calcPlanesCacheHash();
+      if (cacheHash != mSavedPlanesCacheHash) {
+        SExpression cacheDoc = serializePlanesCache();  // can throw
+        mDirectory->write(getPlanesCacheFilePath(),
+                          cacheDoc.toByteArray());  // can throw
+        mSavedPlanesCacheHash = cacheHash;
+      }
+    } else if (mDirectory->fileExists(getPlanesCacheFilePath())) {
+      mDirectory->removeFile(getPlanesCacheFilePath());  // can throw
+      mSavedPlanesCacheHash.clear();
+    }
   } else {
     mDirectory->removeDirRecursively();  // can throw
+    mSavedRevision = 0;  // board file needs to be written when re-added
+    mSavedPlanesCacheHash.clear();
   }
 }
 
@@ -918,6 +1167,15 @@ QVector<const AttributeProvider*> Board::getAttributeProviderParents() const
   return QVector<const AttributeProvider*>{&mProject};
 }
 
+/*******************************************************************************
+ *  Private Slots
+ ******************************************************************************/
+
+void Board::rebuildOutdatedPlanes() noexcept {
+  rebuildAllPlanes();
+  triggerAirWiresRebuild();  // planes are taken into account for airwires
+}
+
 /*******************************************************************************
  *  Private Methods
  ******************************************************************************/
@@ -926,6 +1184,21 @@ void Board::updateIcon() noexcept {
   mIcon = QIcon(mGraphicsScene->toPixmap(QSize(297, 210), Qt::white));
 }
 
+QList<BI_Base*> Board::getItemIndexCandidates(const Point& pos) const
+    noexcept {
+  // update the bounding rects of all modified items
+  foreach (BI_Base* item, mItemIndexQueue) {
+    qreal  margin = Length(1000).toPx();  // compensate rounding errors
+    QRectF rect   = item->getGrabAreaScenePx().boundingRect().adjusted(
+        -margin, -margin, margin, margin);
+    mItemIndex.insert(item, Point::fromPx(rect.topLeft()),
+                      Point::fromPx(rect.bottomRight()));
+  }
+  mItemIndexQueue.clear();
+  mItemIndexQueueSet.clear();
+  return mItemIndex.query(pos);
+}
+
 void Board::serialize(SExpression& root) const {
   root.appendChild(mUuid);
   root.appendChild("name", mName, true);
@@ -985,6 +1258,93 @@ void Board::updateErcMessages() noexcept {
   }
 }
 
+void Board::loadPlanesCache() noexcept {
+  if (!mDirectory->fileExists(getPlanesCacheFilePath())) {
+    return;
+  }
+  try {
+    SExpression root = mDirectory->readSExpression(getPlanesCacheFilePath());
+    if (root.getValueByPath<Version>("version") != qApp->getAppVersion()) {
+      return;  // fragments might be calculated differently by other versions
+    }
+    QHash<Uuid, BI_Plane*> planes;
+    foreach (BI_Plane* plane, mPlanes) {
+      planes.insert(plane->getUuid(), plane);
+    }
+    struct Entry {
+      BI_Plane*     plane;
+      QVector<Path> fragments;
+      QByteArray    inputHash;
+    };
+    QList<Entry> entries;
+    bool         obsoleteEntries = false;
+    foreach (const SExpression& node, root.getChildren("plane")) {
+      BI_Plane* plane = planes.value(node.getChildByIndex(0).getValue<Uuid>());
+      if (!plane) {
+        obsoleteEntries = true;  // plane does not exist anymore
+        continue;
+      }
+      QVector<Path> fragments;
+      foreach (const SExpression& child, node.getChildren("fragment")) {
+        fragments.append(Path(child));
+      }
+      QByteArray inputHash = QByteArray::fromHex(
+          node.getValueByPath<QString>("input_hash").toLatin1());
+      entries.append(Entry{plane, fragments, inputHash});
+    }
+    // The input hashes are verified by the next (non-forced) plane rebuild,
+    // i.e. only outdated planes are rebuilt.
+    foreach (const Entry& entry, entries) {
+      entry.plane->setFragments(entry.fragments, entry.inputHash);
+    }
+    // The file is only rewritten on save if the fragments were modified
+    // since now, or if it contains planes which do not exist anymore.
+    if (!obsoleteEntries) {
+      mSavedPlanesCacheHash = calcPlanesCacheHash();
+    }
+  } catch (const Exception& e) {
+    qWarning() << "Could not load planes cache, all planes will be rebuilt:"
+               << e.getMsg();
+  }
+}
+
+SExpression Board::serializePlanesCache() const {
+  SExpression root = SExpression::createList("librepcb_board_planes_cache");
+  root.appendChild("version", qApp->getAppVersion(), true);
+  QList<BI_Plane*> planes = mPlanes;
+  std::sort(planes.begin(), planes.end(),
+            [](const BI_Plane* p1, const BI_Plane* p2) {
+              return p1->getUuid() < p2->getUuid();
+            });  // sort by UUID to get a deterministic file content
+  foreach (const BI_Plane* plane, planes) {
+    SExpression& node = root.appendList("plane", true);
+    node.appendChild(plane->getUuid());
+    node.appendChild("input_hash",
+                     QString(plane->getFragmentsInputHash().toHex()), false);
+    foreach (const Path& fragment, plane->getFragments()) {
+      fragment.serialize(node.appendList("fragment", true));
+    }
+  }
+  return root;
+}
+
+QByteArray Board::calcPlanesCacheHash() const noexcept {
+  // The fragments are fully determined by the input hashes, so it's not
+  // needed to serialize the fragments to detect modifications.
+  QList<BI_Plane*> planes = mPlanes;
+  std::sort(planes.begin(), planes.end(),
+            [](const BI_Plane* p1, const BI_Plane* p2) {
+              return p1->getUuid() < p2->getUuid();
+            });
+  QCryptographicHash hash(QCryptographicHash::Sha256);
+  hash.addData(qApp->getAppVersion().toStr().toUtf8());
+  foreach (const BI_Plane* plane, planes) {
+    hash.addData(plane->getUuid().toStr().toUtf8());
+    hash.addData(plane->getFragmentsInputHash());
+  }
+  return hash.result();
+}
+
 /*******************************************************************************
  *  Static Methods
  ******************************************************************************/
@@ -32,6 +32,7 @@
 #include <librepcb/common/fileio/serializableobject.h>
 #include <librepcb/common/fileio/transactionaldirectory.h>
 #include <librepcb/common/units/all_length_units.h>
+#include <librepcb/common/utils/spatialindex.h>
 #include <librepcb/common/uuid.h>
 
 #include <QtCore>
@@ -66,6 +67,7 @@ class BI_StrokeText;
 class BI_Hole;
 class BI_Plane;
 class BI_AirWire;
+class BoardAirWiresBuilder;
 class BoardLayerStack;
 class BoardFabricationOutputSettings;
 class BoardUserSettings;
@@ -168,6 +170,15 @@ public:
   // Setters: General
   void setGridProperties(const GridProperties& grid) noexcept;
 
+  /**
+   * @brief Mark the board file as modified
+   *
+   * Must be called by every operation which modifies the content of the
+   * board file. Only boards with a modified revision are serialized again
+   * by #save().
+   */
+  void incrementRevision() noexcept { ++mRevision; }
+
   // Getters: Attributes
   const Uuid&        getUuid() const noexcept { return mUuid; }
   const ElementName& getName() const noexcept { return mName; }
@@ -196,7 +207,21 @@ public:
   const QList<BI_Plane*>& getPlanes() const noexcept { return mPlanes; }
   void                    addPlane(BI_Plane& plane);
   void                    removePlane(BI_Plane& plane);
-  void                    rebuildAllPlanes() noexcept;
+
+  /**
+   * @brief Rebuild the fragments of all planes
+   *
+   * When a board is loaded, the fragments are restored from the planes cache
+   * file (if valid) and outdated planes are rebuilt later in the event loop.
+   * Thus code which needs up-to-date fragments without running an event loop
+   * (e.g. exports on the command line) has to call this method first. This is
+   * cheap if the cache was valid since only planes with modified inputs are
+   * rebuilt.
+   *
+   * @param force   If true, all planes are rebuilt even if their inputs were
+   *                not modified.
+   */
+  void rebuildAllPlanes(bool force = false) noexcept;
 
   // Polygon Methods
   const QList<BI_Polygon*>& getPolygons() const noexcept { return mPolygons; }
@@ -219,9 +244,40 @@ public:
   void scheduleAirWiresRebuild(NetSignal* netsignal) noexcept {
     mScheduledNetSignalsForAirWireRebuild.insert(netsignal);
   }
+
+  /**
+   * @brief Rebuild the airwires of all scheduled net signals
+   *
+   * The airwires are calculated asynchronously in a worker thread and added
+   * to the board as soon as the calculation is finished. Results which are
+   * already outdated when they arrive (because the net signal was modified
+   * in the meantime) are dropped.
+   */
   void triggerAirWiresRebuild() noexcept;
   void forceAirWiresRebuild() noexcept;
 
+  /**
+   * @brief Check whether airwires are being calculated in the worker thread
+   *
+   * @retval true   If there are calculations whose results were not yet
+   *                applied (they are applied from the event loop)
+   * @retval false  If all triggered rebuilds are finished
+   */
+  bool isAirWiresRebuildInProgress() const noexcept;
+
+  // Spatial Index Methods
+
+  /**
+   * @brief Notify the board that the grab area of an item has changed
+   *
+   * Must be called by items whenever they are added to or removed from the
+   * board, or their grab area was moved or resized. The spatial index used by
+   * the *AtScenePos() methods is then updated on the next lookup.
+   *
+   * @param item    The modified item.
+   */
+  void scheduleItemIndexUpdate(BI_Base& item) noexcept;
+
   // General Methods
   void addToProject();
   void removeFromProject();
@@ -251,6 +307,19 @@ public:
                        std::unique_ptr<TransactionalDirectory> directory,
                        const ElementName&                      name);
 
+  /**
+   * @brief Get the path of the planes cache file within the board directory
+   *
+   * The cache is located in a dot-directory, so it is neither exported to
+   * *.lppz archives nor tracked by version control systems (see the
+   * .gitignore template of projects).
+   *
+   * @return Relative file path
+   */
+  static QString getPlanesCacheFilePath() noexcept {
+    return ".cache/planes.lp";
+  }
+
 signals:
 
   /// @copydoc AttributeProvider::attributesChanged()
@@ -259,11 +328,25 @@ signals:
   void deviceAdded(BI_Device& comp);
   void deviceRemoved(BI_Device& comp);
 
+private slots:
+  void rebuildOutdatedPlanes() noexcept;
+
+private:  // Types
+  struct AirWiresJob;
+
 private:
   Board(Project& project, std::unique_ptr<TransactionalDirectory> directory,
         bool create, const QString& newName);
   void updateIcon() noexcept;
   void updateErcMessages() noexcept;
+  QList<BI_Base*> getItemIndexCandidates(const Point& pos) const noexcept;
+  void            startAirWiresJobs() noexcept;
+  void            airWiresJobsFinished() noexcept;
+  void            updateAirWires(NetSignal*                          netsignal,
+                                 const QVector<QPair<Point, Point>>& airwires);
+  void            loadPlanesCache() noexcept;
+  SExpression     serializePlanesCache() const;
+  QByteArray      calcPlanesCacheHash() const noexcept;
 
   /// @copydoc librepcb::SerializableObject::serialize()
   void serialize(SExpression& root) const override;
@@ -272,6 +355,10 @@ private:
   Project& mProject;  ///< A reference to the Project object (from the ctor)
   std::unique_ptr<TransactionalDirectory> mDirectory;
   bool                                    mIsAddedToProject;
+  quint64 mRevision;       ///< Incremented on every modification
+  quint64 mSavedRevision;  ///< Revision of the last written board file
+  /// Hash of the planes in the cache file (see #calcPlanesCacheHash())
+  QByteArray mSavedPlanesCacheHash;
 
   QScopedPointer<GraphicsScene>                  mGraphicsScene;
   QScopedPointer<BoardLayerStack>                mLayerStack;
@@ -282,6 +369,11 @@ private:
   QRectF                                         mViewRect;
   QSet<NetSignal*> mScheduledNetSignalsForAirWireRebuild;
 
+  // Spatial index of all selectable items (updated lazily on lookups)
+  mutable SpatialIndex<BI_Base*> mItemIndex;
+  mutable QList<BI_Base*>        mItemIndexQueue;  ///< Ordered like added
+  mutable QSet<BI_Base*>         mItemIndexQueueSet;
+
   // Attributes
   Uuid        mUuid;
   ElementName mName;
@@ -297,6 +389,12 @@ private:
   QList<BI_Hole*>                     mHoles;
   QMultiHash<NetSignal*, BI_AirWire*> mAirWires;
 
+  // Airwire calculation (see triggerAirWiresRebuild())
+  QHash<NetSignal*, std::shared_ptr<BoardAirWiresBuilder>> mAirWiresBuilders;
+  QHash<NetSignal*, std::shared_ptr<AirWiresJob>>          mPendingAirWiresJobs;
+  QList<std::shared_ptr<AirWiresJob>>                      mRunningAirWiresJobs;
+  QFutureWatcher<void>                                     mAirWiresJobsWatcher;
+
   // ERC messages
   QHash<Uuid, ErcMsg*> mErcMsgListUnplacedComponentInstances;
 };
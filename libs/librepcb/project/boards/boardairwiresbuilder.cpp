@@ -37,122 +37,24 @@
 #include <delaunay-triangulation/delaunay.h>
 #include <librepcb/common/graphics/graphicslayer.h>
 #include <librepcb/library/pkg/footprintpad.h>
-#include <unordered_map>
 
 #include <QtCore>
 
+#include <numeric>
+
 /*******************************************************************************
  *  Namespace
  ******************************************************************************/
 namespace librepcb {
 namespace project {
 
-// adapted from horizon/kicad
-static QVector<QPair<Point, Point>> kruskalMst(
-    std::vector<delaunay::Edge<qreal>>&    aEdges,
-    std::vector<delaunay::Vector2<qreal>>& aNodes) noexcept {
-  unsigned int nodeNumber      = aNodes.size();
-  unsigned int mstExpectedSize = nodeNumber - 1;
-  unsigned int mstSize         = 0;
-  bool         ratsnestLines   = false;
-
-  // printf("mst nodes : %d edges : %d\n", aNodes.size(), aEdges.size () );
-  // The output
-  QVector<QPair<Point, Point>> mst;
-
-  // Set tags for marking cycles
-  std::unordered_map<int, int> tags;
-  unsigned int                 tag = 0;
-
-  for (auto& node : aNodes) {
-    node.tag      = tag;
-    tags[node.id] = tag++;
-  }
-
-  // Lists of nodes connected together (subtrees) to detect cycles in the
-  // graph
-  std::vector<std::list<int>> cycles(nodeNumber);
-
-  for (unsigned int i = 0; i < nodeNumber; ++i) cycles[i].push_back(i);
-
-  // Kruskal algorithm requires edges to be sorted by their weight
-  std::sort(aEdges.begin(), aEdges.end(),
-            [](const delaunay::Edge<qreal>& a, const delaunay::Edge<qreal>& b) {
-              return a.weight > b.weight;
-            });
-
-  while (mstSize < mstExpectedSize && !aEdges.empty()) {
-    auto& dt = aEdges.back();
-
-    int srcTag = tags[dt.p1.id];
-    int trgTag = tags[dt.p2.id];
-    // printf("mstSize %d %d %f %d<>%d\n", mstSize, mstExpectedSize,
-    // dt.weight, srcTag, trgTag);
-
-    // Check if by adding this edge we are going to join two different
-    // forests
-    if (srcTag != trgTag) {
-      // Because edges are sorted by their weight, first we always process
-      // connected
-      // items (weight == 0). Once we stumble upon an edge with non-zero
-      // weight,
-      // it means that the rest of the lines are ratsnest.
-      if (!ratsnestLines && dt.weight >= 0) ratsnestLines = true;
-
-      // Update tags
-      if (ratsnestLines) {
-        for (auto it = cycles[trgTag].begin(); it != cycles[trgTag].end();
-             ++it) {
-          tags[aNodes[*it].id] = srcTag;
-        }
-
-        // Do a copy of edge, but make it RN_EDGE_MST. In contrary to
-        // RN_EDGE,
-        // RN_EDGE_MST saves both source and target node and does not
-        // require any other
-        // edges to exist for getting source/target nodes
-        // CN_EDGE newEdge ( dt.GetSourceNode(), dt.GetTargetNode(),
-        // dt.GetWeight() );
-
-        // assert( newEdge.GetSourceNode()->GetTag() !=
-        // newEdge.GetTargetNode()->GetTag() );
-        // assert(dt.p1.tag != dt.p2.tag);
-        mst.append(qMakePair(Point(dt.p1.x, dt.p1.y), Point(dt.p2.x, dt.p2.y)));
-        ++mstSize;
-      } else {
-        // for( it = cycles[trgTag].begin(), itEnd =
-        // cycles[trgTag].end(); it != itEnd; ++it )
-        // for( auto it : cycles[trgTag] )
-        for (auto it = cycles[trgTag].begin(); it != cycles[trgTag].end();
-             ++it) {
-          tags[aNodes[*it].id] = srcTag;
-          aNodes[*it].tag      = srcTag;
-        }
-
-        // Processing a connection, decrease the expected size of the
-        // ratsnest MST
-        --mstExpectedSize;
-      }
-
-      // Move nodes that were marked with old tag to the list marked with
-      // the new tag
-      cycles[srcTag].splice(cycles[srcTag].end(), cycles[trgTag]);
-    }
-
-    // Remove the edge that was just processed
-    aEdges.pop_back();
-  }
-
-  return mst;
-}
-
 /*******************************************************************************
  *  Constructors / Destructor
  ******************************************************************************/
 
 BoardAirWiresBuilder::BoardAirWiresBuilder(const Board&     board,
                                            const NetSignal& netsignal) noexcept
-  : mBoard(board), mNetSignal(netsignal) {
+  : mBoard(board), mNetSignal(netsignal), mStaticForestValid(false) {
 }
 
 BoardAirWiresBuilder::~BoardAirWiresBuilder() noexcept {
@@ -162,26 +64,23 @@ BoardAirWiresBuilder::~BoardAirWiresBuilder() noexcept {
  *  General Methods
  ******************************************************************************/
 
-QVector<QPair<Point, Point>> BoardAirWiresBuilder::buildAirWires() const {
-  std::vector<delaunay::Vector2<qreal>> points;
-  QHash<const BI_NetLineAnchor*, int>   anchorMap;
-  QHash<int, QString>                   layerMap;
-  std::vector<delaunay::Edge<qreal>>    edges;
+BoardAirWiresBuilder::Snapshot BoardAirWiresBuilder::takeSnapshot() const
+    noexcept {
+  Snapshot                            snapshot;
+  QHash<const BI_NetLineAnchor*, int> anchorMap;
 
   // pads
   foreach (ComponentSignalInstance* cmpSig, mNetSignal.getComponentSignals()) {
     Q_ASSERT(cmpSig);
     foreach (BI_FootprintPad* pad, cmpSig->getRegisteredFootprintPads()) {
       if (&pad->getBoard() != &mBoard) continue;
-      int   id  = points.size();
-      Point pos = pad->getPosition();
-      points.emplace_back(pos.getX().toNm(), pos.getY().toNm(), id);
-      anchorMap[pad] = id;
+      anchorMap[pad] = snapshot.anchors.count();
       if (pad->getLibPad().getBoardSide() ==
           library::FootprintPad::BoardSide::THT) {
-        layerMap[id] = QString();  // on all layers
+        snapshot.anchors.append(Anchor{pad, pad->getPosition(), QString()});
       } else {
-        layerMap[id] = pad->getLayerName();
+        snapshot.anchors.append(
+            Anchor{pad, pad->getPosition(), pad->getLayerName()});
       }
     }
   }
@@ -192,71 +91,293 @@ QVector<QPair<Point, Point>> BoardAirWiresBuilder::buildAirWires() const {
     if (&netsegment->getBoard() != &mBoard) continue;
     foreach (const BI_Via* via, netsegment->getVias()) {
       Q_ASSERT(via);
-      int   id  = points.size();
-      Point pos = via->getPosition();
-      points.emplace_back(pos.getX().toNm(), pos.getY().toNm(), id);
-      anchorMap[via] = id;
-      layerMap[id]   = QString();  // on all layers
+      anchorMap[via] = snapshot.anchors.count();
+      snapshot.anchors.append(Anchor{via, via->getPosition(), QString()});
     }
     foreach (const BI_NetPoint* netpoint, netsegment->getNetPoints()) {
       Q_ASSERT(netpoint);
       if (const GraphicsLayer* layer = netpoint->getLayerOfLines()) {
-        int   id  = points.size();
-        Point pos = netpoint->getPosition();
-        points.emplace_back(pos.getX().toNm(), pos.getY().toNm(), id);
-        anchorMap[netpoint] = id;
-        layerMap[id]        = layer->getName();
+        anchorMap[netpoint] = snapshot.anchors.count();
+        snapshot.anchors.append(
+            Anchor{netpoint, netpoint->getPosition(), layer->getName()});
       }
     }
     foreach (const BI_NetLine* netline, netsegment->getNetLines()) {
       Q_ASSERT(netline);
       Q_ASSERT(anchorMap.contains(&netline->getStartPoint()));
       Q_ASSERT(anchorMap.contains(&netline->getEndPoint()));
-      edges.emplace_back(points[anchorMap[&netline->getStartPoint()]],
-                         points[anchorMap[&netline->getEndPoint()]], -1);
+      snapshot.connections.append(
+          qMakePair(anchorMap.value(&netline->getStartPoint()),
+                    anchorMap.value(&netline->getEndPoint())));
     }
   }
 
-  // determine connections made by planes
+  // planes
   foreach (const BI_Plane* plane, mNetSignal.getBoardPlanes()) {
     Q_ASSERT(plane);
     if (&plane->getBoard() != &mBoard) continue;
-    foreach (const Path& fragment, plane->getFragments()) {
-      int lastId = -1;
-      for (const auto& point : points) {
-        QString pointLayer = layerMap[point.id];
-        if (pointLayer.isNull() || (pointLayer == plane->getLayerName())) {
-          Point p(point.x, point.y);
-          if (fragment.toQPainterPathPx().contains(p.toPxQPointF())) {
-            if (lastId >= 0) {
-              edges.emplace_back(points[lastId], points[point.id], -1);
-            }
-            lastId = point.id;
-          }
+    snapshot.planes.append(
+        Plane{*plane->getLayerName(), plane->getFragments(), {}});
+  }
+  return snapshot;
+}
+
+QVector<QPair<Point, Point>> BoardAirWiresBuilder::buildAirWires(
+    const Snapshot& snapshot) noexcept {
+  // determine anchors which were moved since the last calculation
+  QVector<int> movedAnchors;
+  if (hasSameItems(snapshot)) {
+    for (int i = 0; i < snapshot.anchors.count(); ++i) {
+      const Point& position = snapshot.anchors.at(i).position;
+      if (position != mAnchors.at(i).position) {
+        movedAnchors.append(i);
+        mAnchors[i].position = position;
+        mAnchorPlaneFragments[i] =
+            getPlaneFragmentsAtAnchor(mAnchors.at(i), mPlanes);
+      }
+    }
+  } else {
+    mAnchors     = snapshot.anchors;
+    mConnections = snapshot.connections;
+    mPlanes      = snapshot.planes;
+    for (Plane& plane : mPlanes) {
+      plane.fragmentPaths.clear();
+      foreach (const Path& fragment, plane.fragments) {
+        // Note: The painter path cache of the fragment must not be used
+        // since the fragment may be shared with the plane in another thread.
+        plane.fragmentPaths.append(
+            Path(fragment.getVertices()).toQPainterPathPx());
+      }
+    }
+    mAnchorPlaneFragments.clear();
+    foreach (const Anchor& anchor, mAnchors) {
+      mAnchorPlaneFragments.append(getPlaneFragmentsAtAnchor(anchor, mPlanes));
+    }
+    mStaticForestValid = false;
+  }
+
+  // determine groups of connected anchors
+  QVector<int> clusters = calcClusters();
+  if (clusters != mClusters) {
+    mClusters          = clusters;
+    mStaticForestValid = false;
+  }
+
+  // determine all anchors of the groups which contain moved anchors
+  QSet<int> movedClusters;
+  foreach (int i, movedAnchors) { movedClusters.insert(mClusters.at(i)); }
+  QVector<int> movedClusterAnchors;
+  for (int i = 0; i < mClusters.count(); ++i) {
+    if (movedClusters.contains(mClusters.at(i))) {
+      movedClusterAnchors.append(i);
+    }
+  }
+  if ((!mStaticForestValid) ||
+      (movedClusterAnchors.count() > sMaxMovedAnchors)) {
+    // connectivity has changed or too many anchors were moved, so calculate
+    // the whole spanning tree from scratch
+    movedClusters.clear();
+    movedClusterAnchors.clear();
+  }
+
+  // calculate the spanning forest between all unmoved groups, which doesn't
+  // change as long as the same groups are moved (e.g. while dragging)
+  if ((!mStaticForestValid) || (movedClusters != mMovedClusters)) {
+    mStaticForest      = calcMinimumSpanningForest(movedClusters);
+    mMovedClusters     = movedClusters;
+    mStaticForestValid = true;
+  }
+
+  // The minimum spanning tree only contains edges of the cached forest and
+  // edges connected to the moved groups, because every other edge between
+  // unmoved groups is the longest edge of a cycle in the cached forest. So
+  // only the shortest connection between every moved group and each other
+  // group needs to be determined.
+  QVector<Edge>                edges = mStaticForest;
+  QHash<QPair<int, int>, Edge> nearestEdges;
+  foreach (int i, movedClusterAnchors) {
+    for (int k = 0; k < mAnchors.count(); ++k) {
+      int c1 = mClusters.at(i);
+      int c2 = mClusters.at(k);
+      if ((c1 == c2) || (movedClusters.contains(c2) && (k < i))) {
+        continue;  // same group, or this pair was already handled
+      }
+      Edge            edge = makeEdge(i, k);
+      QPair<int, int> key(qMin(c1, c2), qMax(c1, c2));
+      auto            it = nearestEdges.find(key);
+      if ((it == nearestEdges.end()) || (edge.weight < it->weight)) {
+        nearestEdges.insert(key, edge);
+      }
+    }
+  }
+  foreach (const Edge& edge, nearestEdges) { edges.append(edge); }
+
+  // find airwires in list of edges
+  QVector<QPair<Point, Point>> airwires;
+  foreach (const Edge& edge, kruskal(edges)) {
+    airwires.append(qMakePair(mAnchors.at(edge.anchor1).position,
+                              mAnchors.at(edge.anchor2).position));
+  }
+  return airwires;
+}
+
+/*******************************************************************************
+ *  Private Methods
+ ******************************************************************************/
+
+bool BoardAirWiresBuilder::hasSameItems(const Snapshot& snapshot) const
+    noexcept {
+  const QVector<Anchor>& anchors = snapshot.anchors;
+  const QVector<Plane>&  planes  = snapshot.planes;
+  if ((anchors.count() != mAnchors.count()) ||
+      (snapshot.connections != mConnections) ||
+      (planes.count() != mPlanes.count())) {
+    return false;
+  }
+  for (int i = 0; i < anchors.count(); ++i) {
+    if ((anchors.at(i).item != mAnchors.at(i).item) ||
+        (anchors.at(i).layer != mAnchors.at(i).layer)) {
+      return false;
+    }
+  }
+  for (int i = 0; i < planes.count(); ++i) {
+    // Note: Comparing the fragments is cheap since they are implicitly shared
+    // with the plane as long as they were not modified.
+    if ((planes.at(i).layer != mPlanes.at(i).layer) ||
+        (planes.at(i).fragments != mPlanes.at(i).fragments)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+QVector<int> BoardAirWiresBuilder::getPlaneFragmentsAtAnchor(
+    const Anchor& anchor, const QVector<Plane>& planes) const noexcept {
+  QVector<int> fragments;
+  QPointF      posPx = anchor.position.toPxQPointF();
+  int          index = 0;
+  foreach (const Plane& plane, planes) {
+    if (anchor.layer.isNull() || (anchor.layer == plane.layer)) {
+      for (int i = 0; i < plane.fragmentPaths.count(); ++i) {
+        if (plane.fragmentPaths.at(i).contains(posPx)) {
+          fragments.append(index + i);
         }
       }
     }
+    index += plane.fragmentPaths.count();
   }
+  return fragments;
+}
 
-  // remember how many edges are already known as connected
-  uint connectedEdges = edges.size();
+QVector<int> BoardAirWiresBuilder::calcClusters() const noexcept {
+  // union-find over all anchors and plane fragments
+  int fragmentCount = 0;
+  foreach (const Plane& plane, mPlanes) {
+    fragmentCount += plane.fragmentPaths.count();
+  }
+  QVector<int> parents(mAnchors.count() + fragmentCount);
+  std::iota(parents.begin(), parents.end(), 0);
+  foreach (const auto& connection, mConnections) {
+    parents[findRoot(parents, connection.first)] =
+        findRoot(parents, connection.second);
+  }
+  for (int i = 0; i < mAnchors.count(); ++i) {
+    foreach (int fragment, mAnchorPlaneFragments.at(i)) {
+      parents[findRoot(parents, i)] =
+          findRoot(parents, mAnchors.count() + fragment);
+    }
+  }
 
-  // determine additional edges between found points (candidates for airwires)
+  // number the groups in the order of their first anchor
+  QVector<int>    clusters(mAnchors.count());
+  QHash<int, int> clusterOfRoot;
+  for (int i = 0; i < mAnchors.count(); ++i) {
+    int root = findRoot(parents, i);
+    if (!clusterOfRoot.contains(root)) {
+      clusterOfRoot.insert(root, clusterOfRoot.count());
+    }
+    clusters[i] = clusterOfRoot.value(root);
+  }
+  return clusters;
+}
+
+QVector<BoardAirWiresBuilder::Edge>
+    BoardAirWiresBuilder::calcMinimumSpanningForest(
+        const QSet<int>& excludedClusters) const noexcept {
+  std::vector<delaunay::Vector2<qreal>> points;
+  QVector<int>                          pointAnchors;
+  for (int i = 0; i < mAnchors.count(); ++i) {
+    if (!excludedClusters.contains(mClusters.at(i))) {
+      const Point& pos = mAnchors.at(i).position;
+      points.emplace_back(pos.getX().toNm(), pos.getY().toNm(), points.size());
+      pointAnchors.append(i);
+    }
+  }
+
+  // determine edges between found points (candidates for airwires)
+  QVector<Edge> edges;
   if (points.size() >= 3) {  // minimum 3 points needed for triangulation
     delaunay::Delaunay<qreal> del;
     del.triangulate(points);
-    edges.insert(edges.end(), del.getEdges().begin(), del.getEdges().end());
+    for (const auto& edge : del.getEdges()) {
+      int anchor1 = pointAnchors.at(edge.p1.id);
+      int anchor2 = pointAnchors.at(edge.p2.id);
+      if (mClusters.at(anchor1) != mClusters.at(anchor2)) {
+        edges.append(makeEdge(anchor1, anchor2));
+      }
+    }
   } else if (points.size() == 2) {
-    edges.emplace_back(points[0], points[1], -1);
+    if (mClusters.at(pointAnchors.at(0)) != mClusters.at(pointAnchors.at(1))) {
+      edges.append(makeEdge(pointAnchors.at(0), pointAnchors.at(1)));
+    }
   }
+  return kruskal(edges);
+}
 
-  // determine weights of these new edges
-  for (uint i = connectedEdges; i < edges.size(); ++i) {
-    edges[i].weight = edges[i].p1.dist2(edges[i].p2);
+QVector<BoardAirWiresBuilder::Edge> BoardAirWiresBuilder::kruskal(
+    QVector<Edge> edges) const noexcept {
+  // sort by weight, and by anchors to get a deterministic result
+  std::sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) {
+    if (a.weight != b.weight) return a.weight < b.weight;
+    if (a.anchor1 != b.anchor1) return a.anchor1 < b.anchor1;
+    return a.anchor2 < b.anchor2;
+  });
+
+  int clusterCount = 0;
+  foreach (int cluster, mClusters) {
+    clusterCount = qMax(clusterCount, cluster + 1);
   }
+  QVector<int> parents(clusterCount);
+  std::iota(parents.begin(), parents.end(), 0);
+  QVector<Edge> tree;
+  foreach (const Edge& edge, edges) {
+    int root1 = findRoot(parents, mClusters.at(edge.anchor1));
+    int root2 = findRoot(parents, mClusters.at(edge.anchor2));
+    if (root1 != root2) {
+      parents[root2] = root1;
+      tree.append(edge);
+    }
+  }
+  return tree;
+}
 
-  // find airwires in list of edges
-  return kruskalMst(edges, points);
+BoardAirWiresBuilder::Edge BoardAirWiresBuilder::makeEdge(int anchor1,
+                                                          int anchor2) const
+    noexcept {
+  const Point& p1 = mAnchors.at(anchor1).position;
+  const Point& p2 = mAnchors.at(anchor2).position;
+  qreal        dx = (p1.getX() - p2.getX()).toNm();
+  qreal        dy = (p1.getY() - p2.getY()).toNm();
+  return Edge{qMin(anchor1, anchor2), qMax(anchor1, anchor2),
+              dx * dx + dy * dy};
+}
+
+int BoardAirWiresBuilder::findRoot(QVector<int>& parents, int i) noexcept {
+  while (parents.at(i) != i) {
+    parents[i] = parents.at(parents.at(i));  // path halving
+    i          = parents.at(i);
+  }
+  return i;
 }
 
 /*******************************************************************************
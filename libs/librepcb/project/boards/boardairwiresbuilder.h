@@ -23,9 +23,11 @@
 /*******************************************************************************
  *  Includes
  ******************************************************************************/
+#include <librepcb/common/geometry/path.h>
 #include <librepcb/common/units/point.h>
 
 #include <QtCore>
+#include <QtGui>
 
 /*******************************************************************************
  *  Namespace / Forward Declarations
@@ -35,6 +37,7 @@ namespace project {
 
 class NetSignal;
 class Board;
+class BI_NetLineAnchor;
 
 /*******************************************************************************
  *  Class BoardAirWiresBuilder
@@ -42,6 +45,23 @@ class Board;
 
 /**
  * @brief The BoardAirWiresBuilder class
+ *
+ * Calculates the airwires of a net signal as a minimum spanning tree between
+ * all groups of connected anchors (pads, vias and netpoints). The groups are
+ * determined with a union-find over traces and plane fragments.
+ *
+ * The builder keeps the state of the last calculation, so it should be kept
+ * alive between calls of #buildAirWires() for the same net signal. If only
+ * the positions of a few anchors have changed since the last call (e.g. while
+ * dragging a footprint), the spanning forest between all unmoved groups is
+ * taken from the cache and only the airwires of the moved groups are
+ * calculated again, which is linear in the number of anchors instead of a
+ * complete Delaunay triangulation.
+ *
+ * To allow calculating the airwires in a worker thread, the board items are
+ * copied into a #Snapshot with #takeSnapshot() (must be called in the thread
+ * of the board), which can then be passed to #buildAirWires(const Snapshot&)
+ * in any thread. Only one thread may use a builder at the same time.
  */
 class BoardAirWiresBuilder final {
 public:
@@ -51,15 +71,68 @@ public:
   BoardAirWiresBuilder(const Board& board, const NetSignal& netsignal) noexcept;
   ~BoardAirWiresBuilder() noexcept;
 
+  // Types
+  struct Anchor {
+    const BI_NetLineAnchor* item;      ///< Only compared, never dereferenced
+    Point                   position;  ///< Position of the anchor
+    QString                 layer;  ///< Null if the anchor is on all layers
+  };
+  struct Plane {
+    QString               layer;
+    QVector<Path>         fragments;
+    QVector<QPainterPath> fragmentPaths;  ///< Same as fragments, but in px
+  };
+  struct Snapshot {
+    QVector<Anchor>          anchors;
+    QVector<QPair<int, int>> connections;  ///< Anchors connected by traces
+    QVector<Plane>           planes;
+  };
+
   // General Methods
-  QVector<QPair<Point, Point>> buildAirWires() const;
+  Snapshot                     takeSnapshot() const noexcept;
+  QVector<QPair<Point, Point>> buildAirWires(const Snapshot& snapshot) noexcept;
+  QVector<QPair<Point, Point>> buildAirWires() noexcept {
+    return buildAirWires(takeSnapshot());
+  }
 
   // Operator Overloadings
   BoardAirWiresBuilder& operator=(const BoardAirWiresBuilder& rhs) = delete;
 
+private:  // Types
+  struct Edge {
+    int   anchor1;
+    int   anchor2;
+    qreal weight;
+  };
+
+private:  // Methods
+  bool          hasSameItems(const Snapshot& snapshot) const noexcept;
+  QVector<int>  getPlaneFragmentsAtAnchor(const Anchor&         anchor,
+                                          const QVector<Plane>& planes) const
+      noexcept;
+  QVector<int>  calcClusters() const noexcept;
+  QVector<Edge> calcMinimumSpanningForest(
+      const QSet<int>& excludedClusters) const noexcept;
+  QVector<Edge> kruskal(QVector<Edge> edges) const noexcept;
+  Edge          makeEdge(int anchor1, int anchor2) const noexcept;
+  static int    findRoot(QVector<int>& parents, int i) noexcept;
+
 private:  // Data
   const Board&     mBoard;
   const NetSignal& mNetSignal;
+
+  // State of the last calculation
+  QVector<Anchor>           mAnchors;
+  QVector<QPair<int, int>>  mConnections;
+  QVector<Plane>            mPlanes;
+  QVector<QVector<int>>     mAnchorPlaneFragments;  ///< Indices per anchor
+  QVector<int>              mClusters;  ///< Group of connected anchors
+  QSet<int>                 mMovedClusters;
+  QVector<Edge>             mStaticForest;  ///< Forest without moved groups
+  bool                      mStaticForestValid;
+
+  /// Max. number of moved anchors to use the incremental algorithm
+  static const int sMaxMovedAnchors = 256;
 };
 
 /*******************************************************************************
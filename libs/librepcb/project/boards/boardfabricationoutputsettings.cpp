@@ -56,6 +56,7 @@ BoardFabricationOutputSettings::BoardFabricationOutputSettings() noexcept
     mSilkscreenLayersBot(
         {GraphicsLayer::sBotPlacement, GraphicsLayer::sBotNames}),
     mMergeDrillFiles(false),
+    mOptimizeDrillOrder(false),
     mEnableSolderPasteTop(false),
     mEnableSolderPasteBot(false) {
 }
@@ -88,6 +89,10 @@ BoardFabricationOutputSettings::BoardFabricationOutputSettings(
   mSuffixDrillsNpth     = node.getValueByPath<QString>("drills/suffix_npth");
   mSuffixDrills         = node.getValueByPath<QString>("drills/suffix_merged");
   mMergeDrillFiles      = node.getValueByPath<bool>("drills/merge");
+  if (const SExpression* child = node.tryGetChildByPath("drills/optimize")) {
+    // optional to keep the drill order of projects created without this flag
+    mOptimizeDrillOrder = child->getValueOfFirstChild<bool>();
+  }
   mEnableSolderPasteTop = node.getValueByPath<bool>("solderpaste_top/create");
   mEnableSolderPasteBot = node.getValueByPath<bool>("solderpaste_bot/create");
 
@@ -142,6 +147,7 @@ void BoardFabricationOutputSettings::serialize(SExpression& root) const {
 
   SExpression& drills = root.appendList("drills", true);
   drills.appendChild("merge", mMergeDrillFiles, false);
+  drills.appendChild("optimize", mOptimizeDrillOrder, false);
   drills.appendChild("suffix_pth", mSuffixDrillsPth, true);
   drills.appendChild("suffix_npth", mSuffixDrillsNpth, true);
   drills.appendChild("suffix_merged", mSuffixDrills, true);
@@ -178,6 +184,7 @@ BoardFabricationOutputSettings& BoardFabricationOutputSettings::operator=(
   mSilkscreenLayersTop  = rhs.mSilkscreenLayersTop;
   mSilkscreenLayersBot  = rhs.mSilkscreenLayersBot;
   mMergeDrillFiles      = rhs.mMergeDrillFiles;
+  mOptimizeDrillOrder   = rhs.mOptimizeDrillOrder;
   mEnableSolderPasteTop = rhs.mEnableSolderPasteTop;
   mEnableSolderPasteBot = rhs.mEnableSolderPasteBot;
   return *this;
@@ -202,6 +209,7 @@ bool BoardFabricationOutputSettings::operator==(
   if (mSilkscreenLayersTop != rhs.mSilkscreenLayersTop) return false;
   if (mSilkscreenLayersBot != rhs.mSilkscreenLayersBot) return false;
   if (mMergeDrillFiles != rhs.mMergeDrillFiles) return false;
+  if (mOptimizeDrillOrder != rhs.mOptimizeDrillOrder) return false;
   if (mEnableSolderPasteTop != rhs.mEnableSolderPasteTop) return false;
   if (mEnableSolderPasteBot != rhs.mEnableSolderPasteBot) return false;
   return true;
@@ -93,6 +93,7 @@ public:
     return mSilkscreenLayersBot;
   }
   bool getMergeDrillFiles() const noexcept { return mMergeDrillFiles; }
+  bool getOptimizeDrillOrder() const noexcept { return mOptimizeDrillOrder; }
   bool getEnableSolderPasteTop() const noexcept {
     return mEnableSolderPasteTop;
   }
@@ -136,6 +137,7 @@ public:
     mSilkscreenLayersBot = l;
   }
   void setMergeDrillFiles(bool m) noexcept { mMergeDrillFiles = m; }
+  void setOptimizeDrillOrder(bool o) noexcept { mOptimizeDrillOrder = o; }
   void setEnableSolderPasteTop(bool e) noexcept { mEnableSolderPasteTop = e; }
   void setEnableSolderPasteBot(bool e) noexcept { mEnableSolderPasteBot = e; }
 
@@ -168,6 +170,7 @@ private:  // Data
   QStringList mSilkscreenLayersTop;
   QStringList mSilkscreenLayersBot;
   bool        mMergeDrillFiles;
+  bool        mOptimizeDrillOrder;
   bool        mEnableSolderPasteTop;
   bool        mEnableSolderPasteBot;
 };
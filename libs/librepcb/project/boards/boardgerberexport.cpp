@@ -48,6 +48,7 @@
 #include <librepcb/library/pkg/footprint.h>
 #include <librepcb/library/pkg/footprintpad.h>
 
+#include <QtConcurrent/QtConcurrent>
 #include <QtCore>
 
 /*******************************************************************************
@@ -56,6 +57,41 @@
 namespace librepcb {
 namespace project {
 
+/*******************************************************************************
+ *  Class OutputFileAttributeProvider
+ ******************************************************************************/
+
+/**
+ * @brief Provides the attributes which are specific to a single output file
+ *
+ * Used instead of a member of BoardGerberExport to allow generating several
+ * output files in parallel.
+ */
+class OutputFileAttributeProvider final : public AttributeProvider {
+public:
+  OutputFileAttributeProvider(const AttributeProvider& parent,
+                              int innerCopperLayer) noexcept
+    : mParent(parent), mInnerCopperLayer(innerCopperLayer) {}
+
+  QString getBuiltInAttributeValue(const QString& key) const
+      noexcept override {
+    if ((key == QLatin1String("CU_LAYER")) && (mInnerCopperLayer > 0)) {
+      return QString::number(mInnerCopperLayer);
+    } else {
+      return QString();
+    }
+  }
+  QVector<const AttributeProvider*> getAttributeProviderParents() const
+      noexcept override {
+    return QVector<const AttributeProvider*>{&mParent};
+  }
+  void attributesChanged() override {}
+
+private:
+  const AttributeProvider& mParent;
+  int                      mInnerCopperLayer;
+};
+
 /*******************************************************************************
  *  Constructors / Destructor
  ******************************************************************************/
@@ -64,8 +100,7 @@ BoardGerberExport::BoardGerberExport(
     const Board& board, const BoardFabricationOutputSettings& settings) noexcept
   : mProject(board.getProject()),
     mBoard(board),
-    mSettings(new BoardFabricationOutputSettings(settings)),
-    mCurrentInnerCopperLayer(0) {
+    mSettings(new BoardFabricationOutputSettings(settings)) {
 }
 
 BoardGerberExport::~BoardGerberExport() noexcept {
@@ -85,26 +120,56 @@ FilePath BoardGerberExport::getOutputDirectory() const noexcept {
 
 void BoardGerberExport::exportAllLayers() const {
   mWrittenFiles.clear();
+  mDrillTravelDistances.clear();
 
+  // Every output file is generated by an independent job which only reads
+  // the board, so all jobs are executed in parallel. Jobs which don't write
+  // a file return an invalid file path.
+  QList<std::function<FilePath()>> jobs;
   if (mSettings->getMergeDrillFiles()) {
-    exportDrills();
+    jobs.append([this]() { return exportDrills(); });
   } else {
-    exportDrillsNpth();
-    exportDrillsPth();
-  }
-  exportLayerBoardOutlines();
-  exportLayerTopCopper();
-  exportLayerInnerCopper();
-  exportLayerBottomCopper();
-  exportLayerTopSolderMask();
-  exportLayerBottomSolderMask();
-  exportLayerTopSilkscreen();
-  exportLayerBottomSilkscreen();
+    jobs.append([this]() { return exportDrillsNpth(); });
+    jobs.append([this]() { return exportDrillsPth(); });
+  }
+  jobs.append([this]() { return exportLayerBoardOutlines(); });
+  jobs.append([this]() { return exportLayerTopCopper(); });
+  for (int i = 1; i <= mBoard.getLayerStack().getInnerLayerCount(); ++i) {
+    jobs.append([this, i]() { return exportLayerInnerCopper(i); });
+  }
+  jobs.append([this]() { return exportLayerBottomCopper(); });
+  jobs.append([this]() { return exportLayerTopSolderMask(); });
+  jobs.append([this]() { return exportLayerBottomSolderMask(); });
+  jobs.append([this]() { return exportLayerTopSilkscreen(); });
+  jobs.append([this]() { return exportLayerBottomSilkscreen(); });
   if (mSettings->getEnableSolderPasteTop()) {
-    exportLayerTopSolderPaste();
+    jobs.append([this]() { return exportLayerTopSolderPaste(); });
   }
   if (mSettings->getEnableSolderPasteBot()) {
-    exportLayerBottomSolderPaste();
+    jobs.append([this]() { return exportLayerBottomSolderPaste(); });
+  }
+
+  QList<QFuture<FilePath>> futures;
+  foreach (const std::function<FilePath()>& job, jobs) {
+    futures.append(QtConcurrent::run(job));
+  }
+
+  // Wait until all jobs are finished before throwing any exception since the
+  // jobs are accessing this object.
+  for (QFuture<FilePath>& future : futures) {
+    try {
+      future.waitForFinished();
+    } catch (...) {
+      // will be rethrown below
+    }
+  }
+
+  // Collect written files in the same order as a sequential export.
+  foreach (const QFuture<FilePath>& future, futures) {
+    FilePath fp = future.result();  // can throw
+    if (fp.isValid()) {
+      mWrittenFiles.append(fp);
+    }
   }
 }
 
@@ -112,15 +177,6 @@ void BoardGerberExport::exportAllLayers() const {
  *  Inherited from AttributeProvider
  ******************************************************************************/
 
-QString BoardGerberExport::getBuiltInAttributeValue(const QString& key) const
-    noexcept {
-  if ((key == QLatin1String("CU_LAYER")) && (mCurrentInnerCopperLayer > 0)) {
-    return QString::number(mCurrentInnerCopperLayer);
-  } else {
-    return QString();
-  }
-}
-
 QVector<const AttributeProvider*>
 BoardGerberExport::getAttributeProviderParents() const noexcept {
   return QVector<const AttributeProvider*>{&mBoard};
@@ -130,17 +186,16 @@ BoardGerberExport::getAttributeProviderParents() const noexcept {
  *  Private Methods
  ******************************************************************************/
 
-void BoardGerberExport::exportDrills() const {
+FilePath BoardGerberExport::exportDrills() const {
   FilePath          fp = getOutputFilePath(mSettings->getSuffixDrills());
   ExcellonGenerator gen;
   drawPthDrills(gen);
   drawNpthDrills(gen);
-  gen.generate();
-  gen.saveToFile(fp);
-  mWrittenFiles.append(fp);
+  saveDrillFile(gen, fp);
+  return fp;
 }
 
-void BoardGerberExport::exportDrillsNpth() const {
+FilePath BoardGerberExport::exportDrillsNpth() const {
   FilePath          fp = getOutputFilePath(mSettings->getSuffixDrillsNpth());
   ExcellonGenerator gen;
   int               count = drawNpthDrills(gen);
@@ -149,22 +204,22 @@ void BoardGerberExport::exportDrillsNpth() const {
     // and NPTH. As many boards don't have non-plated holes anyway, we create
     // this file only if it's really needed. Maybe this avoids unnecessary
     // issues with manufacturers...
-    gen.generate();
-    gen.saveToFile(fp);
-    mWrittenFiles.append(fp);
+    saveDrillFile(gen, fp);
+    return fp;
+  } else {
+    return FilePath();
   }
 }
 
-void BoardGerberExport::exportDrillsPth() const {
+FilePath BoardGerberExport::exportDrillsPth() const {
   FilePath          fp = getOutputFilePath(mSettings->getSuffixDrillsPth());
   ExcellonGenerator gen;
   drawPthDrills(gen);
-  gen.generate();
-  gen.saveToFile(fp);
-  mWrittenFiles.append(fp);
+  saveDrillFile(gen, fp);
+  return fp;
 }
 
-void BoardGerberExport::exportLayerBoardOutlines() const {
+FilePath BoardGerberExport::exportLayerBoardOutlines() const {
   FilePath        fp = getOutputFilePath(mSettings->getSuffixOutlines());
   GerberGenerator gen(
       mProject.getMetadata().getName() % " - " % mBoard.getName(),
@@ -172,10 +227,10 @@ void BoardGerberExport::exportLayerBoardOutlines() const {
   drawLayer(gen, GraphicsLayer::sBoardOutlines);
   gen.generate();
   gen.saveToFile(fp);
-  mWrittenFiles.append(fp);
+  return fp;
 }
 
-void BoardGerberExport::exportLayerTopCopper() const {
+FilePath BoardGerberExport::exportLayerTopCopper() const {
   FilePath        fp = getOutputFilePath(mSettings->getSuffixCopperTop());
   GerberGenerator gen(
       mProject.getMetadata().getName() % " - " % mBoard.getName(),
@@ -183,10 +238,10 @@ void BoardGerberExport::exportLayerTopCopper() const {
   drawLayer(gen, GraphicsLayer::sTopCopper);
   gen.generate();
   gen.saveToFile(fp);
-  mWrittenFiles.append(fp);
+  return fp;
 }
 
-void BoardGerberExport::exportLayerBottomCopper() const {
+FilePath BoardGerberExport::exportLayerBottomCopper() const {
   FilePath        fp = getOutputFilePath(mSettings->getSuffixCopperBot());
   GerberGenerator gen(
       mProject.getMetadata().getName() % " - " % mBoard.getName(),
@@ -194,25 +249,22 @@ void BoardGerberExport::exportLayerBottomCopper() const {
   drawLayer(gen, GraphicsLayer::sBotCopper);
   gen.generate();
   gen.saveToFile(fp);
-  mWrittenFiles.append(fp);
+  return fp;
 }
 
-void BoardGerberExport::exportLayerInnerCopper() const {
-  for (int i = 1; i <= mBoard.getLayerStack().getInnerLayerCount(); ++i) {
-    mCurrentInnerCopperLayer = i;  // used for attribute provider
-    FilePath        fp = getOutputFilePath(mSettings->getSuffixCopperInner());
-    GerberGenerator gen(
-        mProject.getMetadata().getName() % " - " % mBoard.getName(),
-        mBoard.getUuid(), mProject.getMetadata().getVersion());
-    drawLayer(gen, GraphicsLayer::getInnerLayerName(i));
-    gen.generate();
-    gen.saveToFile(fp);
-    mWrittenFiles.append(fp);
-  }
-  mCurrentInnerCopperLayer = 0;
+FilePath BoardGerberExport::exportLayerInnerCopper(int layer) const {
+  FilePath        fp =
+      getOutputFilePath(mSettings->getSuffixCopperInner(), layer);
+  GerberGenerator gen(
+      mProject.getMetadata().getName() % " - " % mBoard.getName(),
+      mBoard.getUuid(), mProject.getMetadata().getVersion());
+  drawLayer(gen, GraphicsLayer::getInnerLayerName(layer));
+  gen.generate();
+  gen.saveToFile(fp);
+  return fp;
 }
 
-void BoardGerberExport::exportLayerTopSolderMask() const {
+FilePath BoardGerberExport::exportLayerTopSolderMask() const {
   FilePath        fp = getOutputFilePath(mSettings->getSuffixSolderMaskTop());
   GerberGenerator gen(
       mProject.getMetadata().getName() % " - " % mBoard.getName(),
@@ -220,10 +272,10 @@ void BoardGerberExport::exportLayerTopSolderMask() const {
   drawLayer(gen, GraphicsLayer::sTopStopMask);
   gen.generate();
   gen.saveToFile(fp);
-  mWrittenFiles.append(fp);
+  return fp;
 }
 
-void BoardGerberExport::exportLayerBottomSolderMask() const {
+FilePath BoardGerberExport::exportLayerBottomSolderMask() const {
   FilePath        fp = getOutputFilePath(mSettings->getSuffixSolderMaskBot());
   GerberGenerator gen(
       mProject.getMetadata().getName() % " - " % mBoard.getName(),
@@ -231,10 +283,10 @@ void BoardGerberExport::exportLayerBottomSolderMask() const {
   drawLayer(gen, GraphicsLayer::sBotStopMask);
   gen.generate();
   gen.saveToFile(fp);
-  mWrittenFiles.append(fp);
+  return fp;
 }
 
-void BoardGerberExport::exportLayerTopSilkscreen() const {
+FilePath BoardGerberExport::exportLayerTopSilkscreen() const {
   QStringList layers = mSettings->getSilkscreenLayersTop();
   if (layers.count() >
       0) {  // don't create silkscreen file if no layers selected
@@ -247,11 +299,13 @@ void BoardGerberExport::exportLayerTopSilkscreen() const {
     drawLayer(gen, GraphicsLayer::sTopStopMask);
     gen.generate();
     gen.saveToFile(fp);
-    mWrittenFiles.append(fp);
+    return fp;
+  } else {
+    return FilePath();
   }
 }
 
-void BoardGerberExport::exportLayerBottomSilkscreen() const {
+FilePath BoardGerberExport::exportLayerBottomSilkscreen() const {
   QStringList layers = mSettings->getSilkscreenLayersBot();
   if (layers.count() >
       0) {  // don't create silkscreen file if no layers selected
@@ -264,11 +318,13 @@ void BoardGerberExport::exportLayerBottomSilkscreen() const {
     drawLayer(gen, GraphicsLayer::sBotStopMask);
     gen.generate();
     gen.saveToFile(fp);
-    mWrittenFiles.append(fp);
+    return fp;
+  } else {
+    return FilePath();
   }
 }
 
-void BoardGerberExport::exportLayerTopSolderPaste() const {
+FilePath BoardGerberExport::exportLayerTopSolderPaste() const {
   FilePath        fp = getOutputFilePath(mSettings->getSuffixSolderPasteTop());
   GerberGenerator gen(
       mProject.getMetadata().getName() % " - " % mBoard.getName(),
@@ -276,10 +332,10 @@ void BoardGerberExport::exportLayerTopSolderPaste() const {
   drawLayer(gen, GraphicsLayer::sTopSolderPaste);
   gen.generate();
   gen.saveToFile(fp);
-  mWrittenFiles.append(fp);
+  return fp;
 }
 
-void BoardGerberExport::exportLayerBottomSolderPaste() const {
+FilePath BoardGerberExport::exportLayerBottomSolderPaste() const {
   FilePath        fp = getOutputFilePath(mSettings->getSuffixSolderPasteBot());
   GerberGenerator gen(
       mProject.getMetadata().getName() % " - " % mBoard.getName(),
@@ -287,7 +343,20 @@ void BoardGerberExport::exportLayerBottomSolderPaste() const {
   drawLayer(gen, GraphicsLayer::sBotSolderPaste);
   gen.generate();
   gen.saveToFile(fp);
-  mWrittenFiles.append(fp);
+  return fp;
+}
+
+void BoardGerberExport::saveDrillFile(ExcellonGenerator& gen,
+                                      const FilePath&    fp) const {
+  gen.setOptimizeToolPaths(mSettings->getOptimizeDrillOrder());
+  gen.generate();
+  gen.saveToFile(fp);  // can throw
+
+  DrillTravelDistance distance;
+  distance.unoptimized = gen.getUnoptimizedTravelDistance();
+  distance.optimized   = gen.getTotalTravelDistance();
+  QMutexLocker lock(&mDrillDistancesMutex);
+  mDrillTravelDistances.insert(fp, distance);
 }
 
 int BoardGerberExport::drawNpthDrills(ExcellonGenerator& gen) const {
@@ -577,10 +646,12 @@ void BoardGerberExport::drawFootprintPad(GerberGenerator&       gen,
   }
 }
 
-FilePath BoardGerberExport::getOutputFilePath(const QString& suffix) const
+FilePath BoardGerberExport::getOutputFilePath(const QString& suffix,
+                                              int innerCopperLayer) const
     noexcept {
-  QString path = mSettings->getOutputBasePath() + suffix;
-  path = AttributeSubstitutor::substitute(path, this, [&](const QString& str) {
+  OutputFileAttributeProvider ap(*this, innerCopperLayer);
+  QString                     path = mSettings->getOutputBasePath() + suffix;
+  path = AttributeSubstitutor::substitute(path, &ap, [&](const QString& str) {
     return FilePath::cleanFileName(
         str, FilePath::ReplaceSpaces | FilePath::KeepCase);
   });
@@ -59,6 +59,14 @@ class BoardGerberExport final : public QObject, public AttributeProvider {
   Q_OBJECT
 
 public:
+  // Types
+
+  /// Travel distances of the drilling machine for a written drill file
+  struct DrillTravelDistance {
+    UnsignedLength unoptimized = UnsignedLength(0);  ///< Original hit order
+    UnsignedLength optimized   = UnsignedLength(0);  ///< As written to file
+  };
+
   // Constructors / Destructor
   BoardGerberExport()                               = delete;
   BoardGerberExport(const BoardGerberExport& other) = delete;
@@ -72,12 +80,24 @@ public:
     return mWrittenFiles;
   }
 
+  /**
+   * @brief Get the travel distances of the drill files written by
+   *        #exportAllLayers()
+   *
+   * If optimizing the drill order is disabled in the fabrication output
+   * settings, both distances are equal.
+   *
+   * @return Travel distances of all written drill files
+   */
+  const QHash<FilePath, DrillTravelDistance>& getDrillTravelDistances() const
+      noexcept {
+    return mDrillTravelDistances;
+  }
+
   // General Methods
   void exportAllLayers() const;
 
   // Inherited from AttributeProvider
-  /// @copydoc librepcb::AttributeProvider::getBuiltInAttributeValue()
-  QString getBuiltInAttributeValue(const QString& key) const noexcept override;
   /// @copydoc librepcb::AttributeProvider::getAttributeProviderParents()
   QVector<const AttributeProvider*> getAttributeProviderParents() const
       noexcept override;
@@ -90,20 +110,21 @@ signals:
 
 private:
   // Private Methods
-  void exportDrills() const;
-  void exportDrillsNpth() const;
-  void exportDrillsPth() const;
-  void exportLayerBoardOutlines() const;
-  void exportLayerTopCopper() const;
-  void exportLayerInnerCopper() const;
-  void exportLayerBottomCopper() const;
-  void exportLayerTopSolderMask() const;
-  void exportLayerBottomSolderMask() const;
-  void exportLayerTopSilkscreen() const;
-  void exportLayerBottomSilkscreen() const;
-  void exportLayerTopSolderPaste() const;
-  void exportLayerBottomSolderPaste() const;
-
+  FilePath exportDrills() const;
+  FilePath exportDrillsNpth() const;
+  FilePath exportDrillsPth() const;
+  FilePath exportLayerBoardOutlines() const;
+  FilePath exportLayerTopCopper() const;
+  FilePath exportLayerInnerCopper(int layer) const;
+  FilePath exportLayerBottomCopper() const;
+  FilePath exportLayerTopSolderMask() const;
+  FilePath exportLayerBottomSolderMask() const;
+  FilePath exportLayerTopSilkscreen() const;
+  FilePath exportLayerBottomSilkscreen() const;
+  FilePath exportLayerTopSolderPaste() const;
+  FilePath exportLayerBottomSolderPaste() const;
+
+  void saveDrillFile(ExcellonGenerator& gen, const FilePath& fp) const;
   int  drawNpthDrills(ExcellonGenerator& gen) const;
   int  drawPthDrills(ExcellonGenerator& gen) const;
   void drawLayer(GerberGenerator& gen, const QString& layerName) const;
@@ -114,7 +135,8 @@ private:
   void drawFootprintPad(GerberGenerator& gen, const BI_FootprintPad& pad,
                         const QString& layerName) const;
 
-  FilePath getOutputFilePath(const QString& suffix) const noexcept;
+  FilePath getOutputFilePath(const QString& suffix,
+                             int innerCopperLayer = 0) const noexcept;
 
   // Static Methods
   static UnsignedLength calcWidthOfLayer(const UnsignedLength& width,
@@ -133,8 +155,9 @@ private:
   const Project&                                       mProject;
   const Board&                                         mBoard;
   QScopedPointer<const BoardFabricationOutputSettings> mSettings;
-  mutable int                                          mCurrentInnerCopperLayer;
   mutable QVector<FilePath>                            mWrittenFiles;
+  mutable QHash<FilePath, DrillTravelDistance>         mDrillTravelDistances;
+  mutable QMutex                                       mDrillDistancesMutex;
 };
 
 /*******************************************************************************
@@ -121,6 +121,7 @@ QList<GraphicsLayer*> BoardLayerStack::getAllowedPolygonLayers() const
 void BoardLayerStack::setInnerLayerCount(int count) noexcept {
   if ((count >= 0) && (count != mInnerLayerCount)) {
     mInnerLayerCount = count;
+    mBoard.incrementRevision();
     for (GraphicsLayer* layer : mLayers) {
       if (layer->isInnerLayer() && layer->isCopperLayer()) {
         layer->setEnabled(layer->getInnerLayerNumber() <= mInnerLayerCount);
@@ -0,0 +1,151 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+#include "boardobstacleindex.h"
+
+#include "board.h"
+#include "items/bi_device.h"
+#include "items/bi_footprint.h"
+#include "items/bi_footprintpad.h"
+#include "items/bi_hole.h"
+#include "items/bi_netline.h"
+#include "items/bi_netsegment.h"
+#include "items/bi_via.h"
+
+#include <librepcb/common/geometry/path.h>
+#include <librepcb/common/utils/clipperhelpers.h>
+#include <librepcb/library/pkg/footprint.h>
+
+#include <QtCore>
+
+/*******************************************************************************
+ *  Namespace
+ ******************************************************************************/
+namespace librepcb {
+namespace project {
+
+/*******************************************************************************
+ *  Constructors / Destructor
+ ******************************************************************************/
+
+BoardObstacleIndex::BoardObstacleIndex(const Board&         board,
+                                       const QSet<QString>& layers) noexcept {
+  foreach (const QString& layer, layers) {
+    mLayers.insert(layer,
+                   SpatialIndex<const BI_Base*>(PositiveLength(2000000)));
+  }
+
+  // devices
+  foreach (const BI_Device* device, board.getDeviceInstances()) {
+    QVector<Path> holes;
+    for (const Hole& hole :
+         device->getFootprint().getLibFootprint().getHoles()) {
+      Point pos = device->getFootprint().mapToScene(hole.getPosition());
+      holes.append(Path::circle(hole.getDiameter()).translated(pos));
+    }
+    foreach (const QString& layer, layers) {
+      QVector<Path> outlines = holes;
+      foreach (const BI_FootprintPad* pad, device->getFootprint().getPads()) {
+        if (pad->isOnLayer(layer)) {
+          outlines.append(pad->getSceneOutline());
+        }
+      }
+      addItem(layer, *device, outlines);
+    }
+  }
+
+  // board holes
+  foreach (const BI_Hole* hole, board.getHoles()) {
+    QVector<Path> outlines = {Path::circle(hole->getHole().getDiameter())
+                                  .translated(hole->getHole().getPosition())};
+    foreach (const QString& layer, layers) { addItem(layer, *hole, outlines); }
+  }
+
+  // net segment items
+  foreach (const BI_NetSegment* netsegment, board.getNetSegments()) {
+    foreach (const BI_Via* via, netsegment->getVias()) {
+      QVector<Path> outlines = {via->getSceneOutline()};
+      foreach (const QString& layer, layers) { addItem(layer, *via, outlines); }
+    }
+    foreach (const BI_NetLine* netline, netsegment->getNetLines()) {
+      QString layer = netline->getLayer().getName();
+      if (layers.contains(layer)) {
+        addItem(layer, *netline, {netline->getSceneOutline()});
+      }
+    }
+  }
+}
+
+BoardObstacleIndex::~BoardObstacleIndex() noexcept {
+}
+
+/*******************************************************************************
+ *  Getters
+ ******************************************************************************/
+
+QList<const BI_Base*> BoardObstacleIndex::getObstacles(const QString& layer,
+                                                       const Point&   p1,
+                                                       const Point&   p2) const
+    noexcept {
+  auto it = mLayers.constFind(layer);
+  Q_ASSERT(it != mLayers.constEnd());
+  return (it != mLayers.constEnd()) ? it->query(p1, p2)
+                                    : QList<const BI_Base*>();
+}
+
+/*******************************************************************************
+ *  Private Methods
+ ******************************************************************************/
+
+void BoardObstacleIndex::addItem(const QString& layer, const BI_Base& item,
+                                 const QVector<Path>& outlines) noexcept {
+  // Arcs are flattened with the given tolerance, so the rectangle is expanded
+  // by the tolerance to be sure it contains the whole item.
+  PositiveLength   tolerance(5000);
+  ClipperLib::cInt left = 0, bottom = 0, right = 0, top = 0;
+  bool             empty = true;
+  foreach (const Path& outline, outlines) {
+    for (const ClipperLib::IntPoint& p :
+         ClipperHelpers::convert(outline, tolerance)) {
+      if (empty || (p.X < left)) left = p.X;
+      if (empty || (p.X > right)) right = p.X;
+      if (empty || (p.Y < bottom)) bottom = p.Y;
+      if (empty || (p.Y > top)) top = p.Y;
+      empty = false;
+    }
+  }
+  auto it = mLayers.find(layer);
+  if ((!empty) && (it != mLayers.end())) {
+    it->insert(&item,
+               Point(Length(left - tolerance->toNm()),
+                     Length(bottom - tolerance->toNm())),
+               Point(Length(right + tolerance->toNm()),
+                     Length(top + tolerance->toNm())));
+  }
+}
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace project
+}  // namespace librepcb
@@ -0,0 +1,106 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBREPCB_PROJECT_BOARDOBSTACLEINDEX_H
+#define LIBREPCB_PROJECT_BOARDOBSTACLEINDEX_H
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+#include <librepcb/common/units/all_length_units.h>
+#include <librepcb/common/utils/spatialindex.h>
+
+#include <QtCore>
+
+/*******************************************************************************
+ *  Namespace / Forward Declarations
+ ******************************************************************************/
+namespace librepcb {
+
+class Path;
+
+namespace project {
+
+class Board;
+class BI_Base;
+
+/*******************************************************************************
+ *  Class BoardObstacleIndex
+ ******************************************************************************/
+
+/**
+ * @brief A spatial index of all copper obstacles of a board, per layer
+ *
+ * Contains devices (with their holes and pads), board holes, vias and
+ * netlines, used by librepcb::project::BoardPlaneFragmentsBuilder to look
+ * only at the obstacles within the area of a plane. The index is a snapshot
+ * of the board, it is not updated when the board is modified.
+ *
+ * The bounding rectangles in the index are the (conservatively rounded)
+ * bounding rectangles of the copper areas, without any clearance.
+ */
+class BoardObstacleIndex final {
+public:
+  // Constructors / Destructor
+  BoardObstacleIndex()                                = delete;
+  BoardObstacleIndex(const BoardObstacleIndex& other) = delete;
+  BoardObstacleIndex(const Board& board, const QSet<QString>& layers) noexcept;
+  ~BoardObstacleIndex() noexcept;
+
+  // Getters
+  bool containsLayer(const QString& layer) const noexcept {
+    return mLayers.contains(layer);
+  }
+
+  /**
+   * @brief Get all obstacles on a layer within a rectangle
+   *
+   * @param layer   Name of the copper layer (must be contained in the index).
+   * @param p1      One corner of the rectangle.
+   * @param p2      The opposite corner of the rectangle.
+   *
+   * @return All devices (librepcb::project::BI_Device), board holes
+   *         (librepcb::project::BI_Hole), vias (librepcb::project::BI_Via) and
+   *         netlines (librepcb::project::BI_NetLine) within the rectangle.
+   *         The items are returned in the same order as they are stored in
+   *         the board (devices, holes, and net segments with their vias and
+   *         netlines).
+   */
+  QList<const BI_Base*> getObstacles(const QString& layer, const Point& p1,
+                                     const Point& p2) const noexcept;
+
+  // Operator Overloadings
+  BoardObstacleIndex& operator=(const BoardObstacleIndex& rhs) = delete;
+
+private:  // Methods
+  void addItem(const QString& layer, const BI_Base& item,
+               const QVector<Path>& outlines) noexcept;
+
+private:  // Data
+  QHash<QString, SpatialIndex<const BI_Base*>> mLayers;
+};
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace project
+}  // namespace librepcb
+
+#endif  // LIBREPCB_PROJECT_BOARDOBSTACLEINDEX_H
@@ -22,6 +22,8 @@
  ******************************************************************************/
 #include "boardplanefragmentsbuilder.h"
 
+#include "board.h"
+#include "boardobstacleindex.h"
 #include "items/bi_device.h"
 #include "items/bi_footprint.h"
 #include "items/bi_footprintpad.h"
@@ -50,8 +52,10 @@ namespace project {
  *  Constructors / Destructor
  ******************************************************************************/
 
-BoardPlaneFragmentsBuilder::BoardPlaneFragmentsBuilder(BI_Plane& plane) noexcept
-  : mPlane(plane) {
+BoardPlaneFragmentsBuilder::BoardPlaneFragmentsBuilder(
+    BI_Plane&                                 plane,
+    std::shared_ptr<const BoardObstacleIndex> obstacles) noexcept
+  : mPlane(plane), mObstacleIndex(obstacles) {
 }
 
 BoardPlaneFragmentsBuilder::~BoardPlaneFragmentsBuilder() noexcept {
@@ -61,8 +65,13 @@ BoardPlaneFragmentsBuilder::~BoardPlaneFragmentsBuilder() noexcept {
  *  General Methods
  ******************************************************************************/
 
-QVector<Path> BoardPlaneFragmentsBuilder::buildFragments() noexcept {
+bool BoardPlaneFragmentsBuilder::buildFragments(bool force) noexcept {
   try {
+    collectInputs();  // can throw
+    mInputHash = calcInputHash();
+    if ((!force) && (mInputHash == mPlane.getFragmentsInputHash())) {
+      return false;  // inputs not modified -> current fragments are valid
+    }
     mResult.clear();
     addPlaneOutline();
     clipToBoardOutline();
@@ -72,34 +81,103 @@ QVector<Path> BoardPlaneFragmentsBuilder::buildFragments() noexcept {
     if (!mPlane.getKeepOrphans()) {
       removeOrphans();
     }
-    return ClipperHelpers::convert(mResult);
+    mFragments = ClipperHelpers::convert(mResult);
   } catch (const Exception& e) {
     qCritical() << "Failed to build plane fragments! Leave plane empty...";
     qCritical() << "Inner error message:" << e.getMsg();
-    return QVector<Path>();
+    mFragments.clear();
+    mInputHash.clear();  // make sure the plane is built again next time
   }
+  return true;
+}
+
+/*******************************************************************************
+ *  Static Methods
+ ******************************************************************************/
+
+bool BoardPlaneFragmentsBuilder::dependsOn(const BI_Plane& plane,
+                                           const BI_Plane& other) noexcept {
+  if (&other == &plane) return false;
+  if (other < plane) return false;  // ignore planes with lower priority
+  if (other.getLayerName() != plane.getLayerName()) return false;
+  if (&other.getNetSignal() == &plane.getNetSignal()) return false;
+
+  // Fragments are always located within the plane outline, so planes with
+  // distant outlines can't affect each other. The arc tolerance is added to
+  // the clearance to be on the safe side with the offset of the fragments.
+  ClipperLib::cInt margin =
+      plane.getMinClearance()->toNm() + maxArcTolerance()->toNm();
+  return intersects(getBoundingRect(plane.getOutline()),
+                    getBoundingRect(other.getOutline()), margin);
 }
 
 /*******************************************************************************
  *  Private Methods
  ******************************************************************************/
 
+void BoardPlaneFragmentsBuilder::collectInputs() {
+  const Board& board = mPlane.getBoard();
+
+  // plane outline
+  mOutline = ClipperHelpers::convert(mPlane.getOutline(), maxArcTolerance());
+  mOutlineBounds = getBoundingRect(mOutline);
+
+  // board outlines
+  foreach (const BI_Polygon* polygon, board.getPolygons()) {
+    if (polygon->getPolygon().getLayerName() == GraphicsLayer::sBoardOutlines) {
+      mBoardOutlines.push_back(ClipperHelpers::convert(
+          polygon->getPolygon().getPath(), maxArcTolerance()));
+    }
+  }
+
+  // other planes
+  foreach (const BI_Plane* plane, board.getPlanes()) {
+    if (!dependsOn(mPlane, *plane)) continue;
+    mOtherPlanesFragments.append(
+        ClipperHelpers::convert(plane->getFragments(), maxArcTolerance()));
+  }
+
+  // obstacles within the plane area
+  QString layer = *mPlane.getLayerName();
+  if ((!mObstacleIndex) || (!mObstacleIndex->containsLayer(layer))) {
+    mObstacleIndex = std::make_shared<BoardObstacleIndex>(
+        board, QSet<QString>{layer});
+  }
+  Length margin = *mPlane.getMinClearance() + *maxArcTolerance();
+  Point  p1(Length(mOutlineBounds.left) - margin,
+           Length(mOutlineBounds.top) - margin);
+  Point  p2(Length(mOutlineBounds.right) + margin,
+           Length(mOutlineBounds.bottom) + margin);
+  foreach (const BI_Base* item, mObstacleIndex->getObstacles(layer, p1, p2)) {
+    switch (item->getType()) {
+      case BI_Base::Type_t::Device:
+        addDeviceObstacles(*static_cast<const BI_Device*>(item));
+        break;
+      case BI_Base::Type_t::Hole:
+        addHoleObstacle(*static_cast<const BI_Hole*>(item));
+        break;
+      case BI_Base::Type_t::Via:
+        addViaObstacle(*static_cast<const BI_Via*>(item));
+        break;
+      case BI_Base::Type_t::NetLine:
+        addNetLineObstacle(*static_cast<const BI_NetLine*>(item));
+        break;
+      default:
+        qWarning() << "Unhandled item type in plane obstacle index.";
+        break;
+    }
+  }
+}
+
 void BoardPlaneFragmentsBuilder::addPlaneOutline() {
-  mResult.push_back(
-      ClipperHelpers::convert(mPlane.getOutline(), maxArcTolerance()));
+  mResult.push_back(mOutline);
 }
 
 void BoardPlaneFragmentsBuilder::clipToBoardOutline() {
   // determine board area
   ClipperLib::Paths   boardArea;
   ClipperLib::Clipper boardAreaClipper;
-  foreach (const BI_Polygon* polygon, mPlane.getBoard().getPolygons()) {
-    if (polygon->getPolygon().getLayerName() == GraphicsLayer::sBoardOutlines) {
-      ClipperLib::Path path = ClipperHelpers::convert(
-          polygon->getPolygon().getPath(), maxArcTolerance());
-      boardAreaClipper.AddPath(path, ClipperLib::ptSubject, true);
-    }
-  }
+  boardAreaClipper.AddPaths(mBoardOutlines, ClipperLib::ptSubject, true);
   boardAreaClipper.Execute(ClipperLib::ctXor, boardArea, ClipperLib::pftEvenOdd,
                            ClipperLib::pftEvenOdd);
 
@@ -123,76 +201,14 @@ void BoardPlaneFragmentsBuilder::subtractOtherObjects() {
   c.AddPaths(mResult, ClipperLib::ptSubject, true);
 
   // subtract other planes
-  foreach (const BI_Plane* plane, mPlane.getBoard().getPlanes()) {
-    if (plane == &mPlane) continue;
-    if (*plane < mPlane) continue;  // ignore planes with lower priority
-    if (plane->getLayerName() != mPlane.getLayerName()) continue;
-    if (&plane->getNetSignal() == &mPlane.getNetSignal()) continue;
-    ClipperLib::Paths paths =
-        ClipperHelpers::convert(plane->getFragments(), maxArcTolerance());
+  foreach (ClipperLib::Paths paths, mOtherPlanesFragments) {
     ClipperHelpers::offset(paths, *mPlane.getMinClearance(),
                            maxArcTolerance());  // can throw
     c.AddPaths(paths, ClipperLib::ptClip, true);
   }
 
-  // subtract holes and pads from devices
-  foreach (const BI_Device* device, mPlane.getBoard().getDeviceInstances()) {
-    for (const Hole& hole :
-         device->getFootprint().getLibFootprint().getHoles()) {
-      Point pos = device->getFootprint().mapToScene(hole.getPosition());
-      PositiveLength dia(hole.getDiameter() + mPlane.getMinClearance() * 2);
-      Path           path = Path::circle(dia).translated(pos);
-      c.AddPath(ClipperHelpers::convert(path, maxArcTolerance()),
-                ClipperLib::ptClip, true);
-    }
-    foreach (const BI_FootprintPad* pad, device->getFootprint().getPads()) {
-      if (!pad->isOnLayer(*mPlane.getLayerName())) continue;
-      if (pad->getCompSigInstNetSignal() == &mPlane.getNetSignal()) {
-        ClipperLib::Path path =
-            ClipperHelpers::convert(pad->getSceneOutline(), maxArcTolerance());
-        mConnectedNetSignalAreas.push_back(path);
-      }
-      c.AddPath(createPadCutOut(*pad), ClipperLib::ptClip, true);
-    }
-  }
-
-  // subtract board holes
-  for (const BI_Hole* hole : mPlane.getBoard().getHoles()) {
-    PositiveLength dia(hole->getHole().getDiameter() +
-                       mPlane.getMinClearance() * 2);
-    Path path = Path::circle(dia).translated(hole->getHole().getPosition());
-    c.AddPath(ClipperHelpers::convert(path, maxArcTolerance()),
-              ClipperLib::ptClip, true);
-  }
-
-  // subtract net segment items
-  foreach (const BI_NetSegment* netsegment,
-           mPlane.getBoard().getNetSegments()) {
-    // subtract vias
-    foreach (const BI_Via* via, netsegment->getVias()) {
-      if (&netsegment->getNetSignal() == &mPlane.getNetSignal()) {
-        ClipperLib::Path path =
-            ClipperHelpers::convert(via->getSceneOutline(), maxArcTolerance());
-        mConnectedNetSignalAreas.push_back(path);
-      }
-      c.AddPath(createViaCutOut(*via), ClipperLib::ptClip, true);
-    }
-
-    // subtract netlines
-    foreach (const BI_NetLine* netline, netsegment->getNetLines()) {
-      if (netline->getLayer().getName() != mPlane.getLayerName()) continue;
-      if (&netsegment->getNetSignal() == &mPlane.getNetSignal()) {
-        ClipperLib::Path path = ClipperHelpers::convert(
-            netline->getSceneOutline(), maxArcTolerance());
-        mConnectedNetSignalAreas.push_back(path);
-      } else {
-        ClipperLib::Path path = ClipperHelpers::convert(
-            netline->getSceneOutline(*mPlane.getMinClearance()),
-            maxArcTolerance());
-        c.AddPath(path, ClipperLib::ptClip, true);
-      }
-    }
-  }
+  // subtract holes, pads, vias and netlines
+  c.AddPaths(mObstacles, ClipperLib::ptClip, true);
 
   c.Execute(ClipperLib::ctDifference, mResult, ClipperLib::pftEvenOdd,
             ClipperLib::pftNonZero);
@@ -236,6 +252,105 @@ void BoardPlaneFragmentsBuilder::removeOrphans() {
  *  Helper Methods
  ******************************************************************************/
 
+void BoardPlaneFragmentsBuilder::addDeviceObstacles(
+    const BI_Device& device) noexcept {
+  for (const Hole& hole : device.getFootprint().getLibFootprint().getHoles()) {
+    Point          pos = device.getFootprint().mapToScene(hole.getPosition());
+    PositiveLength dia(hole.getDiameter() + mPlane.getMinClearance() * 2);
+    Path           path = Path::circle(dia).translated(pos);
+    addObstacle(ClipperHelpers::convert(path, maxArcTolerance()));
+  }
+  foreach (const BI_FootprintPad* pad, device.getFootprint().getPads()) {
+    if (!pad->isOnLayer(*mPlane.getLayerName())) continue;
+    if (pad->getCompSigInstNetSignal() == &mPlane.getNetSignal()) {
+      addConnectedNetSignalArea(
+          ClipperHelpers::convert(pad->getSceneOutline(), maxArcTolerance()));
+    }
+    addObstacle(createPadCutOut(*pad));
+  }
+}
+
+void BoardPlaneFragmentsBuilder::addHoleObstacle(const BI_Hole& hole) noexcept {
+  PositiveLength dia(hole.getHole().getDiameter() +
+                     mPlane.getMinClearance() * 2);
+  Path path = Path::circle(dia).translated(hole.getHole().getPosition());
+  addObstacle(ClipperHelpers::convert(path, maxArcTolerance()));
+}
+
+void BoardPlaneFragmentsBuilder::addViaObstacle(const BI_Via& via) noexcept {
+  if (&via.getNetSignalOfNetSegment() == &mPlane.getNetSignal()) {
+    addConnectedNetSignalArea(
+        ClipperHelpers::convert(via.getSceneOutline(), maxArcTolerance()));
+  }
+  addObstacle(createViaCutOut(via));
+}
+
+void BoardPlaneFragmentsBuilder::addNetLineObstacle(
+    const BI_NetLine& netline) noexcept {
+  if (netline.getLayer().getName() != mPlane.getLayerName()) return;
+  if (&netline.getNetSignalOfNetSegment() == &mPlane.getNetSignal()) {
+    addConnectedNetSignalArea(ClipperHelpers::convert(
+        netline.getSceneOutline(), maxArcTolerance()));
+  } else {
+    addObstacle(ClipperHelpers::convert(
+        netline.getSceneOutline(*mPlane.getMinClearance()),
+        maxArcTolerance()));
+  }
+}
+
+void BoardPlaneFragmentsBuilder::addObstacle(
+    const ClipperLib::Path& path) noexcept {
+  // obstacles outside the plane area do not affect the fragments at all
+  if ((!path.empty()) && isInPlaneArea(path)) {
+    mObstacles.push_back(path);
+  }
+}
+
+void BoardPlaneFragmentsBuilder::addConnectedNetSignalArea(
+    const ClipperLib::Path& path) noexcept {
+  // areas outside the plane area can't be connected to any fragment
+  if ((!path.empty()) && isInPlaneArea(path)) {
+    mConnectedNetSignalAreas.push_back(path);
+  }
+}
+
+bool BoardPlaneFragmentsBuilder::isInPlaneArea(
+    const ClipperLib::Path& path) const noexcept {
+  return intersects(mOutlineBounds, getBoundingRect(path));
+}
+
+QByteArray BoardPlaneFragmentsBuilder::calcInputHash() const noexcept {
+  QByteArray data;
+  auto       addValue = [&data](qint64 value) {
+    value = qToLittleEndian(value);
+    data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  };
+  auto addPaths = [&addValue](const ClipperLib::Paths& paths) {
+    addValue(paths.size());
+    for (const ClipperLib::Path& path : paths) {
+      addValue(path.size());
+      for (const ClipperLib::IntPoint& point : path) {
+        addValue(point.X);
+        addValue(point.Y);
+      }
+    }
+  };
+
+  data.append(mPlane.getLayerName()->toUtf8());
+  addValue(mPlane.getMinWidth()->toNm());
+  addValue(mPlane.getMinClearance()->toNm());
+  addValue(mPlane.getKeepOrphans() ? 1 : 0);
+  addPaths(ClipperLib::Paths{mOutline});
+  addPaths(mBoardOutlines);
+  addValue(mOtherPlanesFragments.count());
+  foreach (const ClipperLib::Paths& paths, mOtherPlanesFragments) {
+    addPaths(paths);
+  }
+  addPaths(mObstacles);
+  addPaths(mConnectedNetSignalAreas);
+  return QCryptographicHash::hash(data, QCryptographicHash::Sha256);
+}
+
 ClipperLib::Path BoardPlaneFragmentsBuilder::createPadCutOut(
     const BI_FootprintPad& pad) const noexcept {
   bool differentNetSignal =
@@ -262,6 +377,31 @@ ClipperLib::Path BoardPlaneFragmentsBuilder::createViaCutOut(
   }
 }
 
+ClipperLib::IntRect BoardPlaneFragmentsBuilder::getBoundingRect(
+    const ClipperLib::Path& path) noexcept {
+  ClipperLib::IntRect rect = {0, 0, 0, 0};
+  for (std::size_t i = 0; i < path.size(); ++i) {
+    const ClipperLib::IntPoint& p = path.at(i);
+    if ((i == 0) || (p.X < rect.left)) rect.left = p.X;
+    if ((i == 0) || (p.X > rect.right)) rect.right = p.X;
+    if ((i == 0) || (p.Y < rect.top)) rect.top = p.Y;
+    if ((i == 0) || (p.Y > rect.bottom)) rect.bottom = p.Y;
+  }
+  return rect;
+}
+
+ClipperLib::IntRect BoardPlaneFragmentsBuilder::getBoundingRect(
+    const Path& path) noexcept {
+  return getBoundingRect(ClipperHelpers::convert(path, maxArcTolerance()));
+}
+
+bool BoardPlaneFragmentsBuilder::intersects(const ClipperLib::IntRect& r1,
+                                            const ClipperLib::IntRect& r2,
+                                            ClipperLib::cInt margin) noexcept {
+  return (r1.left <= r2.right + margin) && (r2.left <= r1.right + margin) &&
+         (r1.top <= r2.bottom + margin) && (r2.top <= r1.bottom + margin);
+}
+
 /*******************************************************************************
  *  End of File
  ******************************************************************************/
@@ -28,13 +28,19 @@
 
 #include <QtCore>
 
+#include <memory>
+
 /*******************************************************************************
  *  Namespace / Forward Declarations
  ******************************************************************************/
 namespace librepcb {
 namespace project {
 
+class BoardObstacleIndex;
 class BI_Plane;
+class BI_Device;
+class BI_Hole;
+class BI_NetLine;
 class BI_Via;
 class BI_FootprintPad;
 
@@ -44,23 +50,71 @@ class BI_FootprintPad;
 
 /**
  * @brief The BoardPlaneFragmentsBuilder class
+ *
+ * Before any clipping is done, all inputs which affect the fragments of the
+ * plane (outline, settings, board outline, higher-priority planes and all
+ * obstacles within the plane area) are collected and hashed. If the hash is
+ * equal to the input hash of the plane's current fragments, the expensive
+ * clipping is skipped since it would lead to exactly the same fragments. As
+ * only obstacles within the plane area are taken into account, edits far
+ * away from a plane do not require to rebuild it.
+ *
+ * The obstacles are looked up in a librepcb::project::BoardObstacleIndex. To
+ * build several planes, pass the same index to all builders to avoid indexing
+ * the whole board for each plane.
  */
 class BoardPlaneFragmentsBuilder final {
 public:
   // Constructors / Destructor
   BoardPlaneFragmentsBuilder()                                        = delete;
   BoardPlaneFragmentsBuilder(const BoardPlaneFragmentsBuilder& other) = delete;
-  BoardPlaneFragmentsBuilder(BI_Plane& plane) noexcept;
+  BoardPlaneFragmentsBuilder(
+      BI_Plane&                                 plane,
+      std::shared_ptr<const BoardObstacleIndex> obstacles = nullptr) noexcept;
   ~BoardPlaneFragmentsBuilder() noexcept;
 
+  // Getters
+  const QVector<Path>& getFragments() const noexcept { return mFragments; }
+  const QByteArray&    getInputHash() const noexcept { return mInputHash; }
+
   // General Methods
-  QVector<Path> buildFragments() noexcept;
+
+  /**
+   * @brief Build the plane fragments
+   *
+   * @param force   If false, the fragments are only built if the input hash
+   *                differs from BI_Plane::getFragmentsInputHash().
+   *
+   * @retval true   If fragments were built (see #getFragments()).
+   * @retval false  If the current fragments of the plane are still up to date.
+   */
+  bool buildFragments(bool force = false) noexcept;
+
+  // Static Methods
+
+  /**
+   * @brief Check whether the fragments of a plane depend on another plane
+   *
+   * This is the case if the other plane has a higher priority, is on the same
+   * layer, is connected to a different net signal and its outline overlaps
+   * with the outline of the plane (including the plane's clearance). Planes
+   * which do not depend on each other (directly or indirectly) can be built
+   * independently, e.g. in parallel.
+   *
+   * @param plane   The plane to check the dependencies of.
+   * @param other   The potential dependency.
+   *
+   * @retval true   If the fragments of @p plane depend on @p other.
+   * @retval false  If @p other does not affect the fragments of @p plane.
+   */
+  static bool dependsOn(const BI_Plane& plane, const BI_Plane& other) noexcept;
 
   // Operator Overloadings
   BoardPlaneFragmentsBuilder& operator=(const BoardPlaneFragmentsBuilder& rhs) =
       delete;
 
 private:  // Methods
+  void collectInputs();
   void addPlaneOutline();
   void clipToBoardOutline();
   void subtractOtherObjects();
@@ -69,8 +123,22 @@ private:  // Methods
   void removeOrphans();
 
   // Helper Methods
+  void addDeviceObstacles(const BI_Device& device) noexcept;
+  void addHoleObstacle(const BI_Hole& hole) noexcept;
+  void addViaObstacle(const BI_Via& via) noexcept;
+  void addNetLineObstacle(const BI_NetLine& netline) noexcept;
+  void addObstacle(const ClipperLib::Path& path) noexcept;
+  void addConnectedNetSignalArea(const ClipperLib::Path& path) noexcept;
+  bool isInPlaneArea(const ClipperLib::Path& path) const noexcept;
+  QByteArray       calcInputHash() const noexcept;
   ClipperLib::Path createPadCutOut(const BI_FootprintPad& pad) const noexcept;
   ClipperLib::Path createViaCutOut(const BI_Via& via) const noexcept;
+  static ClipperLib::IntRect getBoundingRect(
+      const ClipperLib::Path& path) noexcept;
+  static ClipperLib::IntRect getBoundingRect(const Path& path) noexcept;
+  static bool intersects(const ClipperLib::IntRect& r1,
+                         const ClipperLib::IntRect& r2,
+                         ClipperLib::cInt           margin = 0) noexcept;
 
   /**
    * Returns the maximum allowed arc tolerance when flattening arcs. Do not
@@ -82,9 +150,21 @@ private:  // Methods
   }
 
 private:  // Data
-  BI_Plane&         mPlane;
-  ClipperLib::Paths mConnectedNetSignalAreas;
+  BI_Plane&                                 mPlane;
+  std::shared_ptr<const BoardObstacleIndex> mObstacleIndex;
+
+  // Inputs
+  ClipperLib::Path    mOutline;
+  ClipperLib::IntRect mOutlineBounds;
+  ClipperLib::Paths   mBoardOutlines;
+  ClipperLib::Paths   mOtherPlanesFragments;
+  ClipperLib::Paths   mObstacles;
+  ClipperLib::Paths   mConnectedNetSignalAreas;
+  QByteArray          mInputHash;
+
+  // Outputs
   ClipperLib::Paths mResult;
+  QVector<Path>     mFragments;
 };
 
 /*******************************************************************************
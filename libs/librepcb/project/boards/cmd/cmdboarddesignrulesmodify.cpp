@@ -61,11 +61,13 @@ bool CmdBoardDesignRulesModify::performExecute() {
 
 void CmdBoardDesignRulesModify::performUndo() {
   mBoard.getDesignRules() = mOldRules;
+  mBoard.incrementRevision();
   emit mBoard.attributesChanged();
 }
 
 void CmdBoardDesignRulesModify::performRedo() {
   mBoard.getDesignRules() = mNewRules;
+  mBoard.incrementRevision();
   emit mBoard.attributesChanged();
 }
 
@@ -78,6 +78,9 @@ void BI_Base::addToBoard(QGraphicsItem* item) noexcept {
     mBoard.getGraphicsScene().addItem(*item);
   }
   mIsAddedToBoard = true;
+  if (item && (getType() != Type_t::AirWire)) {
+    mBoard.scheduleItemIndexUpdate(*this);
+  }
 }
 
 void BI_Base::removeFromBoard(QGraphicsItem* item) noexcept {
@@ -86,6 +89,7 @@ void BI_Base::removeFromBoard(QGraphicsItem* item) noexcept {
     mBoard.getGraphicsScene().removeItem(*item);
   }
   mIsAddedToBoard = false;
+  mBoard.scheduleItemIndexUpdate(*this);
 }
 
 /*******************************************************************************
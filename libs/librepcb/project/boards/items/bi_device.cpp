@@ -198,6 +198,7 @@ bool BI_Device::isUsed() const noexcept {
 void BI_Device::setPosition(const Point& pos) noexcept {
   if (pos != mPosition) {
     mPosition = pos;
+    mBoard.incrementRevision();
     emit moved(mPosition);
   }
 }
@@ -205,6 +206,7 @@ void BI_Device::setPosition(const Point& pos) noexcept {
 void BI_Device::setRotation(const Angle& rot) noexcept {
   if (rot != mRotation) {
     mRotation = rot;
+    mBoard.incrementRevision();
     emit rotated(mRotation);
   }
 }
@@ -215,6 +217,7 @@ void BI_Device::setIsMirrored(bool mirror) {
       throw LogicError(__FILE__, __LINE__);
     }
     mIsMirrored = mirror;
+    mBoard.incrementRevision();
     emit mirrored(mIsMirrored);
   }
 }
@@ -161,6 +161,7 @@ void BI_Footprint::addStrokeText(BI_StrokeText& text) {
     text.addToBoard();  // can throw
   }
   mStrokeTexts.append(&text);
+  mBoard.incrementRevision();
 }
 
 void BI_Footprint::removeStrokeText(BI_StrokeText& text) {
@@ -171,6 +172,7 @@ void BI_Footprint::removeStrokeText(BI_StrokeText& text) {
     text.removeFromBoard();  // can throw
   }
   mStrokeTexts.removeOne(&text);
+  mBoard.incrementRevision();
 }
 
 /*******************************************************************************
@@ -279,12 +281,14 @@ void BI_Footprint::setSelected(bool selected) noexcept {
 
 void BI_Footprint::deviceInstanceAttributesChanged() {
   mGraphicsItem->updateCacheAndRepaint();
+  mBoard.scheduleItemIndexUpdate(*this);
   emit attributesChanged();
 }
 
 void BI_Footprint::deviceInstanceMoved(const Point& pos) {
   mGraphicsItem->setPos(pos.toPxQPointF());
   mGraphicsItem->updateCacheAndRepaint();
+  mBoard.scheduleItemIndexUpdate(*this);
   foreach (BI_FootprintPad* pad, mPads) {
     pad->updatePosition();
     mBoard.scheduleAirWiresRebuild(pad->getCompSigInstNetSignal());
@@ -296,6 +300,7 @@ void BI_Footprint::deviceInstanceRotated(const Angle& rot) {
   Q_UNUSED(rot);
   updateGraphicsItemTransform();
   mGraphicsItem->updateCacheAndRepaint();
+  mBoard.scheduleItemIndexUpdate(*this);
   foreach (BI_FootprintPad* pad, mPads) {
     pad->updatePosition();
     mBoard.scheduleAirWiresRebuild(pad->getCompSigInstNetSignal());
@@ -306,6 +311,7 @@ void BI_Footprint::deviceInstanceMirrored(bool mirrored) {
   Q_UNUSED(mirrored);
   updateGraphicsItemTransform();
   mGraphicsItem->updateCacheAndRepaint();
+  mBoard.scheduleItemIndexUpdate(*this);
   foreach (BI_FootprintPad* pad, mPads) {
     pad->updatePosition();
     mBoard.scheduleAirWiresRebuild(pad->getCompSigInstNetSignal());
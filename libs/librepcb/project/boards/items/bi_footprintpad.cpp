@@ -25,6 +25,7 @@
 #include "../../circuit/componentinstance.h"
 #include "../../circuit/componentsignalinstance.h"
 #include "../../circuit/netsignal.h"
+#include "../board.h"
 #include "bi_device.h"
 #include "bi_footprint.h"
 
@@ -182,6 +183,7 @@ void BI_FootprintPad::updatePosition() noexcept {
   mGraphicsItem->setPos(mPosition.toPxQPointF());
   updateGraphicsItemTransform();
   mGraphicsItem->updateCacheAndRepaint();
+  mBoard.scheduleItemIndexUpdate(*this);
   foreach (BI_NetLine* netline, mRegisteredNetLines) { netline->updateLine(); }
 }
 
@@ -220,6 +222,7 @@ Path BI_FootprintPad::getSceneOutline(const Length& expansion) const noexcept {
 
 void BI_FootprintPad::footprintAttributesChanged() {
   mGraphicsItem->updateCacheAndRepaint();
+  mBoard.scheduleItemIndexUpdate(*this);
 }
 
 void BI_FootprintPad::componentSignalInstanceNetSignalChanged(NetSignal* from,
@@ -23,6 +23,7 @@
 #include "bi_netline.h"
 
 #include "../../circuit/netsignal.h"
+#include "../board.h"
 #include "../boardlayerstack.h"
 #include "bi_device.h"
 #include "bi_footprint.h"
@@ -207,14 +208,18 @@ void BI_NetLine::setLayer(GraphicsLayer& layer) {
   }
   if (&layer != mLayer) {
     mLayer = &layer;
+    mBoard.incrementRevision();
     mGraphicsItem->updateCacheAndRepaint();
+    mBoard.scheduleItemIndexUpdate(*this);
   }
 }
 
 void BI_NetLine::setWidth(const PositiveLength& width) noexcept {
   if (width != mWidth) {
     mWidth = width;
+    mBoard.incrementRevision();
     mGraphicsItem->updateCacheAndRepaint();
+    mBoard.scheduleItemIndexUpdate(*this);
   }
 }
 
@@ -255,6 +260,7 @@ void BI_NetLine::removeFromBoard() {
 void BI_NetLine::updateLine() noexcept {
   mPosition = (mStartPoint->getPosition() + mEndPoint->getPosition()) / 2;
   mGraphicsItem->updateCacheAndRepaint();
+  mBoard.scheduleItemIndexUpdate(*this);
 }
 
 void BI_NetLine::serialize(SExpression& root) const {
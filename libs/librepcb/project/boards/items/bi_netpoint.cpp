@@ -24,6 +24,7 @@
 
 #include "../../circuit/netsignal.h"
 #include "../../erc/ercmsg.h"
+#include "../board.h"
 #include "bi_netsegment.h"
 
 #include <QtCore>
@@ -101,7 +102,9 @@ GraphicsLayer* BI_NetPoint::getLayerOfLines() const noexcept {
 void BI_NetPoint::setPosition(const Point& position) noexcept {
   if (position != mPosition) {
     mPosition = position;
+    mBoard.incrementRevision();
     mGraphicsItem->setPos(mPosition.toPxQPointF());
+    mBoard.scheduleItemIndexUpdate(*this);
     foreach (BI_NetLine* line, mRegisteredNetLines) { line->updateLine(); }
     mBoard.scheduleAirWiresRebuild(&getNetSignalOfNetSegment());
   }
@@ -143,6 +146,7 @@ void BI_NetPoint::registerNetLine(BI_NetLine& netline) {
   mRegisteredNetLines.insert(&netline);
   netline.updateLine();
   mGraphicsItem->updateCacheAndRepaint();
+  mBoard.scheduleItemIndexUpdate(*this);
   mErcMsgDeadNetPoint->setVisible(mRegisteredNetLines.isEmpty());
 }
 
@@ -153,6 +157,7 @@ void BI_NetPoint::unregisterNetLine(BI_NetLine& netline) {
   mRegisteredNetLines.remove(&netline);
   netline.updateLine();
   mGraphicsItem->updateCacheAndRepaint();
+  mBoard.scheduleItemIndexUpdate(*this);
   mErcMsgDeadNetPoint->setVisible(mRegisteredNetLines.isEmpty());
 }
 
@@ -181,51 +181,6 @@ bool BI_NetSegment::isUsed() const noexcept {
           (!mNetLines.isEmpty()));
 }
 
-int BI_NetSegment::getViasAtScenePos(const Point&    pos,
-                                     QList<BI_Via*>& vias) const noexcept {
-  int count = 0;
-  foreach (BI_Via* via, mVias) {
-    if (via->isSelectable() &&
-        via->getGrabAreaScenePx().contains(pos.toPxQPointF())) {
-      vias.append(via);
-      ++count;
-    }
-  }
-  return count;
-}
-
-int BI_NetSegment::getNetPointsAtScenePos(const Point&         pos,
-                                          const GraphicsLayer* layer,
-                                          QList<BI_NetPoint*>& points) const
-    noexcept {
-  int count = 0;
-  foreach (BI_NetPoint* netpoint, mNetPoints) {
-    if (netpoint->isSelectable() &&
-        netpoint->getGrabAreaScenePx().contains(pos.toPxQPointF()) &&
-        ((!layer) || (netpoint->getLayerOfLines() == layer))) {
-      points.append(netpoint);
-      ++count;
-    }
-  }
-  return count;
-}
-
-int BI_NetSegment::getNetLinesAtScenePos(const Point&         pos,
-                                         const GraphicsLayer* layer,
-                                         QList<BI_NetLine*>&  lines) const
-    noexcept {
-  int count = 0;
-  foreach (BI_NetLine* netline, mNetLines) {
-    if (netline->isSelectable() &&
-        netline->getGrabAreaScenePx().contains(pos.toPxQPointF()) &&
-        ((!layer) || (&netline->getLayer() == layer))) {
-      lines.append(netline);
-      ++count;
-    }
-  }
-  return count;
-}
-
 /*******************************************************************************
  *  Setters
  ******************************************************************************/
@@ -244,6 +199,7 @@ void BI_NetSegment::setNetSignal(NetSignal& netsignal) {
       sg.dismiss();
     }
     mNetSignal = &netsignal;
+    mBoard.incrementRevision();
   }
 }
 
@@ -359,6 +315,7 @@ void BI_NetSegment::addElements(const QList<BI_Via*>&      vias,
   }
 
   sgl.dismiss();
+  mBoard.incrementRevision();
 }
 
 void BI_NetSegment::removeElements(const QList<BI_Via*>&      vias,
@@ -414,6 +371,7 @@ void BI_NetSegment::removeElements(const QList<BI_Via*>&      vias,
   }
 
   sgl.dismiss();
+  mBoard.incrementRevision();
 }
 
 /*******************************************************************************
@@ -25,6 +25,7 @@
 #include "../../circuit/circuit.h"
 #include "../../circuit/netsignal.h"
 #include "../../project.h"
+#include "../board.h"
 #include "../boardplanefragmentsbuilder.h"
 #include "../graphicsitems/bgi_plane.h"
 
@@ -55,9 +56,9 @@ BI_Plane::BI_Plane(Board& board, const BI_Plane& other)
     mConnectStyle(other.mConnectStyle),
     // mThermalGapWidth(other.mThermalGapWidth),
     // mThermalSpokeWidth(other.mThermalSpokeWidth),
-    mFragments(other.mFragments)  // also copy fragments to avoid the need for
-                                  // a rebuild
-{
+    mFragments(other.mFragments),  // also copy fragments to avoid the need
+                                   // for a rebuild
+    mFragmentsInputHash(other.mFragmentsInputHash) {
   init();
 }
 
@@ -126,14 +127,18 @@ BI_Plane::~BI_Plane() noexcept {
 void BI_Plane::setOutline(const Path& outline) noexcept {
   if (outline != mOutline) {
     mOutline = outline;
+    mBoard.incrementRevision();
     mGraphicsItem->updateCacheAndRepaint();
+    mBoard.scheduleItemIndexUpdate(*this);
   }
 }
 
 void BI_Plane::setLayerName(const GraphicsLayerName& layerName) noexcept {
   if (layerName != mLayerName) {
     mLayerName = layerName;
+    mBoard.incrementRevision();
     mGraphicsItem->updateCacheAndRepaint();
+    mBoard.scheduleItemIndexUpdate(*this);
   }
 }
 
@@ -149,36 +154,42 @@ void BI_Plane::setNetSignal(NetSignal& netsignal) {
       sg.dismiss();
     }
     mNetSignal = &netsignal;
+    mBoard.incrementRevision();
   }
 }
 
 void BI_Plane::setMinWidth(const UnsignedLength& minWidth) noexcept {
   if (minWidth != mMinWidth) {
     mMinWidth = minWidth;
+    mBoard.incrementRevision();
   }
 }
 
 void BI_Plane::setMinClearance(const UnsignedLength& minClearance) noexcept {
   if (minClearance != mMinClearance) {
     mMinClearance = minClearance;
+    mBoard.incrementRevision();
   }
 }
 
 void BI_Plane::setConnectStyle(BI_Plane::ConnectStyle style) noexcept {
   if (style != mConnectStyle) {
     mConnectStyle = style;
+    mBoard.incrementRevision();
   }
 }
 
 void BI_Plane::setPriority(int priority) noexcept {
   if (priority != mPriority) {
     mPriority = priority;
+    mBoard.incrementRevision();
   }
 }
 
 void BI_Plane::setKeepOrphans(bool keepOrphans) noexcept {
   if (keepOrphans != mKeepOrphans) {
     mKeepOrphans = keepOrphans;
+    mBoard.incrementRevision();
   }
 }
 
@@ -207,13 +218,24 @@ void BI_Plane::removeFromBoard() {
 
 void BI_Plane::clear() noexcept {
   mFragments.clear();
+  mFragmentsInputHash.clear();
   mGraphicsItem->updateCacheAndRepaint();
+  mBoard.scheduleItemIndexUpdate(*this);
 }
 
-void BI_Plane::rebuild() noexcept {
+void BI_Plane::rebuild(bool force) noexcept {
   BoardPlaneFragmentsBuilder builder(*this);
-  mFragments = builder.buildFragments();
+  if (builder.buildFragments(force)) {
+    setFragments(builder.getFragments(), builder.getInputHash());
+  }
+}
+
+void BI_Plane::setFragments(const QVector<Path>& fragments,
+                            const QByteArray&    inputHash) noexcept {
+  mFragments          = fragments;
+  mFragmentsInputHash = inputHash;
   mGraphicsItem->updateCacheAndRepaint();
+  mBoard.scheduleItemIndexUpdate(*this);
   mBoard.scheduleAirWiresRebuild(mNetSignal);
 }
 
@@ -270,6 +292,7 @@ bool BI_Plane::operator<(const BI_Plane& rhs) const noexcept {
 
 void BI_Plane::boardAttributesChanged() {
   mGraphicsItem->updateCacheAndRepaint();
+  mBoard.scheduleItemIndexUpdate(*this);
 }
 
 /*******************************************************************************
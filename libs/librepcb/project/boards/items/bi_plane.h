@@ -86,7 +86,10 @@ public:
   // {return mThermalSpokeWidth;}
   const Path&          getOutline() const noexcept { return mOutline; }
   const QVector<Path>& getFragments() const noexcept { return mFragments; }
-  bool                 isSelectable() const noexcept override;
+  const QByteArray&    getFragmentsInputHash() const noexcept {
+    return mFragmentsInputHash;
+  }
+  bool isSelectable() const noexcept override;
 
   // Setters
   void setOutline(const Path& outline) noexcept;
@@ -102,7 +105,9 @@ public:
   void addToBoard() override;
   void removeFromBoard() override;
   void clear() noexcept;
-  void rebuild() noexcept;
+  void rebuild(bool force = false) noexcept;
+  void setFragments(const QVector<Path>& fragments,
+                    const QByteArray&    inputHash) noexcept;
 
   /// @copydoc librepcb::SerializableObject::serialize()
   void serialize(SExpression& root) const override;
@@ -144,6 +149,7 @@ private:  // Data
   QScopedPointer<BGI_Plane> mGraphicsItem;
 
   QVector<Path> mFragments;
+  QByteArray    mFragmentsInputHash;  ///< See BoardPlaneFragmentsBuilder
 };
 
 /*******************************************************************************
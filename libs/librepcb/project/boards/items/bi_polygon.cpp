@@ -42,17 +42,20 @@ namespace project {
  *  Constructors / Destructor
  ******************************************************************************/
 
-BI_Polygon::BI_Polygon(Board& board, const BI_Polygon& other) : BI_Base(board) {
+BI_Polygon::BI_Polygon(Board& board, const BI_Polygon& other)
+  : BI_Base(board), mOnPolygonEditedSlot(*this, &BI_Polygon::polygonEdited) {
   mPolygon.reset(new Polygon(Uuid::createRandom(), *other.mPolygon));
   init();
 }
 
-BI_Polygon::BI_Polygon(Board& board, const SExpression& node) : BI_Base(board) {
+BI_Polygon::BI_Polygon(Board& board, const SExpression& node)
+  : BI_Base(board), mOnPolygonEditedSlot(*this, &BI_Polygon::polygonEdited) {
   mPolygon.reset(new Polygon(node));
   init();
 }
 
-BI_Polygon::BI_Polygon(Board& board, const Polygon& polygon) : BI_Base(board) {
+BI_Polygon::BI_Polygon(Board& board, const Polygon& polygon)
+  : BI_Base(board), mOnPolygonEditedSlot(*this, &BI_Polygon::polygonEdited) {
   mPolygon.reset(new Polygon(polygon));
   init();
 }
@@ -61,13 +64,14 @@ BI_Polygon::BI_Polygon(Board& board, const Uuid& uuid,
                        const GraphicsLayerName& layerName,
                        const UnsignedLength& lineWidth, bool fill,
                        bool isGrabArea, const Path& path)
-  : BI_Base(board) {
+  : BI_Base(board), mOnPolygonEditedSlot(*this, &BI_Polygon::polygonEdited) {
   mPolygon.reset(
       new Polygon(uuid, layerName, lineWidth, fill, isGrabArea, path));
   init();
 }
 
 void BI_Polygon::init() {
+  mPolygon->onEdited.attach(mOnPolygonEditedSlot);
   mGraphicsItem.reset(
       new PolygonGraphicsItem(*mPolygon, mBoard.getLayerStack()));
   mGraphicsItem->setZValue(Board::ZValue_Default);
@@ -135,6 +139,18 @@ void BI_Polygon::boardAttributesChanged() {
   mGraphicsItem->update();
 }
 
+/*******************************************************************************
+ *  Private Methods
+ ******************************************************************************/
+
+void BI_Polygon::polygonEdited(const Polygon&  polygon,
+                               Polygon::Event event) noexcept {
+  Q_UNUSED(polygon);
+  Q_UNUSED(event);
+  mBoard.incrementRevision();
+  mBoard.scheduleItemIndexUpdate(*this);
+}
+
 /*******************************************************************************
  *  End of File
  ******************************************************************************/
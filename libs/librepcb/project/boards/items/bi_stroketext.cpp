@@ -182,6 +182,12 @@ void BI_StrokeText::boardAttributesChanged() {
 void BI_StrokeText::strokeTextEdited(const StrokeText& text,
                                      StrokeText::Event event) noexcept {
   Q_UNUSED(text);
+  if (event != StrokeText::Event::PathsChanged) {
+    // paths are derived from the other properties (and attributes of the
+    // board), they are not saved
+    mBoard.incrementRevision();
+  }
+  mBoard.scheduleItemIndexUpdate(*this);
   switch (event) {
     case StrokeText::Event::LayerNameChanged:
     case StrokeText::Event::PositionChanged:
@@ -23,6 +23,7 @@
 #include "bi_via.h"
 
 #include "../../circuit/netsignal.h"
+#include "../board.h"
 #include "../boardlayerstack.h"
 #include "bi_netsegment.h"
 
@@ -136,7 +137,9 @@ QPainterPath BI_Via::toQPainterPathPx(const Length& expansion) const noexcept {
 void BI_Via::setPosition(const Point& position) noexcept {
   if (position != mPosition) {
     mPosition = position;
+    mBoard.incrementRevision();
     mGraphicsItem->setPos(mPosition.toPxQPointF());
+    mBoard.scheduleItemIndexUpdate(*this);
     foreach (BI_NetLine* netline, mRegisteredNetLines) {
       netline->updateLine();
     }
@@ -147,21 +150,27 @@ void BI_Via::setPosition(const Point& position) noexcept {
 void BI_Via::setShape(Shape shape) noexcept {
   if (shape != mShape) {
     mShape = shape;
+    mBoard.incrementRevision();
     mGraphicsItem->updateCacheAndRepaint();
+    mBoard.scheduleItemIndexUpdate(*this);
   }
 }
 
 void BI_Via::setSize(const PositiveLength& size) noexcept {
   if (size != mSize) {
     mSize = size;
+    mBoard.incrementRevision();
     mGraphicsItem->updateCacheAndRepaint();
+    mBoard.scheduleItemIndexUpdate(*this);
   }
 }
 
 void BI_Via::setDrillDiameter(const PositiveLength& diameter) noexcept {
   if (diameter != mDrillDiameter) {
     mDrillDiameter = diameter;
+    mBoard.incrementRevision();
     mGraphicsItem->updateCacheAndRepaint();
+    mBoard.scheduleItemIndexUpdate(*this);
   }
 }
 
@@ -197,6 +206,7 @@ void BI_Via::registerNetLine(BI_NetLine& netline) {
   mRegisteredNetLines.insert(&netline);
   netline.updateLine();
   mGraphicsItem->updateCacheAndRepaint();
+  mBoard.scheduleItemIndexUpdate(*this);
 }
 
 void BI_Via::unregisterNetLine(BI_NetLine& netline) {
@@ -206,6 +216,7 @@ void BI_Via::unregisterNetLine(BI_NetLine& netline) {
   mRegisteredNetLines.remove(&netline);
   netline.updateLine();
   mGraphicsItem->updateCacheAndRepaint();
+  mBoard.scheduleItemIndexUpdate(*this);
 }
 
 void BI_Via::serialize(SExpression& root) const {
@@ -239,6 +250,7 @@ void BI_Via::setSelected(bool selected) noexcept {
 
 void BI_Via::boardAttributesChanged() {
   mGraphicsItem->updateCacheAndRepaint();
+  mBoard.scheduleItemIndexUpdate(*this);
 }
 
 /*******************************************************************************
@@ -54,8 +54,7 @@ Circuit::Circuit(Project& project, bool create)
       NetClass* netclass = new NetClass(*this, ElementName("default"));
       addNetClass(*netclass);  // add a netclass with name "default"
     } else {
-      SExpression root = SExpression::parse(
-          mDirectory->read("circuit.lp"), mDirectory->getAbsPath("circuit.lp"));
+      SExpression root = mDirectory->readSExpression("circuit.lp");
 
       // OK - file is open --> now load the whole circuit stuff
 
@@ -78,9 +78,7 @@ void ErcMsgList::update(ErcMsg* ercMsg) noexcept {
 void ErcMsgList::restoreIgnoreState() {
   QString fp = "circuit/erc.lp";
   if (mProject.getDirectory().fileExists(fp)) {
-    SExpression root =
-        SExpression::parse(mProject.getDirectory().read(fp),
-                           mProject.getDirectory().getAbsPath(fp));
+    SExpression root = mProject.getDirectory().readSExpression(fp);
 
     // reset all ignore attributes
     foreach (ErcMsg* ercMsg, mItems)
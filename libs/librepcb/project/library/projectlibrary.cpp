@@ -138,6 +138,20 @@ void ProjectLibrary::save() {
   }
 }
 
+/*******************************************************************************
+ *  Static Methods
+ ******************************************************************************/
+
+QStringList ProjectLibrary::getElementFiles(
+    const TransactionalDirectory& dir) noexcept {
+  QStringList files;
+  appendElementFiles<Symbol>(dir, files);
+  appendElementFiles<Package>(dir, files);
+  appendElementFiles<Component>(dir, files);
+  appendElementFiles<Device>(dir, files);
+  return files;
+}
+
 /*******************************************************************************
  *  Private Methods
  ******************************************************************************/
@@ -203,6 +217,16 @@ void ProjectLibrary::removeElement(ElementType&               element,
   elementList.remove(element.getUuid());
 }
 
+template <typename ElementType>
+void ProjectLibrary::appendElementFiles(const TransactionalDirectory& dir,
+                                        QStringList& files) noexcept {
+  QString dirname = ElementType::getShortElementName();
+  foreach (const QString& sub, dir.getDirs(dirname)) {
+    files.append(dirname % "/" % sub % "/" %
+                 ElementType::getLongElementName() % ".lp");
+  }
+}
+
 /*******************************************************************************
  *  End of File
  ******************************************************************************/
@@ -106,6 +106,21 @@ public:
   // General Methods
   void save();
 
+  // Static Methods
+
+  /**
+   * @brief Get the main files of all library elements in a project library
+   *
+   * This allows to read and parse all library elements ahead (see
+   * librepcb::TransactionalFileSystem::preloadSExpressions()).
+   *
+   * @param dir   The "library" directory of the project.
+   *
+   * @return Paths of the main files, relative to the passed directory.
+   */
+  static QStringList getElementFiles(
+      const TransactionalDirectory& dir) noexcept;
+
 private:
   // make some methods inaccessible...
   ProjectLibrary();
@@ -121,6 +136,9 @@ private:
   template <typename ElementType>
   void removeElement(ElementType&               element,
                      QHash<Uuid, ElementType*>& elementList);
+  template <typename ElementType>
+  static void appendElementFiles(const TransactionalDirectory& dir,
+                                 QStringList&                  files) noexcept;
 
   // General
   std::unique_ptr<TransactionalDirectory> mDirectory;
@@ -106,6 +106,18 @@ Project::Project(std::unique_ptr<TransactionalDirectory> directory,
     }
   }
 
+  // Measure the time of each loading stage to find bottlenecks.
+  QElapsedTimer timer;
+  timer.start();
+  auto finishStage = [&](const QString& stage) {
+    if (!create) {
+      qint64 ms = timer.restart();
+      mLoadingTimes.append(qMakePair(stage, ms));
+      qDebug().nospace() << "Loading stage \"" << stage << "\" took " << ms
+                         << " ms.";
+    }
+  };
+
   // OK - the project is locked (or read-only) and can be opened!
   // Until this line, there was no memory allocated on the heap. But in the rest
   // of the constructor, a lot of object will be created on the heap. If an
@@ -115,6 +127,13 @@ Project::Project(std::unique_ptr<TransactionalDirectory> directory,
   // constructor.
 
   try {
+    // Read and parse all files in parallel. The objects are created in the
+    // correct order afterwards, but then the parsed files are already there.
+    if (!create) {
+      mDirectory->preloadSExpressions(getFilesToPreload());
+      finishStage("Read and parse files");
+    }
+
     // copy and/or load stroke fonts
     TransactionalDirectory fontobeneDir(*mDirectory, "resources/fontobene");
     if (create) {
@@ -127,6 +146,7 @@ Project::Project(std::unique_ptr<TransactionalDirectory> directory,
       }
     }
     mStrokeFontPool.reset(new StrokeFontPool(fontobeneDir));
+    finishStage("Stroke fonts");
 
     // Create or load metadata
     if (create) {
@@ -138,30 +158,31 @@ Project::Project(std::unique_ptr<TransactionalDirectory> directory,
           Uuid::createRandom(), ElementName(name), tr("Unknown"), "v1",
           QDateTime::currentDateTime(), QDateTime::currentDateTime()));
     } else {
-      QString     fp = "project/metadata.lp";
-      SExpression root =
-          SExpression::parse(mDirectory->read(fp), mDirectory->getAbsPath(fp));
+      SExpression root = mDirectory->readSExpression("project/metadata.lp");
       mProjectMetadata.reset(new ProjectMetadata(root));
     }
+    finishStage("Metadata");
 
     // Create all needed objects
     connect(mProjectMetadata.data(), &ProjectMetadata::attributesChanged, this,
             &Project::attributesChanged);
     mProjectSettings.reset(new ProjectSettings(*this, create));
+    finishStage("Settings");
     mProjectLibrary.reset(
         new ProjectLibrary(std::unique_ptr<TransactionalDirectory>(
             new TransactionalDirectory(*mDirectory, "library"))));
+    finishStage("Library");
     mErcMsgList.reset(new ErcMsgList(*this));
     mCircuit.reset(new Circuit(*this, create));
+    finishStage("Circuit");
 
     // Load all schematic layers
     mSchematicLayerProvider.reset(new SchematicLayerProvider(*this));
 
     // Load all schematics
     if (!create) {
-      QString     fp = "schematics/schematics.lp";
       SExpression schRoot =
-          SExpression::parse(mDirectory->read(fp), mDirectory->getAbsPath(fp));
+          mDirectory->readSExpression("schematics/schematics.lp");
       foreach (const SExpression& node, schRoot.getChildren("schematic")) {
         FilePath fp = FilePath::fromRelative(
             getPath(), node.getValueOfFirstChild<QString>());
@@ -171,13 +192,12 @@ Project::Project(std::unique_ptr<TransactionalDirectory> directory,
         addSchematic(*schematic);
       }
       qDebug() << mSchematics.count() << "schematics successfully loaded!";
+      finishStage("Schematics");
     }
 
     // Load all boards
     if (!create) {
-      QString     fp = "boards/boards.lp";
-      SExpression brdRoot =
-          SExpression::parse(mDirectory->read(fp), mDirectory->getAbsPath(fp));
+      SExpression brdRoot = mDirectory->readSExpression("boards/boards.lp");
       foreach (const SExpression& node, brdRoot.getChildren("board")) {
         FilePath fp = FilePath::fromRelative(
             getPath(), node.getValueOfFirstChild<QString>());
@@ -187,6 +207,7 @@ Project::Project(std::unique_ptr<TransactionalDirectory> directory,
         addBoard(*board);
       }
       qDebug() << mBoards.count() << "boards successfully loaded!";
+      finishStage("Boards");
     }
 
     // at this point, the whole circuit with all schematics and boards is
@@ -194,9 +215,15 @@ Project::Project(std::unique_ptr<TransactionalDirectory> directory,
     // messages. So we can now restore the ignore state of each ERC message from
     // the file.
     mErcMsgList->restoreIgnoreState();  // can throw
+    finishStage("ERC");
 
     if (create) save();  // write all files to file system
+
+    // release preloaded files which were not needed
+    mDirectory->discardPreloadedSExpressions();
   } catch (...) {
+    mDirectory->discardPreloadedSExpressions();
+
     // free the allocated memory in the reverse order of their allocation...
     foreach (Board* board, mBoards) {
       try {
@@ -612,6 +639,44 @@ QString Project::getBuiltInAttributeValue(const QString& key) const noexcept {
   }
 }
 
+/*******************************************************************************
+ *  Private Methods
+ ******************************************************************************/
+
+QStringList Project::getFilesToPreload() {
+  QStringList files = {"project/metadata.lp", "project/settings.lp",
+                       "circuit/circuit.lp"};
+  if (mDirectory->fileExists("circuit/erc.lp")) {
+    files.append("circuit/erc.lp");
+  }
+  TransactionalDirectory libDir(*mDirectory, "library");
+  foreach (const QString& fp, ProjectLibrary::getElementFiles(libDir)) {
+    files.append("library/" % fp);
+  }
+  // Schematics and boards are listed from the file system instead of parsing
+  // their index files first. Files which are not referenced by the index are
+  // released after loading.
+  files.append("schematics/schematics.lp");
+  foreach (const QString& dir, mDirectory->getDirs("schematics")) {
+    QString fp = "schematics/" % dir % "/schematic.lp";
+    if (mDirectory->fileExists(fp)) {
+      files.append(fp);
+    }
+  }
+  files.append("boards/boards.lp");
+  foreach (const QString& dir, mDirectory->getDirs("boards")) {
+    QString path = "boards/" % dir;
+    if (mDirectory->fileExists(path % "/board.lp")) {
+      files.append(path % "/board.lp");
+      files.append(path % "/settings.user.lp");
+    }
+    if (mDirectory->fileExists(path % "/" % Board::getPlanesCacheFilePath())) {
+      files.append(path % "/" % Board::getPlanesCacheFilePath());
+    }
+  }
+  return files;
+}
+
 /*******************************************************************************
  *  Static Methods
  ******************************************************************************/
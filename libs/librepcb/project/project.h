@@ -126,6 +126,16 @@ public:
 
   TransactionalDirectory& getDirectory() noexcept { return *mDirectory; }
 
+  /**
+   * @brief Get the time needed for each stage of opening the project
+   *
+   * @return Names of the loading stages and their duration in milliseconds,
+   *         in the order they were executed (empty for created projects)
+   */
+  const QList<QPair<QString, qint64>>& getLoadingTimes() const noexcept {
+    return mLoadingTimes;
+  }
+
   /**
    * @brief Get the StrokeFontPool which contains all stroke fonts of the
    * project
@@ -462,6 +472,7 @@ private:
    */
   explicit Project(std::unique_ptr<TransactionalDirectory> directory,
                    const QString& filename, bool create);
+  QStringList getFilesToPreload();
 
   std::unique_ptr<TransactionalDirectory> mDirectory;
   QString mFilename;  ///< the name of the *.lpp project file
@@ -491,6 +502,7 @@ private:
   QList<Board*> mRemovedBoards;  ///< All removed boards of this project
   QScopedPointer<AttributeList>
       mAttributes;  ///< all attributes in a specific order
+  QList<QPair<QString, qint64>> mLoadingTimes;  ///< see #getLoadingTimes()
 };
 
 /*******************************************************************************
@@ -10,7 +10,7 @@ TARGET = librepcbproject
 # Use common project definitions
 include(../../../common.pri)
 
-QT += core widgets xml sql printsupport
+QT += core widgets xml sql printsupport concurrent
 
 CONFIG += staticlib
 
@@ -25,6 +25,7 @@ SOURCES += \
     boards/boardfabricationoutputsettings.cpp \
     boards/boardgerberexport.cpp \
     boards/boardlayerstack.cpp \
+    boards/boardobstacleindex.cpp \
     boards/boardplanefragmentsbuilder.cpp \
     boards/boardselectionquery.cpp \
     boards/boardusersettings.cpp \
@@ -140,6 +141,7 @@ HEADERS += \
     boards/boardfabricationoutputsettings.h \
     boards/boardgerberexport.h \
     boards/boardlayerstack.h \
+    boards/boardobstacleindex.h \
     boards/boardplanefragmentsbuilder.h \
     boards/boardselectionquery.h \
     boards/boardusersettings.h \
@@ -69,6 +69,7 @@ Circuit& SI_Base::getCircuit() const noexcept {
 
 void SI_Base::setSelected(bool selected) noexcept {
   mIsSelected = selected;
+  mSchematic.itemSelectionChanged(*this);
 }
 
 /*******************************************************************************
@@ -81,6 +82,10 @@ void SI_Base::addToSchematic(SGI_Base* item) noexcept {
     mSchematic.getGraphicsScene().addItem(*item);
   }
   mIsAddedToSchematic = true;
+  if (item) {
+    mSchematic.scheduleItemIndexUpdate(*this);
+  }
+  mSchematic.itemSelectionChanged(*this);
 }
 
 void SI_Base::removeFromSchematic(SGI_Base* item) noexcept {
@@ -89,6 +94,8 @@ void SI_Base::removeFromSchematic(SGI_Base* item) noexcept {
     mSchematic.getGraphicsScene().removeItem(*item);
   }
   mIsAddedToSchematic = false;
+  mSchematic.scheduleItemIndexUpdate(*this);
+  mSchematic.itemSelectionChanged(*this);
 }
 
 /*******************************************************************************
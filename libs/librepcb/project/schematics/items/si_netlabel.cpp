@@ -92,7 +92,9 @@ Length SI_NetLabel::getApproximateWidth() noexcept {
 void SI_NetLabel::setPosition(const Point& position) noexcept {
   if (position != mPosition) {
     mPosition = position;
+    mSchematic.incrementRevision();
     mGraphicsItem->setPos(mPosition.toPxQPointF());
+    mSchematic.scheduleItemIndexUpdate(*this);
     updateAnchor();
   }
 }
@@ -100,8 +102,10 @@ void SI_NetLabel::setPosition(const Point& position) noexcept {
 void SI_NetLabel::setRotation(const Angle& rotation) noexcept {
   if (rotation != mRotation) {
     mRotation = rotation;
+    mSchematic.incrementRevision();
     mGraphicsItem->setRotation(-mRotation.toDeg());
     mGraphicsItem->updateCacheAndRepaint();
+    mSchematic.scheduleItemIndexUpdate(*this);
     updateAnchor();
   }
 }
@@ -119,8 +123,10 @@ void SI_NetLabel::addToSchematic() {
     throw LogicError(__FILE__, __LINE__);
   }
   mNameChangedConnection =
-      connect(&getNetSignalOfNetSegment(), &NetSignal::nameChanged,
-              [this]() { mGraphicsItem->updateCacheAndRepaint(); });
+      connect(&getNetSignalOfNetSegment(), &NetSignal::nameChanged, [this]() {
+        mGraphicsItem->updateCacheAndRepaint();
+        mSchematic.scheduleItemIndexUpdate(*this);
+      });
   mHighlightChangedConnection =
       connect(&getNetSignalOfNetSegment(), &NetSignal::highlightedChanged,
               [this]() { mGraphicsItem->update(); });
@@ -115,7 +115,9 @@ NetSignal& SI_NetLine::getNetSignalOfNetSegment() const noexcept {
 void SI_NetLine::setWidth(const UnsignedLength& width) noexcept {
   if (width != mWidth) {
     mWidth = width;
+    mSchematic.incrementRevision();
     mGraphicsItem->updateCacheAndRepaint();
+    mSchematic.scheduleItemIndexUpdate(*this);
   }
 }
 
@@ -156,6 +158,7 @@ void SI_NetLine::removeFromSchematic() {
 void SI_NetLine::updateLine() noexcept {
   mPosition = (mStartPoint->getPosition() + mEndPoint->getPosition()) / 2;
   mGraphicsItem->updateCacheAndRepaint();
+  mSchematic.scheduleItemIndexUpdate(*this);
 }
 
 void SI_NetLine::serialize(SExpression& root) const {
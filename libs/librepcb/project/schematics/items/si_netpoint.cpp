@@ -24,6 +24,7 @@
 
 #include "../../circuit/netsignal.h"
 #include "../../erc/ercmsg.h"
+#include "../schematic.h"
 #include "si_netsegment.h"
 
 #include <QtCore>
@@ -95,7 +96,9 @@ NetSignal& SI_NetPoint::getNetSignalOfNetSegment() const noexcept {
 void SI_NetPoint::setPosition(const Point& position) noexcept {
   if (position != mPosition) {
     mPosition = position;
+    mSchematic.incrementRevision();
     mGraphicsItem->setPos(mPosition.toPxQPointF());
+    mSchematic.scheduleItemIndexUpdate(*this);
     foreach (SI_NetLine* line, mRegisteredNetLines) { line->updateLine(); }
   }
 }
@@ -132,6 +135,7 @@ void SI_NetPoint::registerNetLine(SI_NetLine& netline) {
   mRegisteredNetLines.insert(&netline);
   netline.updateLine();
   mGraphicsItem->updateCacheAndRepaint();
+  mSchematic.scheduleItemIndexUpdate(*this);
   mErcMsgDeadNetPoint->setVisible(mRegisteredNetLines.isEmpty());
 }
 
@@ -142,6 +146,7 @@ void SI_NetPoint::unregisterNetLine(SI_NetLine& netline) {
   mRegisteredNetLines.remove(&netline);
   netline.updateLine();
   mGraphicsItem->updateCacheAndRepaint();
+  mSchematic.scheduleItemIndexUpdate(*this);
   mErcMsgDeadNetPoint->setVisible(mRegisteredNetLines.isEmpty());
 }
 
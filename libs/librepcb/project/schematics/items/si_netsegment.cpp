@@ -143,45 +143,6 @@ bool SI_NetSegment::isUsed() const noexcept {
           (!mNetLabels.isEmpty()));
 }
 
-int SI_NetSegment::getNetPointsAtScenePos(const Point&         pos,
-                                          QList<SI_NetPoint*>& points) const
-    noexcept {
-  int count = 0;
-  foreach (SI_NetPoint* netpoint, mNetPoints) {
-    if (netpoint->getGrabAreaScenePx().contains(pos.toPxQPointF())) {
-      points.append(netpoint);
-      ++count;
-    }
-  }
-  return count;
-}
-
-int SI_NetSegment::getNetLinesAtScenePos(const Point&        pos,
-                                         QList<SI_NetLine*>& lines) const
-    noexcept {
-  int count = 0;
-  foreach (SI_NetLine* netline, mNetLines) {
-    if (netline->getGrabAreaScenePx().contains(pos.toPxQPointF())) {
-      lines.append(netline);
-      ++count;
-    }
-  }
-  return count;
-}
-
-int SI_NetSegment::getNetLabelsAtScenePos(const Point&         pos,
-                                          QList<SI_NetLabel*>& labels) const
-    noexcept {
-  int count = 0;
-  foreach (SI_NetLabel* netlabel, mNetLabels) {
-    if (netlabel->getGrabAreaScenePx().contains(pos.toPxQPointF())) {
-      labels.append(netlabel);
-      ++count;
-    }
-  }
-  return count;
-}
-
 QSet<QString> SI_NetSegment::getForcedNetNames() const noexcept {
   QSet<QString> names;
   foreach (SI_NetLine* netline, mNetLines) {
@@ -261,6 +222,7 @@ void SI_NetSegment::setNetSignal(NetSignal& netsignal) {
       sg.dismiss();
     }
     mNetSignal = &netsignal;
+    mSchematic.incrementRevision();
   }
 }
 
@@ -347,6 +309,7 @@ void SI_NetSegment::addNetPointsAndNetLines(
   updateAllNetLabelAnchors();
 
   sgl.dismiss();
+  mSchematic.incrementRevision();
 }
 
 void SI_NetSegment::removeNetPointsAndNetLines(
@@ -391,6 +354,7 @@ void SI_NetSegment::removeNetPointsAndNetLines(
   updateAllNetLabelAnchors();
 
   sgl.dismiss();
+  mSchematic.incrementRevision();
 }
 
 /*******************************************************************************
@@ -419,6 +383,7 @@ void SI_NetSegment::addNetLabel(SI_NetLabel& netlabel) {
   // add to schematic
   netlabel.addToSchematic();  // can throw
   mNetLabels.append(&netlabel);
+  mSchematic.incrementRevision();
 }
 
 void SI_NetSegment::removeNetLabel(SI_NetLabel& netlabel) {
@@ -428,6 +393,7 @@ void SI_NetSegment::removeNetLabel(SI_NetLabel& netlabel) {
   // remove from schematic
   netlabel.removeFromSchematic();  // can throw
   mNetLabels.removeOne(&netlabel);
+  mSchematic.incrementRevision();
 }
 
 void SI_NetSegment::updateAllNetLabelAnchors() noexcept {
@@ -490,24 +456,6 @@ void SI_NetSegment::removeFromSchematic() {
   sgl.dismiss();
 }
 
-void SI_NetSegment::setSelectionRect(const QRectF rectPx) noexcept {
-  foreach (SI_NetPoint* netpoint, mNetPoints)
-    netpoint->setSelected(netpoint->getGrabAreaScenePx().intersects(rectPx));
-  foreach (SI_NetLine* netline, mNetLines)
-    netline->setSelected(netline->getGrabAreaScenePx().intersects(rectPx));
-  foreach (SI_NetLabel* netlabel, mNetLabels)
-    netlabel->setSelected(netlabel->getGrabAreaScenePx().intersects(rectPx));
-}
-
-void SI_NetSegment::clearSelection() const noexcept {
-  foreach (SI_NetPoint* netpoint, mNetPoints)
-    netpoint->setSelected(false);
-  foreach (SI_NetLine* netline, mNetLines)
-    netline->setSelected(false);
-  foreach (SI_NetLabel* netlabel, mNetLabels)
-    netlabel->setSelected(false);
-}
-
 void SI_NetSegment::serialize(SExpression& root) const {
   if (!checkAttributesValidity()) throw LogicError(__FILE__, __LINE__);
 
@@ -151,8 +151,10 @@ QString SI_Symbol::getName() const noexcept {
 void SI_Symbol::setPosition(const Point& newPos) noexcept {
   if (newPos != mPosition) {
     mPosition = newPos;
+    mSchematic.incrementRevision();
     mGraphicsItem->setPos(newPos.toPxQPointF());
     mGraphicsItem->updateCacheAndRepaint();
+    mSchematic.scheduleItemIndexUpdate(*this);
     foreach (SI_SymbolPin* pin, mPins) { pin->updatePosition(); }
   }
 }
@@ -160,8 +162,10 @@ void SI_Symbol::setPosition(const Point& newPos) noexcept {
 void SI_Symbol::setRotation(const Angle& newRotation) noexcept {
   if (newRotation != mRotation) {
     mRotation = newRotation;
+    mSchematic.incrementRevision();
     updateGraphicsItemTransform();
     mGraphicsItem->updateCacheAndRepaint();
+    mSchematic.scheduleItemIndexUpdate(*this);
     foreach (SI_SymbolPin* pin, mPins) { pin->updatePosition(); }
   }
 }
@@ -169,8 +173,10 @@ void SI_Symbol::setRotation(const Angle& newRotation) noexcept {
 void SI_Symbol::setMirrored(bool newMirrored) noexcept {
   if (newMirrored != mMirrored) {
     mMirrored = newMirrored;
+    mSchematic.incrementRevision();
     updateGraphicsItemTransform();
     mGraphicsItem->updateCacheAndRepaint();
+    mSchematic.scheduleItemIndexUpdate(*this);
     foreach (SI_SymbolPin* pin, mPins) { pin->updatePosition(); }
   }
 }
@@ -271,6 +277,7 @@ void SI_Symbol::setSelected(bool selected) noexcept {
 
 void SI_Symbol::schematicOrComponentAttributesChanged() {
   mGraphicsItem->updateCacheAndRepaint();
+  mSchematic.scheduleItemIndexUpdate(*this);
 }
 
 /*******************************************************************************
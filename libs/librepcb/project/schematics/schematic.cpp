@@ -59,8 +59,11 @@ Schematic::Schematic(Project&                                project,
     mProject(project),
     mDirectory(std::move(directory)),
     mIsAddedToProject(false),
+    mRevision(1),
+    mSavedRevision(0),
     mUuid(Uuid::createRandom()),
-    mName("New Page") {
+    mName("New Page"),
+    mItemIndex(PositiveLength(5080000)) {
   try {
     mGraphicsScene.reset(new GraphicsScene());
 
@@ -72,8 +75,8 @@ Schematic::Schematic(Project&                                project,
       // load default grid properties
       mGridProperties.reset(new GridProperties());
     } else {
-      SExpression root = SExpression::parse(
-          mDirectory->read(getFilePath().getFilename()), getFilePath());
+      SExpression root =
+          mDirectory->readSExpression(getFilePath().getFilename());
 
       // the schematic seems to be ready to open, so we will create all needed
       // objects
@@ -177,7 +180,19 @@ QList<SI_Base*> Schematic::getItemsAtScenePos(const Point& pos) const noexcept {
     list.append(netlabel);
   }
   // symbols & pins
-  foreach (SI_Symbol* symbol, mSymbols) {
+  QList<SI_Symbol*> symbols;
+  foreach (SI_Base* item, getItemIndexCandidates(pos, pos)) {
+    SI_Symbol* symbol = nullptr;
+    if (item->getType() == SI_Base::Type_t::Symbol) {
+      symbol = static_cast<SI_Symbol*>(item);
+    } else if (item->getType() == SI_Base::Type_t::SymbolPin) {
+      symbol = &static_cast<SI_SymbolPin*>(item)->getSymbol();
+    }
+    if (symbol && (!symbols.contains(symbol))) {
+      symbols.append(symbol);
+    }
+  }
+  foreach (SI_Symbol* symbol, symbols) {
     foreach (SI_SymbolPin* pin, symbol->getPins()) {
       if (pin->getGrabAreaScenePx().contains(scenePosPx)) list.append(pin);
     }
@@ -189,8 +204,11 @@ QList<SI_Base*> Schematic::getItemsAtScenePos(const Point& pos) const noexcept {
 QList<SI_NetPoint*> Schematic::getNetPointsAtScenePos(const Point& pos) const
     noexcept {
   QList<SI_NetPoint*> list;
-  foreach (SI_NetSegment* segment, mNetSegments) {
-    segment->getNetPointsAtScenePos(pos, list);
+  foreach (SI_Base* item, getItemIndexCandidates(pos, pos)) {
+    if ((item->getType() == SI_Base::Type_t::NetPoint) &&
+        item->getGrabAreaScenePx().contains(pos.toPxQPointF())) {
+      list.append(static_cast<SI_NetPoint*>(item));
+    }
   }
   return list;
 }
@@ -198,8 +216,11 @@ QList<SI_NetPoint*> Schematic::getNetPointsAtScenePos(const Point& pos) const
 QList<SI_NetLine*> Schematic::getNetLinesAtScenePos(const Point& pos) const
     noexcept {
   QList<SI_NetLine*> list;
-  foreach (SI_NetSegment* segment, mNetSegments) {
-    segment->getNetLinesAtScenePos(pos, list);
+  foreach (SI_Base* item, getItemIndexCandidates(pos, pos)) {
+    if ((item->getType() == SI_Base::Type_t::NetLine) &&
+        item->getGrabAreaScenePx().contains(pos.toPxQPointF())) {
+      list.append(static_cast<SI_NetLine*>(item));
+    }
   }
   return list;
 }
@@ -207,8 +228,11 @@ QList<SI_NetLine*> Schematic::getNetLinesAtScenePos(const Point& pos) const
 QList<SI_NetLabel*> Schematic::getNetLabelsAtScenePos(const Point& pos) const
     noexcept {
   QList<SI_NetLabel*> list;
-  foreach (SI_NetSegment* segment, mNetSegments) {
-    segment->getNetLabelsAtScenePos(pos, list);
+  foreach (SI_Base* item, getItemIndexCandidates(pos, pos)) {
+    if ((item->getType() == SI_Base::Type_t::NetLabel) &&
+        item->getGrabAreaScenePx().contains(pos.toPxQPointF())) {
+      list.append(static_cast<SI_NetLabel*>(item));
+    }
   }
   return list;
 }
@@ -216,10 +240,10 @@ QList<SI_NetLabel*> Schematic::getNetLabelsAtScenePos(const Point& pos) const
 QList<SI_SymbolPin*> Schematic::getPinsAtScenePos(const Point& pos) const
     noexcept {
   QList<SI_SymbolPin*> list;
-  foreach (SI_Symbol* symbol, mSymbols) {
-    foreach (SI_SymbolPin* pin, symbol->getPins()) {
-      if (pin->getGrabAreaScenePx().contains(pos.toPxQPointF()))
-        list.append(pin);
+  foreach (SI_Base* item, getItemIndexCandidates(pos, pos)) {
+    if ((item->getType() == SI_Base::Type_t::SymbolPin) &&
+        item->getGrabAreaScenePx().contains(pos.toPxQPointF())) {
+      list.append(static_cast<SI_SymbolPin*>(item));
     }
   }
   return list;
@@ -231,6 +255,7 @@ QList<SI_SymbolPin*> Schematic::getPinsAtScenePos(const Point& pos) const
 
 void Schematic::setGridProperties(const GridProperties& grid) noexcept {
   *mGridProperties = grid;
+  incrementRevision();
 }
 
 /*******************************************************************************
@@ -259,6 +284,7 @@ void Schematic::addSymbol(SI_Symbol& symbol) {
   // add to schematic
   symbol.addToSchematic();  // can throw
   mSymbols.append(&symbol);
+  incrementRevision();
 }
 
 void Schematic::removeSymbol(SI_Symbol& symbol) {
@@ -268,6 +294,7 @@ void Schematic::removeSymbol(SI_Symbol& symbol) {
   // remove from schematic
   symbol.removeFromSchematic();  // can throw
   mSymbols.removeOne(&symbol);
+  incrementRevision();
 }
 
 /*******************************************************************************
@@ -296,6 +323,7 @@ void Schematic::addNetSegment(SI_NetSegment& netsegment) {
   // add to schematic
   netsegment.addToSchematic();  // can throw
   mNetSegments.append(&netsegment);
+  incrementRevision();
 }
 
 void Schematic::removeNetSegment(SI_NetSegment& netsegment) {
@@ -305,6 +333,35 @@ void Schematic::removeNetSegment(SI_NetSegment& netsegment) {
   // remove from schematic
   netsegment.removeFromSchematic();  // can throw
   mNetSegments.removeOne(&netsegment);
+  incrementRevision();
+}
+
+/*******************************************************************************
+ *  Spatial Index Methods
+ ******************************************************************************/
+
+void Schematic::scheduleItemIndexUpdate(SI_Base& item) noexcept {
+  if (item.isAddedToSchematic()) {
+    if (!mItemIndexQueueSet.contains(&item)) {
+      mItemIndexQueue.append(&item);
+      mItemIndexQueueSet.insert(&item);
+    }
+  } else {
+    // remove immediately since the item might be deleted afterwards
+    if (mItemIndexQueueSet.remove(&item)) {
+      mItemIndexQueue.removeOne(&item);
+    }
+    mItemIndex.remove(&item);
+  }
+}
+
+void Schematic::itemSelectionChanged(SI_Base& item) noexcept {
+  if (item.isAddedToSchematic() && item.isSelected() &&
+      (item.getType() != SI_Base::Type_t::NetSegment)) {
+    mSelectedItems.insert(&item);
+  } else {
+    mSelectedItems.remove(&item);
+  }
 }
 
 /*******************************************************************************
@@ -352,12 +409,17 @@ void Schematic::removeFromProject() {
 
 void Schematic::save() {
   if (mIsAddedToProject) {
-    // save schematic file
-    SExpression doc(serializeToDomElement("librepcb_schematic"));  // can throw
-    mDirectory->write(getFilePath().getFilename(),
-                      doc.toByteArray());  // can throw
+    // save schematic file (only if it was modified since the last save)
+    if (mRevision != mSavedRevision) {
+      SExpression doc(
+          serializeToDomElement("librepcb_schematic"));  // can throw
+      mDirectory->write(getFilePath().getFilename(),
+                        doc.toByteArray());  // can throw
+      mSavedRevision = mRevision;
+    }
   } else {
     mDirectory->removeDirRecursively();  // can throw
+    mSavedRevision = 0;  // schematic file needs to be written when re-added
   }
 }
 
@@ -370,23 +432,28 @@ void Schematic::setSelectionRect(const Point& p1, const Point& p2,
   mGraphicsScene->setSelectionRect(p1, p2);
   if (updateItems) {
     QRectF rectPx = QRectF(p1.toPxQPointF(), p2.toPxQPointF()).normalized();
-    foreach (SI_Symbol* symbol, mSymbols) {
-      bool selectSymbol = symbol->getGrabAreaScenePx().intersects(rectPx);
-      symbol->setSelected(selectSymbol);
-      foreach (SI_SymbolPin* pin, symbol->getPins()) {
-        bool selectPin = pin->getGrabAreaScenePx().intersects(rectPx);
-        pin->setSelected(selectSymbol || selectPin);
+    QSet<SI_Base*> items;
+    foreach (SI_Base* item, getItemIndexCandidates(p1, p2)) {
+      if (item->getGrabAreaScenePx().intersects(rectPx)) {
+        items.insert(item);
+        if (item->getType() == SI_Base::Type_t::Symbol) {
+          foreach (SI_SymbolPin* pin,
+                   static_cast<SI_Symbol*>(item)->getPins()) {
+            items.insert(pin);
+          }
+        }
       }
     }
-    foreach (SI_NetSegment* segment, mNetSegments) {
-      segment->setSelectionRect(rectPx);
+    // deselect first since deselecting a symbol also deselects its pins
+    foreach (SI_Base* item, mSelectedItems - items) {
+      item->setSelected(false);
     }
+    foreach (SI_Base* item, items) { item->setSelected(true); }
   }
 }
 
 void Schematic::clearSelection() const noexcept {
-  foreach (SI_Symbol* symbol, mSymbols) { symbol->setSelected(false); }
-  foreach (SI_NetSegment* segment, mNetSegments) { segment->clearSelection(); }
+  foreach (SI_Base* item, mSelectedItems) { item->setSelected(false); }
 }
 
 void Schematic::updateAllNetLabelAnchors() noexcept {
@@ -404,7 +471,7 @@ void Schematic::renderToQPainter(QPainter& painter) const noexcept {
 std::unique_ptr<SchematicSelectionQuery> Schematic::createSelectionQuery() const
     noexcept {
   return std::unique_ptr<SchematicSelectionQuery>(new SchematicSelectionQuery(
-      mSymbols, mNetSegments, const_cast<Schematic*>(this)));
+      mSelectedItems, const_cast<Schematic*>(this)));
 }
 
 /*******************************************************************************
@@ -434,6 +501,22 @@ void Schematic::updateIcon() noexcept {
   mIcon = QIcon(mGraphicsScene->toPixmap(QSize(297, 210), Qt::white));
 }
 
+QList<SI_Base*> Schematic::getItemIndexCandidates(const Point& p1,
+                                                  const Point& p2) const
+    noexcept {
+  // update the bounding rects of all modified items
+  foreach (SI_Base* item, mItemIndexQueue) {
+    qreal  margin = Length(1000).toPx();  // compensate rounding errors
+    QRectF rect   = item->getGrabAreaScenePx().boundingRect().adjusted(
+        -margin, -margin, margin, margin);
+    mItemIndex.insert(item, Point::fromPx(rect.topLeft()),
+                      Point::fromPx(rect.bottomRight()));
+  }
+  mItemIndexQueue.clear();
+  mItemIndexQueueSet.clear();
+  return mItemIndex.query(p1, p2);
+}
+
 void Schematic::serialize(SExpression& root) const {
   root.appendChild(mUuid);
   root.appendChild("name", mName, true);
@@ -30,6 +30,7 @@
 #include <librepcb/common/fileio/serializableobject.h>
 #include <librepcb/common/fileio/transactionaldirectory.h>
 #include <librepcb/common/units/all_length_units.h>
+#include <librepcb/common/utils/spatialindex.h>
 #include <librepcb/common/uuid.h>
 
 #include <QtCore>
@@ -132,6 +133,15 @@ public:
   // Setters: General
   void setGridProperties(const GridProperties& grid) noexcept;
 
+  /**
+   * @brief Mark the schematic file as modified
+   *
+   * Must be called by every operation which modifies the content of the
+   * schematic file. Only schematics with a modified revision are serialized
+   * again by #save().
+   */
+  void incrementRevision() noexcept { ++mRevision; }
+
   // Getters: Attributes
   const Uuid&        getUuid() const noexcept { return mUuid; }
   const ElementName& getName() const noexcept { return mName; }
@@ -148,6 +158,31 @@ public:
   void           addNetSegment(SI_NetSegment& netsegment);
   void           removeNetSegment(SI_NetSegment& netsegment);
 
+  // Spatial Index Methods
+
+  /**
+   * @brief Notify the schematic that the grab area of an item has changed
+   *
+   * Must be called by items whenever they are added to or removed from the
+   * schematic, or their grab area was moved or resized. The spatial index
+   * used by the *AtScenePos() methods and #setSelectionRect() is then
+   * updated on the next lookup.
+   *
+   * @param item    The modified item.
+   */
+  void scheduleItemIndexUpdate(SI_Base& item) noexcept;
+
+  /**
+   * @brief Notify the schematic that the selection state of an item changed
+   *
+   * Called by ::librepcb::project::SI_Base to keep track of all selected
+   * items, so clearing the selection or building a ::librepcb::project::
+   * SchematicSelectionQuery doesn't need to look at every item.
+   *
+   * @param item    The modified item.
+   */
+  void itemSelectionChanged(SI_Base& item) noexcept;
+
   // General Methods
   void addToProject();
   void removeFromProject();
@@ -188,7 +223,9 @@ signals:
 private:
   Schematic(Project& project, std::unique_ptr<TransactionalDirectory> directory,
             bool create, const QString& newName);
-  void updateIcon() noexcept;
+  void            updateIcon() noexcept;
+  QList<SI_Base*> getItemIndexCandidates(const Point& p1, const Point& p2) const
+      noexcept;
 
   /// @copydoc librepcb::SerializableObject::serialize()
   void serialize(SExpression& root) const override;
@@ -197,6 +234,8 @@ private:
   Project& mProject;  ///< A reference to the Project object (from the ctor)
   std::unique_ptr<TransactionalDirectory> mDirectory;
   bool                                    mIsAddedToProject;
+  quint64 mRevision;       ///< Incremented on every modification
+  quint64 mSavedRevision;  ///< Revision of the last written schematic file
 
   QScopedPointer<GraphicsScene>  mGraphicsScene;
   QScopedPointer<GridProperties> mGridProperties;
@@ -209,6 +248,12 @@ private:
 
   QList<SI_Symbol*>     mSymbols;
   QList<SI_NetSegment*> mNetSegments;
+  QSet<SI_Base*>        mSelectedItems;
+
+  // Spatial index of all items (updated lazily on lookups)
+  mutable SpatialIndex<SI_Base*> mItemIndex;
+  mutable QList<SI_Base*>        mItemIndexQueue;  ///< Ordered like added
+  mutable QSet<SI_Base*>         mItemIndexQueueSet;
 };
 
 /*******************************************************************************
@@ -33,6 +33,7 @@
 namespace librepcb {
 namespace project {
 
+class SI_Base;
 class SI_Symbol;
 class SI_SymbolPin;
 class SI_NetSegment;
@@ -54,9 +55,8 @@ public:
   // Constructors / Destructor
   SchematicSelectionQuery()                                     = delete;
   SchematicSelectionQuery(const SchematicSelectionQuery& other) = delete;
-  SchematicSelectionQuery(const QList<SI_Symbol*>&     symbols,
-                          const QList<SI_NetSegment*>& netsegments,
-                          QObject*                     parent = nullptr);
+  SchematicSelectionQuery(const QSet<SI_Base*>& selectedItems,
+                          QObject*              parent = nullptr);
   ~SchematicSelectionQuery() noexcept;
 
   // Getters
@@ -86,9 +86,8 @@ public:
       delete;
 
 private:
-  // references to the Schematic object
-  const QList<SI_Symbol*>&     mSymbols;
-  const QList<SI_NetSegment*>& mNetSegments;
+  // selected items of the Schematic object
+  const QSet<SI_Base*> mSelectedItems;
 
   // query result
   QSet<SI_Symbol*>   mResultSymbols;
@@ -47,10 +47,8 @@ ProjectSettings::ProjectSettings(Project& project, bool create)
 
   // load settings from file
   if (!create) {
-    QString     fp = "project/settings.lp";
     SExpression root =
-        SExpression::parse(mProject.getDirectory().read(fp),
-                           mProject.getDirectory().getAbsPath(fp));
+        mProject.getDirectory().readSExpression("project/settings.lp");
 
     // OK - file is open --> now load all settings
 
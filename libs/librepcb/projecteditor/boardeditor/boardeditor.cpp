@@ -514,7 +514,7 @@ void BoardEditor::on_actionModifyDesignRules_triggered() {
 void BoardEditor::on_actionRebuildPlanes_triggered() {
   Board* board = getActiveBoard();
   if (board) {
-    board->rebuildAllPlanes();
+    board->rebuildAllPlanes(true);
     board->forceAirWiresRebuild();
   }
 }
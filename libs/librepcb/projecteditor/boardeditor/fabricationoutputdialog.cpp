@@ -77,6 +77,7 @@ FabricationOutputDialog::FabricationOutputDialog(Board& board, QWidget* parent)
   mUi->edtSuffixSolderPasteTop->setText(s.getSuffixSolderPasteTop());
   mUi->edtSuffixSolderPasteBot->setText(s.getSuffixSolderPasteBot());
   mUi->cbxDrillsMerge->setChecked(s.getMergeDrillFiles());
+  mUi->cbxDrillsOptimize->setChecked(s.getOptimizeDrillOrder());
   mUi->cbxSolderPasteTop->setChecked(s.getEnableSolderPasteTop());
   mUi->cbxSolderPasteBot->setChecked(s.getEnableSolderPasteBot());
 
@@ -164,10 +165,12 @@ void FabricationOutputDialog::on_btnGenerate_clicked() {
     s.setSilkscreenLayersTop(getTopSilkscreenLayers());
     s.setSilkscreenLayersBot(getBotSilkscreenLayers());
     s.setMergeDrillFiles(mUi->cbxDrillsMerge->isChecked());
+    s.setOptimizeDrillOrder(mUi->cbxDrillsOptimize->isChecked());
     s.setEnableSolderPasteTop(mUi->cbxSolderPasteTop->isChecked());
     s.setEnableSolderPasteBot(mUi->cbxSolderPasteBot->isChecked());
     if (s != mBoard.getFabricationOutputSettings()) {
       mBoard.getFabricationOutputSettings() = s;  // TODO: use undo command
+      mBoard.incrementRevision();
     }
 
     // generate files
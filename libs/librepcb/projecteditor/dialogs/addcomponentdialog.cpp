@@ -71,6 +71,7 @@ AddComponentDialog::AddComponentDialog(workspace::Workspace& workspace,
     mComponentPreviewScene(nullptr),
     mDevicePreviewScene(nullptr),
     mCategoryTreeModel(nullptr),
+    mSearch(workspace.getLibraryDb()),
     mSelectedComponent(nullptr),
     mSelectedSymbVar(nullptr),
     mSelectedDevice(nullptr),
@@ -87,6 +88,10 @@ AddComponentDialog::AddComponentDialog(workspace::Workspace& workspace,
   mUi->cbxSymbVar->hide();
   connect(mUi->edtSearch, &QLineEdit::textChanged, this,
           &AddComponentDialog::searchEditTextChanged);
+  mSearch.addElementType<library::Device>();
+  mSearch.addElementType<library::Component>();
+  connect(&mSearch, &workspace::WorkspaceLibrarySearch::finished, this,
+          &AddComponentDialog::searchFinished);
   connect(mUi->treeComponents, &QTreeWidget::currentItemChanged, this,
           &AddComponentDialog::treeComponents_currentItemChanged);
   connect(mUi->treeComponents, &QTreeWidget::itemDoubleClicked, this,
@@ -262,9 +267,23 @@ void AddComponentDialog::searchComponents(const QString& input) {
   setSelectedComponent(nullptr);
   mUi->treeComponents->clear();
 
-  // min. 2 chars to avoid freeze on entering first character due to huge result
+  // min. 2 chars to avoid huge results on entering the first character
   if (input.length() > 1) {
-    SearchResult result = searchComponentsAndDevices(input);
+    mSearch.start(input);  // the result is added in searchFinished()
+  } else {
+    mSearch.cancel();
+  }
+}
+
+void AddComponentDialog::searchFinished(
+    const workspace::WorkspaceLibrarySearch::Result& searchResult) noexcept {
+  try {
+    if (!searchResult.error.isEmpty()) {
+      throw RuntimeError(__FILE__, __LINE__, searchResult.error);
+    }
+    SearchResult result =
+        searchComponentsAndDevices(searchResult.get<library::Device>(),
+                                   searchResult.get<library::Component>());
     QHashIterator<FilePath, SearchResultComponent> cmpIt(result);
     while (cmpIt.hasNext()) {
       cmpIt.next();
@@ -284,20 +303,18 @@ void AddComponentDialog::searchComponents(const QString& input) {
       cmpItem->setTextAlignment(1, Qt::AlignRight);
       cmpItem->setExpanded(!cmpIt.value().match);
     }
+    mUi->treeComponents->sortByColumn(0, Qt::AscendingOrder);
+  } catch (const Exception& e) {
+    QMessageBox::critical(this, tr("Error"), e.getMsg());
   }
-
-  mUi->treeComponents->sortByColumn(0, Qt::AscendingOrder);
 }
 
 AddComponentDialog::SearchResult AddComponentDialog::searchComponentsAndDevices(
-    const QString& input) {
+    const QList<Uuid>& devices, const QList<Uuid>& components) {
   SearchResult       result;
   const QStringList& localeOrder = mProject.getSettings().getLocaleOrder();
 
   // add matching devices and their corresponding components
-  QList<Uuid> devices =
-      mWorkspace.getLibraryDb().getElementsBySearchKeyword<library::Device>(
-          input);  // can throw
   foreach (const Uuid& devUuid, devices) {
     FilePath devFp =
         mWorkspace.getLibraryDb().getLatestDevice(devUuid);  // can throw
@@ -317,9 +334,6 @@ AddComponentDialog::SearchResult AddComponentDialog::searchComponentsAndDevices(
   }
 
   // add matching components and all their devices
-  QList<Uuid> components =
-      mWorkspace.getLibraryDb().getElementsBySearchKeyword<library::Component>(
-          input);  // can throw
   foreach (const Uuid& cmpUuid, components) {
     FilePath cmpFp =
         mWorkspace.getLibraryDb().getLatestComponent(cmpUuid);  // can throw
@@ -369,6 +383,7 @@ void AddComponentDialog::setSelectedCategory(
     const tl::optional<Uuid>& categoryUuid) {
   setSelectedComponent(nullptr);
   mUi->treeComponents->clear();
+  mSearch.cancel();
 
   const QStringList& localeOrder = mProject.getSettings().getLocaleOrder();
 
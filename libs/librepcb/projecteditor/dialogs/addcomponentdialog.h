@@ -27,6 +27,7 @@
 #include <librepcb/common/fileio/filepath.h>
 #include <librepcb/common/uuid.h>
 #include <librepcb/workspace/library/cat/categorytreemodel.h>
+#include <librepcb/workspace/library/workspacelibrarysearch.h>
 
 #include <QtCore>
 #include <QtWidgets>
@@ -114,7 +115,10 @@ private slots:
 private:
   // Private Methods
   void         searchComponents(const QString& input);
-  SearchResult searchComponentsAndDevices(const QString& input);
+  void         searchFinished(
+      const workspace::WorkspaceLibrarySearch::Result& searchResult) noexcept;
+  SearchResult searchComponentsAndDevices(const QList<Uuid>& devices,
+                                          const QList<Uuid>& components);
   void         setSelectedCategory(const tl::optional<Uuid>& categoryUuid);
   void         setSelectedComponent(const library::Component* cmp);
   void setSelectedSymbVar(const library::ComponentSymbolVariant* symbVar);
@@ -129,6 +133,7 @@ private:
   GraphicsScene*                               mDevicePreviewScene;
   QScopedPointer<DefaultGraphicsLayerProvider> mGraphicsLayerProvider;
   workspace::ComponentCategoryTreeModel*       mCategoryTreeModel;
+  workspace::WorkspaceLibrarySearch            mSearch;
 
   // Attributes
   tl::optional<Uuid>                         mSelectedCategoryUuid;
@@ -114,7 +114,7 @@ void FavoriteProjectsModel::save() noexcept {
       root.appendChild("project", filepath.toRelative(mWorkspace.getPath()),
                        true);
     }
-    FileUtils::writeFile(mFilePath, root.toByteArray());  // can throw
+    FileUtils::writeFile(mFilePath, root);  // can throw
   } catch (Exception& e) {
     qWarning() << "Could not save favorite projects file:" << e.getMsg();
   }
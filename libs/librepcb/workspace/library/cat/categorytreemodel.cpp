@@ -43,8 +43,12 @@ CategoryTreeModel<ElementType>::CategoryTreeModel(
     const WorkspaceLibraryDb& library, const QStringList& localeOrder,
     CategoryTreeFilter::Flags filter) noexcept
   : QAbstractItemModel(nullptr) {
-  mRootItem.reset(new CategoryTreeItem<ElementType>(
-      library, localeOrder, nullptr, tl::nullopt, filter));
+  QObject::connect(&mWatcher, &QFutureWatcher<RootItem>::finished, this,
+                   [this]() { rootItemLoaded(); });
+  mWatcher.setFuture(library.runAsync([&library, localeOrder, filter]() {
+    return RootItem(new CategoryTreeItem<ElementType>(
+        library, localeOrder, nullptr, tl::nullopt, filter));
+  }));
 }
 
 template <typename ElementType>
@@ -63,7 +67,7 @@ CategoryTreeItem<ElementType>* CategoryTreeModel<ElementType>::getItem(
         static_cast<CategoryTreeItem<ElementType>*>(index.internalPointer());
     if (item) return item;
   }
-  return mRootItem.data();
+  return mRootItem.data();  // nullptr if not loaded yet
 }
 
 /*******************************************************************************
@@ -74,13 +78,13 @@ template <typename ElementType>
 int CategoryTreeModel<ElementType>::columnCount(
     const QModelIndex& parent) const {
   Q_UNUSED(parent);
-  return mRootItem->getColumnCount();
+  return mRootItem ? mRootItem->getColumnCount() : 1;
 }
 
 template <typename ElementType>
 int CategoryTreeModel<ElementType>::rowCount(const QModelIndex& parent) const {
   CategoryTreeItem<ElementType>* parentItem = getItem(parent);
-  return parentItem->getChildCount();
+  return parentItem ? parentItem->getChildCount() : 0;
 }
 
 template <typename ElementType>
@@ -89,7 +93,8 @@ QModelIndex CategoryTreeModel<ElementType>::index(
   if (parent.isValid() && parent.column() != 0) return QModelIndex();
 
   CategoryTreeItem<ElementType>* parentItem = getItem(parent);
-  CategoryTreeItem<ElementType>* childItem  = parentItem->getChild(row);
+  if (!parentItem) return QModelIndex();
+  CategoryTreeItem<ElementType>* childItem = parentItem->getChild(row);
 
   if (childItem)
     return createIndex(row, column, childItem);
@@ -127,7 +132,18 @@ template <typename ElementType>
 QVariant CategoryTreeModel<ElementType>::data(const QModelIndex& index,
                                               int                role) const {
   CategoryTreeItem<ElementType>* item = getItem(index);
-  return item->data(role);
+  return item ? item->data(role) : QVariant();
+}
+
+/*******************************************************************************
+ *  Private Methods
+ ******************************************************************************/
+
+template <typename ElementType>
+void CategoryTreeModel<ElementType>::rootItemLoaded() noexcept {
+  beginResetModel();
+  mRootItem = mWatcher.result();
+  endResetModel();
 }
 
 /*******************************************************************************
@@ -41,6 +41,10 @@ class WorkspaceLibraryDb;
 
 /**
  * @brief The CategoryTreeModel class
+ *
+ * The category tree is loaded from the library database in a background
+ * thread, so the model is empty right after construction. As soon as the
+ * tree is loaded, the model gets reset.
  */
 template <typename ElementType>
 class CategoryTreeModel final : public QAbstractItemModel {
@@ -71,8 +75,15 @@ public:
   CategoryTreeModel& operator=(const CategoryTreeModel& rhs) = delete;
 
 private:
+  // Types
+  typedef QSharedPointer<CategoryTreeItem<ElementType>> RootItem;
+
+  // Private Methods
+  void rootItemLoaded() noexcept;
+
   // Attributes
-  QScopedPointer<CategoryTreeItem<ElementType>> mRootItem;
+  RootItem                 mRootItem;  ///< nullptr until it has been loaded
+  QFutureWatcher<RootItem> mWatcher;
 };
 
 typedef CategoryTreeModel<library::ComponentCategory>
@@ -52,9 +52,12 @@ using namespace library;
  ******************************************************************************/
 
 WorkspaceLibraryDb::WorkspaceLibraryDb(Workspace& ws)
-  : QObject(nullptr), mWorkspace(ws) {
+  : QObject(nullptr), mWorkspace(ws), mHasFullTextIndex(false) {
   qDebug("Load workspace library database...");
 
+  // a few threads are enough since SQLite queries are mostly I/O bound
+  mThreadPool.setMaxThreadCount(qBound(2, QThread::idealThreadCount(), 4));
+
   // open SQLite database
   mFilePath = ws.getLibrariesPath().getPathTo(
       QString("cache_v%1.sqlite").arg(sCurrentDbVersion));
@@ -71,7 +74,14 @@ WorkspaceLibraryDb::WorkspaceLibraryDb(Workspace& ws)
     mDb.reset(new SQLiteDatabase(mFilePath));  // can throw
     createAllTables();                         // can throw
     setDbVersion(sCurrentDbVersion);           // can throw
+    try {
+      createFullTextIndex();  // can throw
+    } catch (const Exception& e) {
+      // not fatal, searching falls back to a substring search
+      qCritical() << "Could not create full-text index:" << e.getMsg();
+    }
   }
+  mHasFullTextIndex = checkFullTextIndex();
 
   // create library scanner object
   mLibraryScanner.reset(new WorkspaceLibraryScanner(mWorkspace, mFilePath));
@@ -100,9 +110,10 @@ WorkspaceLibraryDb::~WorkspaceLibraryDb() noexcept {
  ******************************************************************************/
 
 QMultiMap<Version, FilePath> WorkspaceLibraryDb::getLibraries() const {
-  QSqlQuery query =
-      mDb->prepareQuery("SELECT version, filepath FROM libraries");
-  mDb->exec(query);
+  SQLiteDatabase& db = getConnection();  // can throw
+
+  QSqlQuery query = db.prepareQuery("SELECT version, filepath FROM libraries");
+  db.exec(query);
 
   QMultiMap<Version, FilePath> libraries;
   while (query.next()) {
@@ -386,11 +397,20 @@ void WorkspaceLibraryDb::getElementMetadata<Device>(const FilePath elemDir,
 
 void WorkspaceLibraryDb::getLibraryMetadata(const FilePath libDir,
                                             QPixmap*       icon) const {
-  QSqlQuery query = mDb->prepareQuery(
+  QImage image;
+  getLibraryMetadata(libDir, icon ? &image : nullptr);  // can throw
+  if (icon) *icon = QPixmap::fromImage(image);
+}
+
+void WorkspaceLibraryDb::getLibraryMetadata(const FilePath libDir,
+                                            QImage*        icon) const {
+  SQLiteDatabase& db = getConnection();  // can throw
+
+  QSqlQuery query = db.prepareQuery(
       "SELECT icon_png FROM libraries WHERE filepath = :filepath");
   query.bindValue(":filepath",
                   libDir.toRelative(mWorkspace.getLibrariesPath()));
-  mDb->exec(query);
+  db.exec(query);
 
   if (query.first()) {
     QByteArray blob = query.value(0).toByteArray();
@@ -405,12 +425,14 @@ void WorkspaceLibraryDb::getLibraryMetadata(const FilePath libDir,
 
 void WorkspaceLibraryDb::getDeviceMetadata(const FilePath& devDir,
                                            Uuid* pkgUuid, Uuid* cmpUuid) const {
-  QSqlQuery query = mDb->prepareQuery(
+  SQLiteDatabase& db = getConnection();  // can throw
+
+  QSqlQuery query = db.prepareQuery(
       "SELECT package_uuid, component_uuid "
       "FROM devices WHERE filepath = :filepath");
   query.bindValue(":filepath",
                   devDir.toRelative(mWorkspace.getLibrariesPath()));
-  mDb->exec(query);
+  db.exec(query);
 
   if (query.first()) {
     Uuid uuid = Uuid::fromString(query.value(0).toString());  // can throw
@@ -499,10 +521,12 @@ QSet<Uuid> WorkspaceLibraryDb::getDevicesByCategory(
 
 QSet<Uuid> WorkspaceLibraryDb::getDevicesOfComponent(
     const Uuid& component) const {
-  QSqlQuery query = mDb->prepareQuery(
+  SQLiteDatabase& db = getConnection();  // can throw
+
+  QSqlQuery query = db.prepareQuery(
       "SELECT uuid FROM devices WHERE component_uuid = :uuid");
   query.bindValue(":uuid", component.toStr());
-  mDb->exec(query);
+  db.exec(query);
 
   QSet<Uuid> elements;
   while (query.next()) {
@@ -519,17 +543,83 @@ void WorkspaceLibraryDb::startLibraryRescan() noexcept {
   mLibraryScanner->startScan();
 }
 
+QList<Uuid> WorkspaceLibraryDb::searchElements(
+    const QString& tablename, const QString& idrowname, const QString& keyword,
+    const std::function<bool()>& abort) const {
+  SQLiteDatabase& db = getConnection();  // can throw
+
+  QSqlQuery query;
+  if (mHasFullTextIndex) {
+    QString expression = buildFullTextQuery(keyword);
+    if (expression.isEmpty()) {
+      return QList<Uuid>();  // FTS5 does not accept empty queries
+    }
+    // name matches are weighted 10 times higher than keyword matches, and
+    // elements with multiple matching translations are listed only once
+    query = db.prepareQuery(
+        QString("SELECT %1.uuid FROM "
+                "(SELECT rowid, bm25(%1_fts, 10.0, 1.0) AS score "
+                "FROM %1_fts WHERE %1_fts MATCH :query) AS matches "
+                "INNER JOIN %1_tr ON %1_tr.id = matches.rowid "
+                "INNER JOIN %1 ON %1.id = %1_tr.%2 "
+                "GROUP BY %1.id "
+                "ORDER BY MIN(matches.score) ASC, MIN(%1_tr.name) ASC")
+            .arg(tablename, idrowname));  // can throw
+    query.bindValue(":query", expression);
+  } else {
+    query = db.prepareQuery(QString("SELECT %1.uuid FROM %1, %1_tr "
+                                    "ON %1.id=%1_tr.%2 "
+                                    "WHERE %1_tr.name LIKE :keyword "
+                                    "OR %1_tr.keywords LIKE :keyword "
+                                    "ORDER BY %1_tr.name ASC ")
+                                .arg(tablename, idrowname));  // can throw
+    query.bindValue(":keyword", "%" + keyword + "%");
+  }
+  db.exec(query);  // can throw
+
+  QList<Uuid> elements;
+  while (query.next()) {
+    if (abort && abort()) {
+      break;
+    }
+    elements.append(Uuid::fromString(query.value(0).toString()));  // can throw
+  }
+  return elements;
+}
+
 /*******************************************************************************
  *  Private Methods
  ******************************************************************************/
 
+SQLiteDatabase& WorkspaceLibraryDb::getConnection() const {
+  if (QThread::currentThread() == thread()) {
+    return *mDb;
+  }
+  // SQLite connections must not be shared between threads, so every pool
+  // thread gets its own connection which is closed when the thread exits.
+  // Other threads are not allowed since their connections would outlive this
+  // object.
+  if (!mIsPoolThread.hasLocalData()) {
+    throw LogicError(__FILE__, __LINE__,
+                     "The workspace library database must only be accessed "
+                     "from its own thread or with runAsync().");
+  }
+  if (!mReadConnections.hasLocalData()) {
+    mReadConnections.setLocalData(
+        new SQLiteDatabase(mFilePath, true));  // can throw
+  }
+  return *mReadConnections.localData();
+}
+
 void WorkspaceLibraryDb::getElementTranslations(const QString&     table,
                                                 const QString&     idRow,
                                                 const FilePath&    elemDir,
                                                 const QStringList& localeOrder,
                                                 QString* name, QString* desc,
                                                 QString* keywords) const {
-  QSqlQuery query = mDb->prepareQuery(
+  SQLiteDatabase& db = getConnection();  // can throw
+
+  QSqlQuery query = db.prepareQuery(
       "SELECT locale, name, description, keywords FROM " % table %
       "_tr "
       "INNER JOIN " %
@@ -539,7 +629,7 @@ void WorkspaceLibraryDb::getElementTranslations(const QString&     table,
       table % ".filepath = :filepath");
   query.bindValue(":filepath",
                   elemDir.toRelative(mWorkspace.getLibrariesPath()));
-  mDb->exec(query);
+  db.exec(query);
 
   LocalizedNameMap        nameMap(ElementName("unknown"));
   LocalizedDescriptionMap descriptionMap("unknown");
@@ -562,11 +652,13 @@ void WorkspaceLibraryDb::getElementTranslations(const QString&     table,
 void WorkspaceLibraryDb::getElementMetadata(const QString& table,
                                             const FilePath elemDir, Uuid* uuid,
                                             Version* version) const {
-  QSqlQuery query = mDb->prepareQuery("SELECT uuid, version FROM " % table %
-                                      " WHERE filepath = :filepath");
+  SQLiteDatabase& db = getConnection();  // can throw
+
+  QSqlQuery query = db.prepareQuery("SELECT uuid, version FROM " % table %
+                                    " WHERE filepath = :filepath");
   query.bindValue(":filepath",
                   elemDir.toRelative(mWorkspace.getLibrariesPath()));
-  mDb->exec(query);
+  db.exec(query);
 
   while (query.next()) {
     QString uuidStr    = query.value(0).toString();
@@ -578,10 +670,12 @@ void WorkspaceLibraryDb::getElementMetadata(const QString& table,
 
 QMultiMap<Version, FilePath> WorkspaceLibraryDb::getElementFilePathsFromDb(
     const QString& tablename, const Uuid& uuid) const {
-  QSqlQuery query = mDb->prepareQuery("SELECT version, filepath FROM " %
-                                      tablename % " WHERE uuid = :uuid");
+  SQLiteDatabase& db = getConnection();  // can throw
+
+  QSqlQuery query = db.prepareQuery("SELECT version, filepath FROM " %
+                                    tablename % " WHERE uuid = :uuid");
   query.bindValue(":uuid", uuid.toStr());
-  mDb->exec(query);
+  db.exec(query);
 
   QMultiMap<Version, FilePath> elements;
   while (query.next()) {
@@ -608,11 +702,13 @@ FilePath WorkspaceLibraryDb::getLatestVersionFilePath(
 
 QSet<Uuid> WorkspaceLibraryDb::getCategoryChilds(
     const QString& tablename, const tl::optional<Uuid>& categoryUuid) const {
-  QSqlQuery query = mDb->prepareQuery(
+  SQLiteDatabase& db = getConnection();  // can throw
+
+  QSqlQuery query = db.prepareQuery(
       "SELECT uuid FROM " % tablename % " WHERE parent_uuid " %
       (categoryUuid ? "= '" % categoryUuid->toStr() % "'"
                     : QString("IS NULL")));
-  mDb->exec(query);
+  db.exec(query);
 
   QSet<Uuid> elements;
   while (query.next()) {
@@ -640,10 +736,12 @@ QList<Uuid> WorkspaceLibraryDb::getCategoryParents(const QString& tablename,
 
 tl::optional<Uuid> WorkspaceLibraryDb::getCategoryParent(
     const QString& tablename, const Uuid& category) const {
-  QSqlQuery query = mDb->prepareQuery(
+  SQLiteDatabase& db = getConnection();  // can throw
+
+  QSqlQuery query = db.prepareQuery(
       "SELECT parent_uuid FROM " % tablename % " WHERE uuid = '" %
       category.toStr() % "'" % " ORDER BY version DESC" % " LIMIT 1");
-  mDb->exec(query);
+  db.exec(query);
 
   if (query.next()) {
     QVariant value = query.value(0);
@@ -663,27 +761,33 @@ tl::optional<Uuid> WorkspaceLibraryDb::getCategoryParent(
 
 int WorkspaceLibraryDb::getCategoryChildCount(
     const QString& tablename, const tl::optional<Uuid>& category) const {
-  QSqlQuery query = mDb->prepareQuery(
+  SQLiteDatabase& db = getConnection();  // can throw
+
+  QSqlQuery query = db.prepareQuery(
       "SELECT COUNT(*) FROM " % tablename % " WHERE parent_uuid " %
       (category ? "= '" % category->toStr() % "'" : QString("IS NULL")));
-  return mDb->count(query);
+  return db.count(query);
 }
 
 int WorkspaceLibraryDb::getCategoryElementCount(
     const QString& tablename, const QString& idrowname,
     const tl::optional<Uuid>& category) const {
-  QSqlQuery query = mDb->prepareQuery(
+  SQLiteDatabase& db = getConnection();  // can throw
+
+  QSqlQuery query = db.prepareQuery(
       "SELECT COUNT(*) FROM " % tablename % " LEFT JOIN " % tablename % "_cat" %
       " ON " % tablename % ".id=" % tablename % "_cat." % idrowname %
       " WHERE category_uuid " %
       (category ? "= '" % category->toStr() % "'" : QString("IS NULL")));
-  return mDb->count(query);
+  return db.count(query);
 }
 
 QSet<Uuid> WorkspaceLibraryDb::getElementsByCategory(
     const QString& tablename, const QString& idrowname,
     const tl::optional<Uuid>& categoryUuid) const {
-  QSqlQuery query = mDb->prepareQuery(
+  SQLiteDatabase& db = getConnection();  // can throw
+
+  QSqlQuery query = db.prepareQuery(
       "SELECT uuid FROM " % tablename % " LEFT JOIN " % tablename %
       "_cat "
       "ON " %
@@ -692,7 +796,7 @@ QSet<Uuid> WorkspaceLibraryDb::getElementsByCategory(
       "WHERE category_uuid " %
       (categoryUuid ? "= '" % categoryUuid->toStr() % "'"
                     : QString("IS NULL")));
-  mDb->exec(query);
+  db.exec(query);
 
   QSet<Uuid> elements;
   while (query.next()) {
@@ -704,32 +808,20 @@ QSet<Uuid> WorkspaceLibraryDb::getElementsByCategory(
 QList<Uuid> WorkspaceLibraryDb::getElementsBySearchKeyword(
     const QString& tablename, const QString& idrowname,
     const QString& keyword) const {
-  QSqlQuery query = mDb->prepareQuery(QString("SELECT %1.uuid FROM %1, %1_tr "
-                                              "ON %1.id=%1_tr.%2 "
-                                              "WHERE %1_tr.name LIKE :keyword "
-                                              "OR %1_tr.keywords LIKE :keyword "
-                                              "ORDER BY %1_tr.name ASC ")
-                                          .arg(tablename, idrowname));
-  query.bindValue(":keyword", "%" + keyword + "%");
-  mDb->exec(query);
-
-  QList<Uuid> elements;
-  elements.reserve(query.size());
-  while (query.next()) {
-    elements.append(Uuid::fromString(query.value(0).toString()));  // can throw
-  }
-  return elements;
+  return searchElements(tablename, idrowname, keyword);  // can throw
 }
 
 int WorkspaceLibraryDb::getLibraryId(const FilePath& lib) const {
+  SQLiteDatabase& db = getConnection();  // can throw
+
   QString   relativeLibraryPath = lib.toRelative(mWorkspace.getLibrariesPath());
-  QSqlQuery query               = mDb->prepareQuery(
+  QSqlQuery query               = db.prepareQuery(
       "SELECT id FROM libraries "
       "WHERE filepath = '" %
       relativeLibraryPath %
       "'"
       "LIMIT 1");
-  mDb->exec(query);
+  db.exec(query);
 
   if (query.next()) {
     bool ok = false;
@@ -747,10 +839,12 @@ int WorkspaceLibraryDb::getLibraryId(const FilePath& lib) const {
 
 QList<FilePath> WorkspaceLibraryDb::getLibraryElements(
     const FilePath& lib, const QString& tablename) const {
-  QSqlQuery query = mDb->prepareQuery("SELECT filepath FROM " % tablename %
-                                      " WHERE lib_id = :lib_id");
+  SQLiteDatabase& db = getConnection();  // can throw
+
+  QSqlQuery query = db.prepareQuery("SELECT filepath FROM " % tablename %
+                                    " WHERE lib_id = :lib_id");
   query.bindValue(":lib_id", getLibraryId(lib));
-  mDb->exec(query);
+  db.exec(query);
 
   QList<FilePath> elements;
   while (query.next()) {
@@ -808,6 +902,8 @@ void WorkspaceLibraryDb::createAllTables() {
       "`filepath` TEXT UNIQUE NOT NULL, "
       "`uuid` TEXT NOT NULL, "
       "`version` TEXT NOT NULL, "
+      "`modified` INTEGER NOT NULL, "
+      "`checksum` BLOB NOT NULL, "
       "`parent_uuid` TEXT"
       ")");
   queries << QString(
@@ -830,6 +926,8 @@ void WorkspaceLibraryDb::createAllTables() {
       "`filepath` TEXT UNIQUE NOT NULL, "
       "`uuid` TEXT NOT NULL, "
       "`version` TEXT NOT NULL, "
+      "`modified` INTEGER NOT NULL, "
+      "`checksum` BLOB NOT NULL, "
       "`parent_uuid` TEXT"
       ")");
   queries << QString(
@@ -851,7 +949,9 @@ void WorkspaceLibraryDb::createAllTables() {
       "`lib_id` INTEGER NOT NULL, "
       "`filepath` TEXT UNIQUE NOT NULL, "
       "`uuid` TEXT NOT NULL, "
-      "`version` TEXT NOT NULL"
+      "`version` TEXT NOT NULL, "
+      "`modified` INTEGER NOT NULL, "
+      "`checksum` BLOB NOT NULL"
       ")");
   queries << QString(
       "CREATE TABLE IF NOT EXISTS symbols_tr ("
@@ -880,7 +980,9 @@ void WorkspaceLibraryDb::createAllTables() {
       "`lib_id` INTEGER NOT NULL, "
       "`filepath` TEXT UNIQUE NOT NULL, "
       "`uuid` TEXT NOT NULL, "
-      "`version` TEXT NOT NULL "
+      "`version` TEXT NOT NULL, "
+      "`modified` INTEGER NOT NULL, "
+      "`checksum` BLOB NOT NULL"
       ")");
   queries << QString(
       "CREATE TABLE IF NOT EXISTS packages_tr ("
@@ -909,7 +1011,9 @@ void WorkspaceLibraryDb::createAllTables() {
       "`lib_id` INTEGER NOT NULL, "
       "`filepath` TEXT UNIQUE NOT NULL, "
       "`uuid` TEXT NOT NULL, "
-      "`version` TEXT NOT NULL"
+      "`version` TEXT NOT NULL, "
+      "`modified` INTEGER NOT NULL, "
+      "`checksum` BLOB NOT NULL"
       ")");
   queries << QString(
       "CREATE TABLE IF NOT EXISTS components_tr ("
@@ -939,6 +1043,8 @@ void WorkspaceLibraryDb::createAllTables() {
       "`filepath` TEXT UNIQUE NOT NULL, "
       "`uuid` TEXT NOT NULL, "
       "`version` TEXT NOT NULL, "
+      "`modified` INTEGER NOT NULL, "
+      "`checksum` BLOB NOT NULL, "
       "`component_uuid` TEXT NOT NULL, "
       "`package_uuid` TEXT NOT NULL"
       ")");
@@ -969,6 +1075,72 @@ void WorkspaceLibraryDb::createAllTables() {
   }
 }
 
+void WorkspaceLibraryDb::createFullTextIndex() {
+  // The FTS5 tables index the names and keywords of all translation tables.
+  // They don't store the content themselves and are kept up to date by
+  // triggers, so the library scanner fills them implicitly.
+  QStringList tables = {"libraries", "component_categories",
+                        "package_categories", "symbols",
+                        "packages",  "components",
+                        "devices"};
+  QStringList queries;
+  foreach (const QString& table, tables) {
+    queries << QString(
+                   "CREATE VIRTUAL TABLE IF NOT EXISTS %1_fts USING fts5("
+                   "name, keywords, content='%1_tr', content_rowid='id', "
+                   "prefix='2 3', tokenize='unicode61 remove_diacritics 1'"
+                   ")")
+                   .arg(table);
+    queries << QString(
+                   "CREATE TRIGGER IF NOT EXISTS %1_tr_ai "
+                   "AFTER INSERT ON %1_tr BEGIN "
+                   "INSERT INTO %1_fts(rowid, name, keywords) "
+                   "VALUES (new.id, new.name, new.keywords); "
+                   "END")
+                   .arg(table);
+    queries << QString(
+                   "CREATE TRIGGER IF NOT EXISTS %1_tr_ad "
+                   "AFTER DELETE ON %1_tr BEGIN "
+                   "INSERT INTO %1_fts(%1_fts, rowid, name, keywords) "
+                   "VALUES ('delete', old.id, old.name, old.keywords); "
+                   "END")
+                   .arg(table);
+    queries << QString(
+                   "CREATE TRIGGER IF NOT EXISTS %1_tr_au "
+                   "AFTER UPDATE ON %1_tr BEGIN "
+                   "INSERT INTO %1_fts(%1_fts, rowid, name, keywords) "
+                   "VALUES ('delete', old.id, old.name, old.keywords); "
+                   "INSERT INTO %1_fts(rowid, name, keywords) "
+                   "VALUES (new.id, new.name, new.keywords); "
+                   "END")
+                   .arg(table);
+    // the search results are mapped back to file paths by their UUIDs
+    queries << QString(
+                   "CREATE INDEX IF NOT EXISTS %1_uuid_index ON %1(uuid)")
+                   .arg(table);
+  }
+
+  // create all or nothing, to not end up with a partial index
+  SQLiteDatabase::TransactionScopeGuard transactionGuard(*mDb);  // can throw
+  foreach (const QString& string, queries) {
+    QSqlQuery query = mDb->prepareQuery(string);  // can throw
+    mDb->exec(query);                             // can throw
+  }
+  transactionGuard.commit();  // can throw
+}
+
+bool WorkspaceLibraryDb::checkFullTextIndex() const noexcept {
+  try {
+    QSqlQuery query = mDb->prepareQuery(
+        "SELECT COUNT(*) FROM sqlite_master "
+        "WHERE type = 'table' AND name = 'devices_fts'");
+    mDb->exec(query);
+    return query.next() && (query.value(0).toInt() > 0);
+  } catch (const Exception& e) {
+    return false;
+  }
+}
+
 int WorkspaceLibraryDb::getDbVersion() const noexcept {
   try {
     QSqlQuery query = mDb->prepareQuery(
@@ -995,6 +1167,24 @@ void WorkspaceLibraryDb::setDbVersion(int version) {
   mDb->insert(query);  // can throw
 }
 
+/*******************************************************************************
+ *  Static Methods
+ ******************************************************************************/
+
+QString WorkspaceLibraryDb::buildFullTextQuery(
+    const QString& keyword) noexcept {
+  // Split into the same words as the unicode61 tokenizer does, and quote them
+  // to not interpret words like "AND" or "NOT" as operators.
+  static const QRegularExpression separator(
+      "[\\W_]+", QRegularExpression::UseUnicodePropertiesOption);
+  QStringList terms;
+  foreach (const QString& word,
+           keyword.split(separator, QString::SkipEmptyParts)) {
+    terms.append("\"" % word % "\"*");
+  }
+  return terms.join(" ");
+}
+
 /*******************************************************************************
  *  End of File
  ******************************************************************************/
@@ -27,8 +27,11 @@
 #include <librepcb/common/fileio/filepath.h>
 #include <librepcb/common/uuid.h>
 
+#include <QtConcurrent/QtConcurrentRun>
 #include <QtCore>
 
+#include <functional>
+
 /*******************************************************************************
  *  Namespace / Forward Declarations
  ******************************************************************************/
@@ -48,6 +51,18 @@ class WorkspaceLibraryScanner;
 
 /**
  * @brief The WorkspaceLibraryDb class
+ *
+ * The getters may be called from the thread this object lives in, which uses
+ * the main database connection, or from functions passed to #runAsync(). The
+ * latter are executed on the internal thread pool where every thread uses a
+ * read-only connection which is opened on first use and closed when the
+ * thread exits. The database is opened in WAL mode, so these connections can
+ * read concurrently while the library scanner writes to the database. Calls
+ * from any other thread throw a LogicError since their connections could not
+ * be closed together with this object.
+ *
+ * To keep the GUI responsive, expensive queries should be run with
+ * #runAsync().
  */
 class WorkspaceLibraryDb final : public QObject {
   Q_OBJECT
@@ -93,8 +108,26 @@ public:
   FilePath getLatestDevice(const Uuid& uuid) const;
 
   // Getters: Library elements by search keyword
+
+  /**
+   * @brief Search library elements by their names and keywords
+   *
+   * Every word of the keyword matches as a prefix of a word in the names or
+   * keywords of the elements, and all words must match. The elements are
+   * ranked by relevance, with matches in names ranked higher than matches in
+   * keywords.
+   *
+   * @note  This runs a query in the calling thread. For interactive searches
+   *        use librepcb::workspace::WorkspaceLibrarySearch instead, which
+   *        runs the queries in a background thread.
+   *
+   * @param keyword   The search term entered by the user.
+   *
+   * @return UUIDs of all matching elements, best matches first.
+   */
   template <typename ElementType>
   QList<Uuid> getElementsBySearchKeyword(const QString& keyword) const;
+  bool hasFullTextIndex() const noexcept { return mHasFullTextIndex; }
 
   // Getters: Library elements of a specified library
   template <typename ElementType>
@@ -110,6 +143,7 @@ public:
   void getElementMetadata(const FilePath elemDir, Uuid* uuid = nullptr,
                           Version* version = nullptr) const;
   void getLibraryMetadata(const FilePath libDir, QPixmap* icon = nullptr) const;
+  void getLibraryMetadata(const FilePath libDir, QImage* icon) const;
   void getDeviceMetadata(const FilePath& devDir, Uuid* pkgUuid = nullptr,
                          Uuid* cmpUuid = nullptr) const;
 
@@ -136,9 +170,60 @@ public:
    */
   void startLibraryRescan() noexcept;
 
+  /**
+   * @brief Run a function on the thread pool of the library database
+   *
+   * The function may call any getter of this object, the queries are then
+   * executed on a read-only database connection of the pool thread. Note that
+   * the function must not access any QPixmap or widget since it does not run
+   * in the GUI thread.
+   *
+   * @param functor   The function to run.
+   *
+   * @return A future to get the return value of the function.
+   */
+  template <typename Functor>
+  auto runAsync(Functor functor) const -> QFuture<decltype(functor())> {
+    return QtConcurrent::run(&mThreadPool, [this, functor]() {
+      mIsPoolThread.setLocalData(true);  // allow opening a read connection
+      return functor();
+    });
+  }
+
+  /**
+   * @brief Search elements of a specific type in the library database
+   *
+   * @param tablename       Table of the element type, e.g. "devices".
+   * @param idrowname       Element ID column of the translation table, e.g.
+   *                        "device_id".
+   * @param keyword         The search term entered by the user.
+   * @param abort           If set, it is called for every result row and the
+   *                        search is aborted if it returns true.
+   *
+   * @return UUIDs of all matching elements, best matches first. If the
+   *         database has no full-text index, a (slow) substring search is
+   *         done instead.
+   */
+  QList<Uuid> searchElements(
+      const QString& tablename, const QString& idrowname,
+      const QString&               keyword,
+      const std::function<bool()>& abort = std::function<bool()>()) const;
+
   // Operator Overloadings
   WorkspaceLibraryDb& operator=(const WorkspaceLibraryDb& rhs) = delete;
 
+  // Static Methods
+
+  /**
+   * @brief Convert a search term to an FTS5 query expression
+   *
+   * @param keyword   The search term entered by the user.
+   *
+   * @return A query matching all words of the keyword as prefixes, or an
+   *         empty string if the keyword does not contain any word.
+   */
+  static QString buildFullTextQuery(const QString& keyword) noexcept;
+
 signals:
 
   void scanStarted();
@@ -150,6 +235,7 @@ signals:
 
 private:
   // Private Methods
+  SQLiteDatabase& getConnection() const;
   void getElementTranslations(const QString& table, const QString& idRow,
                               const FilePath&    elemDir,
                               const QStringList& localeOrder, QString* name,
@@ -181,6 +267,8 @@ private:
   QList<FilePath> getLibraryElements(const FilePath& lib,
                                      const QString&  tablename) const;
   void            createAllTables();
+  void            createFullTextIndex();
+  bool            checkFullTextIndex() const noexcept;
   void            setDbVersion(int version);
   int             getDbVersion() const noexcept;
 
@@ -189,9 +277,21 @@ private:
   FilePath                       mFilePath;  ///< path to the SQLite database
   QScopedPointer<SQLiteDatabase> mDb;        ///< the SQLite database
   QScopedPointer<WorkspaceLibraryScanner> mLibraryScanner;
+  bool                                    mHasFullTextIndex;
+
+  /// Read-only database connections of the threads in #mThreadPool
+  mutable QThreadStorage<SQLiteDatabase*> mReadConnections;
+
+  /// Set for the threads in #mThreadPool, which are the only threads besides
+  /// the owner thread allowed to access the database
+  mutable QThreadStorage<bool> mIsPoolThread;
+
+  /// Must be the last member to finish all jobs before the members get
+  /// destroyed (the connections are destroyed when the pool threads exit)
+  mutable QThreadPool mThreadPool;
 
   // Constants
-  static const int sCurrentDbVersion = 2;
+  static const int sCurrentDbVersion = 4;
 };
 
 /*******************************************************************************
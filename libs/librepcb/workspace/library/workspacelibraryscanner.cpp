@@ -27,9 +27,13 @@
 #include <librepcb/common/fileio/transactionalfilesystem.h>
 #include <librepcb/common/sqlitedatabase.h>
 #include <librepcb/library/elements.h>
+#include <librepcb/library/librarybaseelementheader.h>
 
+#include <QtConcurrent/QtConcurrent>
 #include <QtCore>
 
+#include <type_traits>
+
 /*******************************************************************************
  *  Namespace
  ******************************************************************************/
@@ -48,7 +52,9 @@ WorkspaceLibraryScanner::WorkspaceLibraryScanner(
     mWorkspace(ws),
     mDbFilePath(dbFilePath),
     mSemaphore(0),
-    mAbort(false) {
+    mAbort(false),
+    mWrittenRows(0),
+    mWriteTimeNs(0) {
   start();
 }
 
@@ -88,6 +94,41 @@ QVariant WorkspaceLibraryScanner::optionalToVariant(
   return opt ? **opt : QVariant();
 }
 
+template <typename ElementType>
+void WorkspaceLibraryScanner::getElementColumns(
+    const LibraryBaseElementHeader& header, ElementInfo& info) {
+  info.categories = header.getCategories();
+}
+
+template <>
+void WorkspaceLibraryScanner::getElementColumns<ComponentCategory>(
+    const LibraryBaseElementHeader& header, ElementInfo& info) {
+  info.columns.append(qMakePair(QString("parent_uuid"),
+                                header.getParentUuid()
+                                    ? QVariant(header.getParentUuid()->toStr())
+                                    : QVariant(QVariant::String)));
+}
+
+template <>
+void WorkspaceLibraryScanner::getElementColumns<PackageCategory>(
+    const LibraryBaseElementHeader& header, ElementInfo& info) {
+  getElementColumns<ComponentCategory>(header, info);
+}
+
+template <>
+void WorkspaceLibraryScanner::getElementColumns<Device>(
+    const LibraryBaseElementHeader& header, ElementInfo& info) {
+  if ((!header.getComponentUuid()) || (!header.getPackageUuid())) {
+    throw RuntimeError(__FILE__, __LINE__,
+                       "Device without component or package.");
+  }
+  info.categories = header.getCategories();
+  info.columns.append(qMakePair(QString("component_uuid"),
+                                QVariant(header.getComponentUuid()->toStr())));
+  info.columns.append(qMakePair(QString("package_uuid"),
+                                QVariant(header.getPackageUuid()->toStr())));
+}
+
 void WorkspaceLibraryScanner::run() noexcept {
   qDebug() << "Workspace library scanner thread started.";
 
@@ -113,6 +154,16 @@ void WorkspaceLibraryScanner::scan() noexcept {
 
     // open SQLite database
     SQLiteDatabase db(mDbFilePath);  // can throw
+    mWrittenRows = 0;
+    mWriteTimeNs = 0;
+
+    // The database is only a cache which can be rebuilt at any time, so trade
+    // durability for write speed: WAL with synchronous=NORMAL can only lose
+    // the last transactions on power loss, but never gets corrupted.
+    db.setPragma("synchronous", "NORMAL");                  // can throw
+    db.setPragma("cache_size", "-16384");                   // 16 MiB
+    db.setPragma("temp_store", "MEMORY");                   // can throw
+    db.setPragma("mmap_size", QString::number(256 << 20));  // 256 MiB
 
     // update list of libraries
     std::shared_ptr<TransactionalFileSystem> fs =
@@ -129,54 +180,32 @@ void WorkspaceLibraryScanner::scan() noexcept {
     // begin database transaction
     SQLiteDatabase::TransactionScopeGuard transactionGuard(db);  // can throw
 
-    // clear all tables
-    clearAllTables(db);
-
-    // scan all libraries
-    int   count   = 0;
-    qreal percent = 1;
-    foreach (const QString& fp, libraries.keys()) {
-      Q_ASSERT(libIds.contains(fp));
-      int                             libId = libIds[fp];
-      const std::shared_ptr<Library>& lib   = libraries[fp];
-      Q_ASSERT(lib);
-      if (mAbort || (mSemaphore.available() > 0)) break;
-      count += addCategoriesToDb<ComponentCategory>(
-          db, fs, fp, lib->searchForElements<ComponentCategory>(),
-          "component_categories", "cat_id", libId);
-      emit scanProgressUpdate(percent += qreal(98) / (libraries.count() * 6));
-      if (mAbort || (mSemaphore.available() > 0)) break;
-      count += addCategoriesToDb<PackageCategory>(
-          db, fs, fp, lib->searchForElements<PackageCategory>(),
-          "package_categories", "cat_id", libId);
-      emit scanProgressUpdate(percent += qreal(98) / (libraries.count() * 6));
-      if (mAbort || (mSemaphore.available() > 0)) break;
-      count +=
-          addElementsToDb<Symbol>(db, fs, fp, lib->searchForElements<Symbol>(),
-                                  "symbols", "symbol_id", libId);
-      emit scanProgressUpdate(percent += qreal(98) / (libraries.count() * 6));
-      if (mAbort || (mSemaphore.available() > 0)) break;
-      count += addElementsToDb<Package>(db, fs, fp,
-                                        lib->searchForElements<Package>(),
-                                        "packages", "package_id", libId);
-      emit scanProgressUpdate(percent += qreal(98) / (libraries.count() * 6));
-      if (mAbort || (mSemaphore.available() > 0)) break;
-      count += addElementsToDb<Component>(db, fs, fp,
-                                          lib->searchForElements<Component>(),
-                                          "components", "component_id", libId);
-      emit scanProgressUpdate(percent += qreal(98) / (libraries.count() * 6));
-      if (mAbort || (mSemaphore.available() > 0)) break;
-      count +=
-          addElementsToDb<Device>(db, fs, fp, lib->searchForElements<Device>(),
-                                  "devices", "device_id", libId);
-      emit scanProgressUpdate(percent += qreal(98) / (libraries.count() * 6));
-    }
+    // scan all libraries, one element type after the other
+    int count = 0;
+    count += updateElementsInDb<ComponentCategory>(
+        db, fs, libraries, libIds, "component_categories", "cat_id", 0);
+    count += updateElementsInDb<PackageCategory>(
+        db, fs, libraries, libIds, "package_categories", "cat_id", 1);
+    count += updateElementsInDb<Symbol>(db, fs, libraries, libIds, "symbols",
+                                        "symbol_id", 2);
+    count += updateElementsInDb<Package>(db, fs, libraries, libIds,
+                                         "packages", "package_id", 3);
+    count += updateElementsInDb<Component>(db, fs, libraries, libIds,
+                                           "components", "component_id", 4);
+    count += updateElementsInDb<Device>(db, fs, libraries, libIds, "devices",
+                                        "device_id", 5);
 
     // commit transaction
-    if ((!mAbort) && (mSemaphore.available() == 0)) {
+    if (!isAbortRequested()) {
       transactionGuard.commit();  // can throw
       qDebug() << "Workspace library scan succeeded:" << count << "elements in"
                << timer.elapsed() << "ms";
+      qDebug() << "Workspace library database:" << mWrittenRows
+               << "rows written in" << (mWriteTimeNs / 1000000) << "ms ("
+               << ((mWriteTimeNs > 0) ? (mWrittenRows * 1000000000LL /
+                                         mWriteTimeNs)
+                                      : 0)
+               << "rows/s)";
       emit scanSucceeded(count);
     } else {
       qDebug() << "Workspace library scan aborted after" << timer.elapsed()
@@ -299,185 +328,231 @@ QHash<QString, int> WorkspaceLibraryScanner::updateLibraries(
   return dbLibIds;
 }
 
-void WorkspaceLibraryScanner::clearAllTables(SQLiteDatabase& db) {
-  // component categories
-  db.clearTable("component_categories_tr");
-  db.clearTable("component_categories");
-
-  // package categories
-  db.clearTable("package_categories_tr");
-  db.clearTable("package_categories");
-
-  // symbols
-  db.clearTable("symbols_tr");
-  db.clearTable("symbols_cat");
-  db.clearTable("symbols");
-
-  // packages
-  db.clearTable("packages_tr");
-  db.clearTable("packages_cat");
-  db.clearTable("packages");
-
-  // components
-  db.clearTable("components_tr");
-  db.clearTable("components_cat");
-  db.clearTable("components");
-
-  // devices
-  db.clearTable("devices_tr");
-  db.clearTable("devices_cat");
-  db.clearTable("devices");
-}
-
 template <typename ElementType>
-int WorkspaceLibraryScanner::addCategoriesToDb(
+int WorkspaceLibraryScanner::updateElementsInDb(
     SQLiteDatabase& db, std::shared_ptr<TransactionalFileSystem> fs,
-    const QString& libPath, const QStringList& dirs, const QString& table,
-    const QString& idColumn, int libId) {
-  int count = 0;
-  foreach (const QString& dirpath, dirs) {
-    if (mAbort || (mSemaphore.available() > 0)) break;
-    QString fullPath = libPath % "/" % dirpath;
-    try {
-      std::unique_ptr<TransactionalDirectory> dir(
-          new TransactionalDirectory(fs, fullPath));  // can throw
-      ElementType element(std::move(dir));            // can throw
-      QSqlQuery   query = db.prepareQuery(
-          "INSERT INTO " % table %
-          " "
-          "(lib_id, filepath, uuid, version, parent_uuid) VALUES "
-          "(:lib_id, :filepath, :uuid, :version, :parent_uuid)");
-      query.bindValue(":lib_id", libId);
-      query.bindValue(":filepath", fullPath);
-      query.bindValue(":uuid", element.getUuid().toStr());
-      query.bindValue(":version", element.getVersion().toStr());
-      query.bindValue(":parent_uuid", element.getParentUuid()
-                                          ? element.getParentUuid()->toStr()
-                                          : QVariant(QVariant::String));
-      int id = db.insert(query);
-      foreach (const QString& locale, element.getAllAvailableLocales()) {
-        QSqlQuery query = db.prepareQuery(
-            "INSERT INTO " % table %
-            "_tr "
-            "(" %
-            idColumn %
-            ", locale, name, description, keywords) VALUES "
-            "(:element_id, :locale, :name, :description, :keywords)");
-        query.bindValue(":element_id", id);
-        query.bindValue(":locale", locale);
-        query.bindValue(":name",
-                        optionalToVariant(element.getNames().tryGet(locale)));
-        query.bindValue(
-            ":description",
-            optionalToVariant(element.getDescriptions().tryGet(locale)));
-        query.bindValue(":keywords", optionalToVariant(
-                                         element.getKeywords().tryGet(locale)));
-        db.insert(query);
+    const QHash<QString, std::shared_ptr<Library>>& libs,
+    const QHash<QString, int>& libIds, const QString& table,
+    const QString& idColumn, int stage) {
+  if (isAbortRequested()) return 0;
+
+  // get all elements which are already in the database
+  QHash<QString, DbEntry> dbEntries;
+  QSqlQuery               query = db.prepareQuery(
+      "SELECT id, lib_id, filepath, modified, checksum FROM " % table);
+  db.exec(query);
+  while (query.next()) {
+    DbEntry entry{query.value(0).toInt(), query.value(1).toInt(),
+                  query.value(3).toLongLong(), query.value(4).toByteArray()};
+    dbEntries.insert(query.value(2).toString(), entry);
+  }
+
+  // determine all elements to scan
+  QVector<ElementInfo> elements;
+  foreach (const QString& libPath, libs.keys()) {
+    Q_ASSERT(libIds.contains(libPath));
+    std::shared_ptr<Library> lib = libs[libPath];
+    Q_ASSERT(lib);
+    foreach (const QString& dir, lib->searchForElements<ElementType>()) {
+      ElementInfo info;
+      info.filepath = libPath % "/" % dir;
+      info.libId    = libIds[libPath];
+      info.dbId     = -1;
+      info.modified = -1;
+      info.status   = ElementInfo::Status::Failed;
+      auto it       = dbEntries.find(info.filepath);
+      if (it != dbEntries.end()) {
+        info.dbId     = it->id;
+        info.modified = (it->libId == info.libId) ? it->modified : -1;
+        info.checksum = it->checksum;
+        dbEntries.erase(it);
       }
-      count++;
-    } catch (const Exception& e) {
-      qWarning() << "Failed to open library element:" << fullPath;
+      elements.append(info);
     }
   }
-  return count;
-}
 
-template <typename ElementType>
-int WorkspaceLibraryScanner::addElementsToDb(
-    SQLiteDatabase& db, std::shared_ptr<TransactionalFileSystem> fs,
-    const QString& libPath, const QStringList& dirs, const QString& table,
-    const QString& idColumn, int libId) {
-  int count = 0;
-  foreach (const QString& dirpath, dirs) {
-    if (mAbort || (mSemaphore.available() > 0)) break;
-    QString fullPath = libPath % "/" % dirpath;
-    try {
-      std::unique_ptr<TransactionalDirectory> dir(
-          new TransactionalDirectory(fs, fullPath));  // can throw
-      ElementType element(std::move(dir));            // can throw
-      addElementToDb(db, table, idColumn, libId, fullPath, element);
-      count++;
-    } catch (const Exception& e) {
-      qWarning() << "Failed to open library element:" << fullPath;
+  // remove elements which no longer exist
+  foreach (const DbEntry& entry, dbEntries) {
+    query = db.prepareCachedQuery("DELETE FROM " % table % " WHERE id = :id");
+    query.bindValue(":id", entry.id);
+    db.exec(query);  // translations and categories are deleted by cascade
+    ++mWrittenRows;
+  }
+
+  // Load all elements in worker threads and write the results in order to
+  // the database while the workers continue with the next elements.
+  std::function<ElementInfo(const ElementInfo&)> loader =
+      [fs](const ElementInfo& info) {
+        return loadElement<ElementType>(fs, info);
+      };
+  QFuture<ElementInfo> future = QtConcurrent::mapped(elements, loader);
+  bool hasCategories = std::is_base_of<LibraryElement, ElementType>::value;
+  int  count         = 0;
+  int  lastPercent   = -1;
+  for (int i = 0; i < elements.count(); ++i) {
+    if (isAbortRequested()) {
+      future.cancel();
+      break;
+    }
+    ElementInfo   info = future.resultAt(i);
+    QElapsedTimer writeTimer;
+    writeTimer.start();
+    writeElementToDb(db, table, idColumn, hasCategories, info);  // can throw
+    mWriteTimeNs += writeTimer.nsecsElapsed();
+    if (info.status != ElementInfo::Status::Failed) {
+      ++count;
+    }
+    int percent = 1 + (98 * (stage * elements.count() + i + 1)) /
+                          (6 * elements.count());
+    if (percent != lastPercent) {
+      emit scanProgressUpdate(percent);
+      lastPercent = percent;
     }
   }
+  future.waitForFinished();  // workers access the file system
   return count;
 }
 
-template <typename ElementType>
-void WorkspaceLibraryScanner::addElementToDb(SQLiteDatabase& db,
-                                             const QString&  table,
-                                             const QString& idColumn, int libId,
-                                             const QString&     path,
-                                             const ElementType& element) {
-  QSqlQuery query = db.prepareQuery("INSERT INTO " % table %
-                                    " (lib_id, filepath, uuid, version) VALUES "
-                                    "(:lib_id, :filepath, :uuid, :version)");
-  query.bindValue(":lib_id", libId);
-  query.bindValue(":filepath", path);
-  query.bindValue(":uuid", element.getUuid().toStr());
-  query.bindValue(":version", element.getVersion().toStr());
-  int id = db.insert(query);
-  addElementTranslationsToDb(db, table % "_tr", idColumn, id, element);
-  addElementCategoriesToDb(db, table % "_cat", idColumn, id,
-                           element.getCategories());
-}
+void WorkspaceLibraryScanner::writeElementToDb(SQLiteDatabase& db,
+                                               const QString&  table,
+                                               const QString&  idColumn,
+                                               bool            hasCategories,
+                                               const ElementInfo& info) {
+  if (info.status == ElementInfo::Status::Unchanged) {
+    return;
+  } else if (info.status == ElementInfo::Status::Touched) {
+    QSqlQuery query = db.prepareCachedQuery(
+        "UPDATE " % table %
+        " SET lib_id = :lib_id, modified = :modified WHERE id = :id");
+    query.bindValue(":lib_id", info.libId);
+    query.bindValue(":modified", info.modified);
+    query.bindValue(":id", info.dbId);
+    db.exec(query);
+    ++mWrittenRows;
+    return;
+  }
 
-template <>
-void WorkspaceLibraryScanner::addElementToDb<Device>(
-    SQLiteDatabase& db, const QString& table, const QString& idColumn,
-    int libId, const QString& path, const Device& element) {
-  QSqlQuery query = db.prepareQuery("INSERT INTO " % table %
-                                    " "
-                                    "(lib_id, filepath, uuid, version, "
-                                    "component_uuid, package_uuid) VALUES "
-                                    "(:lib_id, :filepath, :uuid, :version, "
-                                    ":component_uuid, :package_uuid)");
-  query.bindValue(":lib_id", libId);
-  query.bindValue(":filepath", path);
-  query.bindValue(":uuid", element.getUuid().toStr());
-  query.bindValue(":version", element.getVersion().toStr());
-  query.bindValue(":component_uuid", element.getComponentUuid().toStr());
-  query.bindValue(":package_uuid", element.getPackageUuid().toStr());
+  // remove the outdated entry, translations and categories are deleted by
+  // cascade
+  if (info.dbId >= 0) {
+    QSqlQuery query =
+        db.prepareCachedQuery("DELETE FROM " % table % " WHERE id = :id");
+    query.bindValue(":id", info.dbId);
+    db.exec(query);
+    ++mWrittenRows;
+  }
+  if (info.status == ElementInfo::Status::Failed) {
+    return;
+  }
+
+  QString columns = "lib_id, filepath, uuid, version, modified, checksum";
+  QString values  = ":lib_id, :filepath, :uuid, :version, :modified, :checksum";
+  for (const auto& column : info.columns) {
+    columns += ", " % column.first;
+    values += ", :" % column.first;
+  }
+  QSqlQuery query = db.prepareCachedQuery("INSERT INTO " % table % " (" %
+                                          columns % ") VALUES (" % values %
+                                          ")");
+  query.bindValue(":lib_id", info.libId);
+  query.bindValue(":filepath", info.filepath);
+  query.bindValue(":uuid", info.uuid);
+  query.bindValue(":version", info.version);
+  query.bindValue(":modified", info.modified);
+  query.bindValue(":checksum", info.checksum);
+  for (const auto& column : info.columns) {
+    query.bindValue(":" % column.first, column.second);
+  }
   int id = db.insert(query);
-  addElementTranslationsToDb(db, table % "_tr", idColumn, id, element);
-  addElementCategoriesToDb(db, table % "_cat", idColumn, id,
-                           element.getCategories());
+  ++mWrittenRows;
+
+  QVector<QVariantList> rows;
+  foreach (const ElementInfo::Translation& tr, info.translations) {
+    rows.append(
+        QVariantList{id, tr.locale, tr.name, tr.description, tr.keywords});
+  }
+  db.insertBatch(table % "_tr",
+                 {idColumn, "locale", "name", "description", "keywords"},
+                 rows);
+  mWrittenRows += rows.count();
+
+  if (hasCategories) {
+    rows.clear();
+    foreach (const Uuid& categoryUuid, info.categories) {
+      rows.append(QVariantList{id, categoryUuid.toStr()});
+    }
+    db.insertBatch(table % "_cat", {idColumn, "category_uuid"}, rows);
+    mWrittenRows += rows.count();
+  }
 }
 
+/*******************************************************************************
+ *  Static Methods
+ ******************************************************************************/
+
 template <typename ElementType>
-void WorkspaceLibraryScanner::addElementTranslationsToDb(
-    SQLiteDatabase& db, const QString& table, const QString& idColumn, int id,
-    const ElementType& element) {
-  foreach (const QString& locale, element.getAllAvailableLocales()) {
-    QSqlQuery query = db.prepareQuery(
-        "INSERT INTO " % table % " (" % idColumn %
-        ", locale, name, description, keywords) VALUES "
-        "(:element_id, :locale, :name, :description, :keywords)");
-    query.bindValue(":element_id", id);
-    query.bindValue(":locale", locale);
-    query.bindValue(":name",
-                    optionalToVariant(element.getNames().tryGet(locale)));
-    query.bindValue(
-        ":description",
-        optionalToVariant(element.getDescriptions().tryGet(locale)));
-    query.bindValue(":keywords",
-                    optionalToVariant(element.getKeywords().tryGet(locale)));
-    db.insert(query);
+WorkspaceLibraryScanner::ElementInfo WorkspaceLibraryScanner::loadElement(
+    std::shared_ptr<TransactionalFileSystem> fs, ElementInfo info) noexcept {
+  try {
+    qint64 modified = getModificationTime(*fs, info.filepath);
+    if ((info.dbId >= 0) && (modified == info.modified)) {
+      info.status = ElementInfo::Status::Unchanged;
+      return info;
+    }
+    QByteArray checksum = calcChecksum(*fs, info.filepath);  // can throw
+    info.modified       = modified;
+    if ((info.dbId >= 0) && (checksum == info.checksum)) {
+      info.status = ElementInfo::Status::Touched;
+      return info;
+    }
+    info.checksum = checksum;
+
+    // only the metadata is needed, so don't load the whole element
+    TransactionalDirectory   dir(fs, info.filepath);
+    LibraryBaseElementHeader header =
+        LibraryBaseElementHeader::read<ElementType>(dir);  // can throw
+    info.uuid    = header.getUuid().toStr();
+    info.version = header.getVersion().toStr();
+    foreach (const QString& locale, header.getAllAvailableLocales()) {
+      info.translations.append(ElementInfo::Translation{
+          locale, optionalToVariant(header.getNames().tryGet(locale)),
+          optionalToVariant(header.getDescriptions().tryGet(locale)),
+          optionalToVariant(header.getKeywords().tryGet(locale))});
+    }
+    getElementColumns<ElementType>(header, info);  // can throw
+    info.status = ElementInfo::Status::Modified;
+  } catch (const Exception& e) {
+    qWarning() << "Failed to open library element:" << info.filepath;
+    qWarning() << "Error:" << e.getMsg();
+    info.status = ElementInfo::Status::Failed;
+  }
+  return info;
+}
+
+qint64 WorkspaceLibraryScanner::getModificationTime(
+    const TransactionalFileSystem& fs, const QString& dir) noexcept {
+  // The directory itself changes when files are added or removed, the files
+  // change when they are modified.
+  qint64 modified =
+      QFileInfo(fs.getAbsPath(dir).toStr()).lastModified().toMSecsSinceEpoch();
+  foreach (const QString& file, fs.getFiles(dir)) {
+    QFileInfo info(fs.getAbsPath(dir % "/" % file).toStr());
+    modified = qMax(modified, info.lastModified().toMSecsSinceEpoch());
   }
+  return modified;
 }
 
-void WorkspaceLibraryScanner::addElementCategoriesToDb(
-    SQLiteDatabase& db, const QString& table, const QString& idColumn, int id,
-    const QSet<Uuid>& categories) {
-  foreach (const Uuid& categoryUuid, categories) {
-    QSqlQuery query = db.prepareQuery("INSERT INTO " % table % " (" % idColumn %
-                                      ", category_uuid) VALUES "
-                                      "(:element_id, :category_uuid)");
-    query.bindValue(":element_id", id);
-    query.bindValue(":category_uuid", categoryUuid.toStr());
-    db.insert(query);
+QByteArray WorkspaceLibraryScanner::calcChecksum(
+    const TransactionalFileSystem& fs, const QString& dir) {
+  QStringList files = fs.getFiles(dir);
+  files.sort();  // make the checksum independent of the directory order
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  foreach (const QString& file, files) {
+    hash.addData(file.toUtf8());
+    hash.addData("\0", 1);
+    hash.addData(fs.read(dir % "/" % file));  // can throw
   }
+  return hash.result();
 }
 
 /*******************************************************************************
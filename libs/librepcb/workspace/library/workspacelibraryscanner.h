@@ -24,6 +24,7 @@
  *  Includes
  ******************************************************************************/
 #include <librepcb/common/fileio/filepath.h>
+#include <librepcb/common/uuid.h>
 
 #include <QtCore>
 
@@ -35,12 +36,12 @@
 
 namespace librepcb {
 
-class Uuid;
 class SQLiteDatabase;
 class TransactionalFileSystem;
 
 namespace library {
 class Library;
+class LibraryBaseElementHeader;
 }
 
 namespace workspace {
@@ -54,6 +55,13 @@ class Workspace;
 /**
  * @brief The WorkspaceLibraryScanner class
  *
+ * Scans all workspace libraries and updates the library database
+ * incrementally: Elements whose directory (including all files in it) has
+ * neither a newer modification time nor a different content hash than at
+ * the last scan are skipped, all other elements are loaded in parallel by
+ * worker threads of the global thread pool. Only the scanner thread writes
+ * to the database.
+ *
  * @warning Be very careful with dependencies to other objects as the #run()
  * method is executed in a separate thread! Keep the number of dependencies as
  * small as possible and consider thread synchronization and object lifetimes.
@@ -82,38 +90,84 @@ signals:
   void scanFailed(QString errorMsg);
   void scanFinished();
 
+private:  // Types
+  /**
+   * @brief State of a library element directory and its extracted metadata
+   *
+   * Created by the scanner thread, filled by #loadElement() in a worker
+   * thread and finally written to the database by #writeElementToDb().
+   */
+  struct ElementInfo {
+    enum class Status {
+      Unchanged,  ///< Unmodified since the last scan, nothing to do
+      Touched,    ///< Modification time changed but content did not
+      Modified,   ///< New or modified element, metadata was extracted
+      Failed,     ///< Failed to load element
+    };
+    struct Translation {
+      QString  locale;
+      QVariant name;
+      QVariant description;
+      QVariant keywords;
+    };
+
+    // Input
+    QString    filepath;
+    int        libId;
+    int        dbId;      ///< ID of the existing database entry, or -1
+    qint64     modified;  ///< Modification time in ms since the epoch
+    QByteArray checksum;  ///< Hash of all files in the element directory
+
+    // Output
+    Status                            status;
+    QString                           uuid;
+    QString                           version;
+    QVector<QPair<QString, QVariant>> columns;  ///< Type specific columns
+    QVector<Translation>              translations;
+    QSet<Uuid>                        categories;
+  };
+
+  /// Entry of an element in the database from the last scan
+  struct DbEntry {
+    int        id;
+    int        libId;
+    qint64     modified;
+    QByteArray checksum;
+  };
+
 private:  // Methods
   void                run() noexcept override;
   void                scan() noexcept;
   QHash<QString, int> updateLibraries(
       SQLiteDatabase&                                          db,
       const QHash<QString, std::shared_ptr<library::Library>>& libs);
-  void clearAllTables(SQLiteDatabase& db);
   void getLibrariesOfDirectory(
       std::shared_ptr<TransactionalFileSystem> fs, const QString& root,
       QHash<QString, std::shared_ptr<library::Library>>& libs) noexcept;
   template <typename ElementType>
-  int addCategoriesToDb(SQLiteDatabase&                          db,
-                        std::shared_ptr<TransactionalFileSystem> fs,
-                        const QString& libPath, const QStringList& dirs,
-                        const QString& table, const QString& idColumn,
-                        int libId);
-  template <typename ElementType>
-  int addElementsToDb(SQLiteDatabase&                          db,
-                      std::shared_ptr<TransactionalFileSystem> fs,
-                      const QString& libPath, const QStringList& dirs,
-                      const QString& table, const QString& idColumn, int libId);
+  int updateElementsInDb(
+      SQLiteDatabase& db, std::shared_ptr<TransactionalFileSystem> fs,
+      const QHash<QString, std::shared_ptr<library::Library>>& libs,
+      const QHash<QString, int>& libIds, const QString& table,
+      const QString& idColumn, int stage);
+  void writeElementToDb(SQLiteDatabase& db, const QString& table,
+                        const QString& idColumn, bool hasCategories,
+                        const ElementInfo& info);
+  bool isAbortRequested() noexcept {
+    return mAbort || (mSemaphore.available() > 0);
+  }
+
+  // Static Methods
   template <typename ElementType>
-  void addElementToDb(SQLiteDatabase& db, const QString& table,
-                      const QString& idColumn, int libId, const QString& path,
-                      const ElementType& element);
+  static ElementInfo loadElement(std::shared_ptr<TransactionalFileSystem> fs,
+                                 ElementInfo info) noexcept;
   template <typename ElementType>
-  void addElementTranslationsToDb(SQLiteDatabase& db, const QString& table,
-                                  const QString& idColumn, int id,
-                                  const ElementType& element);
-  void addElementCategoriesToDb(SQLiteDatabase& db, const QString& table,
-                                const QString& idColumn, int id,
-                                const QSet<Uuid>& categories);
+  static void getElementColumns(const library::LibraryBaseElementHeader& header,
+                                ElementInfo&                             info);
+  static qint64      getModificationTime(const TransactionalFileSystem& fs,
+                                         const QString& dir) noexcept;
+  static QByteArray  calcChecksum(const TransactionalFileSystem& fs,
+                                  const QString&                 dir);
   template <typename T>
   static QVariant optionalToVariant(const T& opt) noexcept;
 
@@ -122,6 +176,8 @@ private:  // Data
   FilePath      mDbFilePath;
   QSemaphore    mSemaphore;
   volatile bool mAbort;
+  qint64        mWrittenRows;  ///< Statistics of the current scan
+  qint64        mWriteTimeNs;  ///< Statistics of the current scan
 };
 
 /*******************************************************************************
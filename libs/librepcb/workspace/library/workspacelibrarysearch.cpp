@@ -0,0 +1,174 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+#include "workspacelibrarysearch.h"
+
+#include "workspacelibrarydb.h"
+
+#include <librepcb/library/cat/componentcategory.h>
+#include <librepcb/library/cat/packagecategory.h>
+#include <librepcb/library/cmp/component.h>
+#include <librepcb/library/dev/device.h>
+#include <librepcb/library/library.h>
+#include <librepcb/library/pkg/package.h>
+#include <librepcb/library/sym/symbol.h>
+
+#include <QtCore>
+
+/*******************************************************************************
+ *  Namespace
+ ******************************************************************************/
+namespace librepcb {
+namespace workspace {
+
+using namespace library;
+
+/*******************************************************************************
+ *  Constructors / Destructor
+ ******************************************************************************/
+
+WorkspaceLibrarySearch::WorkspaceLibrarySearch(const WorkspaceLibraryDb& db,
+                                               QObject* parent) noexcept
+  : QObject(parent),
+    mDb(db),
+    mGeneration(std::make_shared<QAtomicInt>(0)),
+    mWatchedGeneration(0) {
+  connect(&mWatcher, &QFutureWatcher<Result>::finished, this,
+          &WorkspaceLibrarySearch::searchFinished);
+}
+
+WorkspaceLibrarySearch::~WorkspaceLibrarySearch() noexcept {
+  cancel();
+}
+
+/*******************************************************************************
+ *  Setters
+ ******************************************************************************/
+
+template <>
+void WorkspaceLibrarySearch::addElementType<Library>() noexcept {
+  addTable(Library::getShortElementName(), "libraries", "lib_id");
+}
+
+template <>
+void WorkspaceLibrarySearch::addElementType<ComponentCategory>() noexcept {
+  addTable(ComponentCategory::getShortElementName(), "component_categories",
+           "cat_id");
+}
+
+template <>
+void WorkspaceLibrarySearch::addElementType<PackageCategory>() noexcept {
+  addTable(PackageCategory::getShortElementName(), "package_categories",
+           "cat_id");
+}
+
+template <>
+void WorkspaceLibrarySearch::addElementType<Symbol>() noexcept {
+  addTable(Symbol::getShortElementName(), "symbols", "symbol_id");
+}
+
+template <>
+void WorkspaceLibrarySearch::addElementType<Package>() noexcept {
+  addTable(Package::getShortElementName(), "packages", "package_id");
+}
+
+template <>
+void WorkspaceLibrarySearch::addElementType<Component>() noexcept {
+  addTable(Component::getShortElementName(), "components", "component_id");
+}
+
+template <>
+void WorkspaceLibrarySearch::addElementType<Device>() noexcept {
+  addTable(Device::getShortElementName(), "devices", "device_id");
+}
+
+/*******************************************************************************
+ *  General Methods
+ ******************************************************************************/
+
+void WorkspaceLibrarySearch::start(const QString& keyword) noexcept {
+  int generation     = mGeneration->fetchAndAddOrdered(1) + 1;
+  mWatchedGeneration = generation;
+
+  // capture copies only, the search may outlive this object
+  const WorkspaceLibraryDb&         db      = mDb;
+  std::shared_ptr<const QAtomicInt> current = mGeneration;
+  QList<Table>                      tables  = mTables;
+  mWatcher.setFuture(db.runAsync([&db, current, generation, tables, keyword]() {
+    return search(db, current, generation, tables, keyword);
+  }));
+}
+
+void WorkspaceLibrarySearch::cancel() noexcept {
+  mGeneration->fetchAndAddOrdered(1);
+}
+
+/*******************************************************************************
+ *  Private Methods
+ ******************************************************************************/
+
+void WorkspaceLibrarySearch::addTable(const QString& elementName,
+                                      const QString& tablename,
+                                      const QString& idrowname) noexcept {
+  mTables.append(Table{elementName, tablename, idrowname});
+}
+
+void WorkspaceLibrarySearch::searchFinished() noexcept {
+  // ignore the result if the search was cancelled in the meantime
+  if (mWatchedGeneration == mGeneration->loadAcquire()) {
+    emit finished(mWatcher.result());
+  }
+}
+
+WorkspaceLibrarySearch::Result WorkspaceLibrarySearch::search(
+    const WorkspaceLibraryDb&         db,
+    std::shared_ptr<const QAtomicInt> currentGeneration, int generation,
+    const QList<Table>& tables, const QString& keyword) noexcept {
+  Result result;
+  result.keyword = keyword;
+  auto isStale   = [&currentGeneration, generation]() {
+    return currentGeneration->loadAcquire() != generation;
+  };
+  if (isStale()) {
+    return result;  // a newer search has been started already
+  }
+
+  try {
+    foreach (const Table& table, tables) {
+      result.elements.insert(table.elementName,
+                             db.searchElements(table.tablename, table.idrowname,
+                                               keyword, isStale));  // can throw
+      if (isStale()) break;
+    }
+  } catch (const Exception& e) {
+    result.error = e.getMsg();
+  }
+  return result;
+}
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace workspace
+}  // namespace librepcb
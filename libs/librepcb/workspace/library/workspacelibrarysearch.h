@@ -0,0 +1,135 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBREPCB_WORKSPACE_WORKSPACELIBRARYSEARCH_H
+#define LIBREPCB_WORKSPACE_WORKSPACELIBRARYSEARCH_H
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+#include <librepcb/common/fileio/filepath.h>
+#include <librepcb/common/uuid.h>
+
+#include <QtCore>
+
+#include <memory>
+
+/*******************************************************************************
+ *  Namespace / Forward Declarations
+ ******************************************************************************/
+namespace librepcb {
+namespace workspace {
+
+class WorkspaceLibraryDb;
+
+/*******************************************************************************
+ *  Class WorkspaceLibrarySearch
+ ******************************************************************************/
+
+/**
+ * @brief Search library elements by keyword in a background thread
+ *
+ * Every call to #start() cancels the previous search, so it can be called on
+ * every keystroke of a search field without blocking the GUI. Searches which
+ * have not been started yet are skipped, and a running search stops reading
+ * its results. Only the result of the latest search is reported by
+ * #finished().
+ *
+ * The queries run on the thread pool of
+ * librepcb::workspace::WorkspaceLibraryDb, thus they use a read-only database
+ * connection which doesn't interfere with the library scanner.
+ */
+class WorkspaceLibrarySearch final : public QObject {
+  Q_OBJECT
+
+public:
+  // Types
+  struct Result {
+    QString                     keyword;
+    QHash<QString, QList<Uuid>> elements;  ///< Key: short element name
+    QString                     error;     ///< Empty if successful
+
+    template <typename ElementType>
+    QList<Uuid> get() const noexcept {
+      return elements.value(ElementType::getShortElementName());
+    }
+  };
+
+  // Constructors / Destructor
+  WorkspaceLibrarySearch()                                    = delete;
+  WorkspaceLibrarySearch(const WorkspaceLibrarySearch& other) = delete;
+  explicit WorkspaceLibrarySearch(const WorkspaceLibraryDb& db,
+                                  QObject* parent = nullptr) noexcept;
+  ~WorkspaceLibrarySearch() noexcept;
+
+  // Setters
+
+  /**
+   * @brief Add an element type to search for
+   *
+   * @note  Must not be called while a search is running.
+   */
+  template <typename ElementType>
+  void addElementType() noexcept;
+
+  // General Methods
+  void start(const QString& keyword) noexcept;
+  void cancel() noexcept;
+
+  // Operator Overloadings
+  WorkspaceLibrarySearch& operator=(const WorkspaceLibrarySearch& rhs) = delete;
+
+signals:
+  void finished(const WorkspaceLibrarySearch::Result& result);
+
+private:  // Types
+  struct Table {
+    QString elementName;
+    QString tablename;
+    QString idrowname;
+  };
+
+private:  // Methods
+  void          addTable(const QString& elementName, const QString& tablename,
+                         const QString& idrowname) noexcept;
+  void          searchFinished() noexcept;
+  static Result search(const WorkspaceLibraryDb&          db,
+                       std::shared_ptr<const QAtomicInt> currentGeneration,
+                       int generation, const QList<Table>& tables,
+                       const QString& keyword) noexcept;
+
+private:  // Data
+  const WorkspaceLibraryDb& mDb;
+  QList<Table>              mTables;
+  QFutureWatcher<Result>    mWatcher;
+
+  /// Incremented on every start, shared with the running searches since
+  /// they may outlive this object
+  std::shared_ptr<QAtomicInt> mGeneration;
+  int                         mWatchedGeneration;
+};
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace workspace
+}  // namespace librepcb
+
+#endif  // LIBREPCB_WORKSPACE_WORKSPACELIBRARYSEARCH_H
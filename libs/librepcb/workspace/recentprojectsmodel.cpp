@@ -106,7 +106,7 @@ void RecentProjectsModel::save() noexcept {
       root.appendChild("project", filepath.toRelative(mWorkspace.getPath()),
                        true);
     }
-    FileUtils::writeFile(mFilePath, root.toByteArray());  // can throw
+    FileUtils::writeFile(mFilePath, root);  // can throw
   } catch (Exception& e) {
     qWarning() << "Could not save recent projects file:" << e.getMsg();
   }
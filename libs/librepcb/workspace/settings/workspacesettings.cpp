@@ -115,7 +115,7 @@ void WorkspaceSettings::loadSettingsItem(QScopedPointer<T>& member,
 
 void WorkspaceSettings::saveToFile() const {
   SExpression doc(serializeToDomElement("librepcb_workspace_settings"));
-  FileUtils::writeFile(mFilePath, doc.toByteArray());  // can throw
+  FileUtils::writeFile(mFilePath, doc);  // can throw
 }
 
 void WorkspaceSettings::serialize(SExpression& root) const {
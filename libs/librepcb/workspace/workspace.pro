@@ -10,7 +10,7 @@ TARGET = librepcbworkspace
 # Use common project definitions
 include(../../../common.pri)
 
-QT += core widgets xml sql printsupport
+QT += core widgets xml sql printsupport concurrent
 
 CONFIG += staticlib
 
@@ -26,6 +26,7 @@ SOURCES += \
     library/cat/categorytreemodel.cpp \
     library/workspacelibrarydb.cpp \
     library/workspacelibraryscanner.cpp \
+    library/workspacelibrarysearch.cpp \
     projecttreemodel.cpp \
     recentprojectsmodel.cpp \
     settings/items/wsi_appdefaultmeasurementunits.cpp \
@@ -49,6 +50,7 @@ HEADERS += \
     library/cat/categorytreemodel.h \
     library/workspacelibrarydb.h \
     library/workspacelibraryscanner.h \
+    library/workspacelibrarysearch.h \
     projecttreemodel.h \
     recentprojectsmodel.h \
     settings/items/wsi_appdefaultmeasurementunits.h \
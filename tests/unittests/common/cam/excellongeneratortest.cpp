@@ -0,0 +1,158 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <librepcb/common/cam/excellongenerator.h>
+
+#include <QtCore>
+
+/*******************************************************************************
+ *  Namespace
+ ******************************************************************************/
+namespace librepcb {
+namespace tests {
+
+/*******************************************************************************
+ *  Test Class
+ ******************************************************************************/
+
+class ExcellonGeneratorTest : public ::testing::Test {
+protected:
+  static QStringList getHits(const ExcellonGenerator& gen) noexcept {
+    QStringList hits;
+    foreach (const QString& line, gen.toStr().split('\n')) {
+      if (line.startsWith('T') || line.startsWith('X')) {
+        hits.append(line);
+      }
+    }
+    return hits;
+  }
+
+  static QList<QStringList> getSortedHitsPerTool(
+      const ExcellonGenerator& gen) noexcept {
+    QList<QStringList> tools;
+    foreach (const QString& line, getHits(gen)) {
+      if (line.startsWith('X')) {
+        tools.last().append(line);
+      } else if (!line.contains('C')) {  // tool selection, not tool list
+        tools.append(QStringList());
+      }
+    }
+    for (QStringList& hits : tools) {
+      hits.sort();
+    }
+    return tools;
+  }
+
+  static void drillPseudoRandomHits(ExcellonGenerator& gen, int count,
+                                    const PositiveLength& dia) noexcept {
+    quint32 seed = 42;
+    for (int i = 0; i < count; ++i) {
+      seed          = seed * 1103515245u + 12345u;
+      LengthBase_t x = ((seed >> 8) % 100000) * 1000;  // 0..100mm
+      seed          = seed * 1103515245u + 12345u;
+      LengthBase_t y = ((seed >> 8) % 100000) * 1000;  // 0..100mm
+      gen.drill(Point(x, y), dia);
+    }
+  }
+};
+
+/*******************************************************************************
+ *  Test Methods
+ ******************************************************************************/
+
+TEST_F(ExcellonGeneratorTest, testTravelDistanceWithoutOptimization) {
+  ExcellonGenerator gen;
+  gen.drill(Point(3000000, 4000000), PositiveLength(500000));
+  gen.drill(Point(0, 2000000), PositiveLength(800000));
+  EXPECT_EQ(0, gen.getTotalTravelDistance()->toNm());
+  gen.generate();
+  // every tool starts at the origin
+  EXPECT_EQ(7000000, gen.getTotalTravelDistance()->toNm());
+  EXPECT_EQ(7000000, gen.getUnoptimizedTravelDistance()->toNm());
+  gen.reset();
+  EXPECT_EQ(0, gen.getTotalTravelDistance()->toNm());
+  EXPECT_EQ(0, gen.getUnoptimizedTravelDistance()->toNm());
+}
+
+TEST_F(ExcellonGeneratorTest, testNearestNeighbourOrder) {
+  ExcellonGenerator gen;
+  gen.setOptimizeToolPaths(true);
+  PositiveLength dia(500000);
+  gen.drill(Point(3000000, 0), dia);
+  gen.drill(Point(1000000, 0), dia);
+  gen.drill(Point(4000000, 0), dia);
+  gen.drill(Point(2000000, 0), dia);
+  gen.generate();
+  QStringList expected = {"T1C0.5", "T1",       "X1.0Y0.0", "X2.0Y0.0",
+                          "X3.0Y0.0", "X4.0Y0.0", "T0"};
+  EXPECT_EQ(expected.join(' ').toStdString(),
+            getHits(gen).join(' ').toStdString());
+  EXPECT_EQ(4000000, gen.getTotalTravelDistance()->toNm());
+}
+
+TEST_F(ExcellonGeneratorTest, testOptimizationKeepsAllHits) {
+  ExcellonGenerator unoptimized;
+  drillPseudoRandomHits(unoptimized, 500, PositiveLength(300000));
+  drillPseudoRandomHits(unoptimized, 5000, PositiveLength(1000000));
+  unoptimized.generate();
+
+  ExcellonGenerator optimized;
+  optimized.setOptimizeToolPaths(true);
+  drillPseudoRandomHits(optimized, 500, PositiveLength(300000));
+  drillPseudoRandomHits(optimized, 5000, PositiveLength(1000000));
+  optimized.generate();
+
+  EXPECT_EQ(getSortedHitsPerTool(unoptimized),
+            getSortedHitsPerTool(optimized));
+  EXPECT_NE(getHits(unoptimized), getHits(optimized));
+  // random order vs. heuristic order: expect at least 5 times shorter travel
+  EXPECT_LT(optimized.getTotalTravelDistance()->toNm() * 5,
+            unoptimized.getTotalTravelDistance()->toNm());
+  EXPECT_EQ(unoptimized.getTotalTravelDistance()->toNm(),
+            optimized.getUnoptimizedTravelDistance()->toNm());
+}
+
+TEST_F(ExcellonGeneratorTest, testOptimizationIsDeterministic) {
+  ExcellonGenerator gen1;
+  gen1.setOptimizeToolPaths(true);
+  drillPseudoRandomHits(gen1, 3000, PositiveLength(300000));
+  gen1.generate();
+
+  ExcellonGenerator gen2;
+  gen2.setOptimizeToolPaths(true);
+  drillPseudoRandomHits(gen2, 3000, PositiveLength(300000));
+  gen2.generate();
+
+  EXPECT_EQ(getHits(gen1), getHits(gen2));
+  EXPECT_EQ(gen1.getTotalTravelDistance()->toNm(),
+            gen2.getTotalTravelDistance()->toNm());
+}
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace tests
+}  // namespace librepcb
@@ -0,0 +1,88 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <librepcb/common/cam/gerberaperturelist.h>
+
+#include <QtCore>
+
+/*******************************************************************************
+ *  Namespace
+ ******************************************************************************/
+namespace librepcb {
+namespace tests {
+
+/*******************************************************************************
+ *  Test Class
+ ******************************************************************************/
+
+class GerberApertureListTest : public ::testing::Test {};
+
+/*******************************************************************************
+ *  Test Methods
+ ******************************************************************************/
+
+TEST_F(GerberApertureListTest, testEqualAperturesAreReused) {
+  GerberApertureList list;
+  UnsignedLength     w(1000000);
+  UnsignedLength     h(500000);
+  UnsignedLength     hole(0);
+  EXPECT_EQ(10, list.setCircle(w, hole));
+  EXPECT_EQ(11, list.setRect(w, h, Angle::deg0(), hole));
+  EXPECT_EQ(10, list.setCircle(w, hole));
+  EXPECT_EQ(11, list.setRect(w, h, Angle::deg180(), hole));
+  EXPECT_EQ(11, list.setRect(h, w, Angle::deg90(), hole));
+  EXPECT_EQ(12, list.setRect(h, w, Angle::deg0(), hole));
+  EXPECT_EQ(13, list.setObround(w, h, Angle::deg45(), hole));
+  EXPECT_EQ(13, list.setObround(w, h, Angle::deg45(), hole));
+  EXPECT_EQ(14, list.setRegularPolygon(w, 8, Angle::deg0(), hole));
+  list.reset();
+  EXPECT_EQ(10, list.setRect(w, h, Angle::deg0(), hole));
+}
+
+TEST_F(GerberApertureListTest, testGenerateString) {
+  GerberApertureList list;
+  list.setCircle(UnsignedLength(1000000), UnsignedLength(0));
+  list.setRect(UnsignedLength(1000000), UnsignedLength(500000), Angle::deg90(),
+               UnsignedLength(200000));
+  list.setRect(UnsignedLength(1000000), UnsignedLength(500000), Angle::deg45(),
+               UnsignedLength(0));
+  list.setRegularPolygon(UnsignedLength(2000000), 8, Angle::deg0(),
+                         UnsignedLength(0));
+  QString expected =
+      "G04 --- APERTURE LIST BEGIN --- *\n"
+      "%AMROTATEDRECT*21,1,$1,$2,0,0,$3*%\n"
+      "%ADD10C,1.0*%\n"
+      "%ADD11R,0.5X1.0X0.2*%\n"
+      "%ADD12ROTATEDRECT,1.0X0.5X45.0*%\n"
+      "%ADD13P,2.0X8X22.5*%\n"
+      "G04 --- APERTURE LIST END --- *\n";
+  EXPECT_EQ(expected.toStdString(), list.generateString().toStdString());
+}
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace tests
+}  // namespace librepcb
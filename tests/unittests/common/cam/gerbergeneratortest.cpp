@@ -0,0 +1,200 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <librepcb/common/cam/gerbergenerator.h>
+#include <librepcb/common/fileio/fileutils.h>
+
+#include <QtCore>
+
+#include <iostream>
+#include <limits>
+
+/*******************************************************************************
+ *  Namespace
+ ******************************************************************************/
+namespace librepcb {
+namespace tests {
+
+/*******************************************************************************
+ *  Test Class
+ ******************************************************************************/
+
+class GerberGeneratorTest : public ::testing::Test {
+protected:
+  GerberGeneratorTest()
+    : mUuid(Uuid::fromString("c3a5a7b0-7b3a-4bb7-9e8a-0b8f5b6c6e42")) {}
+
+  static QVector<QPair<Point, Point>> createLines(int count) noexcept {
+    QVector<QPair<Point, Point>> lines;
+    for (int i = 0; i < count; ++i) {
+      Point p1(Length(i * 12345 - 500000000), Length(-i * 7 + 3));
+      Point p2(Length(-i * 1001), Length(i * 54321 - 1000000000));
+      lines.append(qMakePair(p1, p2));
+    }
+    return lines;
+  }
+
+  // Content as it was formatted with QString by former versions.
+  static QString formatWithQString(
+      const QVector<QPair<Point, Point>>& lines) noexcept {
+    QString content = QString("D%1*\n").arg(10);
+    for (const auto& line : lines) {
+      content.append(QString("X%1Y%2D02*\n")
+                         .arg(line.first.getX().toNmString(),
+                              line.first.getY().toNmString()));
+      content.append(QString("X%1Y%2D01*\n")
+                         .arg(line.second.getX().toNmString(),
+                              line.second.getY().toNmString()));
+    }
+    return content;
+  }
+
+  static QByteArray calcMd5WithQString(const QString& output) noexcept {
+    QString data = QString(output).remove(QChar('\n'));
+    return QCryptographicHash::hash(data.toUtf8(), QCryptographicHash::Md5)
+        .toHex();
+  }
+
+  Uuid mUuid;
+};
+
+/*******************************************************************************
+ *  Test Methods
+ ******************************************************************************/
+
+TEST_F(GerberGeneratorTest, testCoordinateFormat) {
+  QList<LengthBase_t> values = {
+      0,
+      1,
+      -1,
+      9,
+      -10,
+      123456789,
+      -9876543210LL,
+      std::numeric_limits<LengthBase_t>::max(),
+      std::numeric_limits<LengthBase_t>::min(),
+  };
+  foreach (LengthBase_t value, values) {
+    GerberGenerator gen("Project", mUuid, "1");
+    gen.flashCircle(Point(Length(value), Length(value)),
+                    UnsignedLength(100000), UnsignedLength(0));
+    gen.generate();
+    QByteArray expected =
+        QString("X%1Y%1D03*\n").arg(Length(value).toNmString()).toLatin1();
+    EXPECT_TRUE(gen.toByteArray().contains(expected))
+        << qPrintable(QString(expected));
+  }
+}
+
+TEST_F(GerberGeneratorTest, testMd5Checksum) {
+  GerberGenerator gen("Project", mUuid, "1");
+  foreach (const auto& line, createLines(100)) {
+    gen.drawLine(line.first, line.second, UnsignedLength(100000));
+  }
+  gen.generate();
+  QByteArray output = gen.toByteArray();
+  int        index  = output.indexOf("%TF.MD5,");
+  ASSERT_GT(index, 0);
+  QByteArray expected = calcMd5WithQString(QString(output.left(index)));
+  EXPECT_EQ(QByteArray("%TF.MD5,") + expected + "*%\nM02*\n",
+            output.mid(index));
+}
+
+TEST_F(GerberGeneratorTest, testMd5ChecksumWithNonLatin1Characters) {
+  // Non-Latin-1 characters are written as "?" and the checksum is calculated
+  // over the written bytes. Former versions calculated it over the UTF-8
+  // encoded characters instead, i.e. the checksum of such files has changed.
+  GerberGenerator gen(QString("Project ") + QChar(0x03A9), mUuid, "1");
+  gen.generate();
+  QByteArray output = gen.toByteArray();
+  EXPECT_TRUE(output.contains("%TF.ProjectId,Project ?,"));
+  int index = output.indexOf("%TF.MD5,");
+  ASSERT_GT(index, 0);
+  QByteArray expected =
+      QCryptographicHash::hash(output.left(index).replace('\n', ""),
+                               QCryptographicHash::Md5)
+          .toHex();
+  EXPECT_EQ(QByteArray("%TF.MD5,") + expected + "*%\nM02*\n",
+            output.mid(index));
+}
+
+TEST_F(GerberGeneratorTest, testStreamLargeContent) {
+  // draw enough lines to exceed the size of the in-memory content buffer
+  GerberGenerator gen("Project", mUuid, "1");
+  QVector<QPair<Point, Point>> lines = createLines(500000);
+  foreach (const auto& line, lines) {
+    gen.drawLine(line.first, line.second, UnsignedLength(100000));
+  }
+  gen.generate();
+  QByteArray output = gen.toByteArray();
+  EXPECT_GT(output.size(), 16 * 1024 * 1024);
+
+  // content must be complete and in the correct order
+  QByteArray content = formatWithQString(lines).toLatin1();
+  EXPECT_TRUE(output.contains(QByteArray("G04 --- BOARD BEGIN --- *\n") +
+                              content + "G04 --- BOARD END --- *\n"));
+
+  // checksum must be calculated over the streamed content
+  int index = output.indexOf("%TF.MD5,");
+  ASSERT_GT(index, 0);
+  QByteArray expected = calcMd5WithQString(QString(output.left(index)));
+  EXPECT_EQ(QByteArray("%TF.MD5,") + expected + "*%\nM02*\n",
+            output.mid(index));
+
+  // written file must be identical
+  QTemporaryDir dir;
+  ASSERT_TRUE(dir.isValid());
+  FilePath fp(dir.path() + "/test.gbr");
+  gen.saveToFile(fp);
+  EXPECT_EQ(output, FileUtils::readFile(fp));
+}
+
+TEST_F(GerberGeneratorTest, benchmark100kPrimitives) {
+  QVector<QPair<Point, Point>> lines = createLines(100000);
+
+  QElapsedTimer timer;
+  timer.start();
+  GerberGenerator gen("Project", mUuid, "1");
+  foreach (const auto& line, lines) {
+    gen.drawLine(line.first, line.second, UnsignedLength(100000));
+  }
+  gen.generate();
+  qint64 elapsedNs = timer.nsecsElapsed();
+
+  // the content must be formatted the same way as by former versions
+  EXPECT_TRUE(gen.toByteArray().contains(
+      QByteArray("G04 --- BOARD BEGIN --- *\n") +
+      formatWithQString(lines).toLatin1() + "G04 --- BOARD END --- *\n"));
+
+  std::cout << "Generated " << lines.count() << " lines ("
+            << gen.toByteArray().size() << " bytes) in "
+            << (elapsedNs / 1000000) << " ms" << std::endl;
+}
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace tests
+}  // namespace librepcb
@@ -0,0 +1,277 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <librepcb/common/fileio/fileutils.h>
+#include <librepcb/common/fileio/sexpression.h>
+
+#include <QtCore>
+
+#include <iostream>
+
+/*******************************************************************************
+ *  Namespace
+ ******************************************************************************/
+namespace librepcb {
+namespace tests {
+
+/*******************************************************************************
+ *  Test Class
+ ******************************************************************************/
+
+class SExpressionTest : public ::testing::Test {};
+
+/**
+ * @brief Output device which accepts only a part of each write, like a full
+ *        disk
+ */
+class PartialWriteDevice final : public QIODevice {
+public:
+  QByteArray mContent;
+
+protected:
+  qint64 readData(char* data, qint64 maxSize) override {
+    Q_UNUSED(data);
+    Q_UNUSED(maxSize);
+    return -1;
+  }
+  qint64 writeData(const char* data, qint64 maxSize) override {
+    qint64 size = qMin(maxSize, qint64(100));
+    mContent.append(data, size);
+    return size;
+  }
+};
+
+/*******************************************************************************
+ *  Test Methods
+ ******************************************************************************/
+
+TEST_F(SExpressionTest, testParseList) {
+  FilePath    fp("/foo/bar.lp");
+  SExpression s = SExpression::parse("(test foo \"bar\" (child 42))\n", fp);
+  EXPECT_TRUE(s.isList());
+  EXPECT_EQ("test", s.getName());
+  EXPECT_EQ(fp, s.getFilePath());
+  ASSERT_EQ(3, s.getChildren().count());
+  EXPECT_TRUE(s.getChildByIndex(0).isToken());
+  EXPECT_EQ("foo", s.getChildByIndex(0).getStringOrToken());
+  EXPECT_TRUE(s.getChildByIndex(1).isString());
+  EXPECT_EQ("bar", s.getChildByIndex(1).getStringOrToken());
+  EXPECT_TRUE(s.getChildByIndex(2).isList());
+  EXPECT_EQ(42, s.getValueByPath<int>("child"));
+  EXPECT_EQ(fp, s.getChildByIndex(2).getFilePath());
+}
+
+TEST_F(SExpressionTest, testParseEscapedString) {
+  SExpression s =
+      SExpression::parse("(test \"a\\\"b\\\\c\\nd\\te\")", FilePath());
+  EXPECT_EQ("a\"b\\c\nd\te", s.getValueOfFirstChild<QString>());
+}
+
+TEST_F(SExpressionTest, testParseUtf8) {
+  SExpression s =
+      SExpression::parse(QString("(test \"µöäü\")").toUtf8(), FilePath());
+  EXPECT_EQ(QString("µöäü"), s.getValueOfFirstChild<QString>());
+}
+
+TEST_F(SExpressionTest, testParseOnlySomeRootChildren) {
+  SExpression s = SExpression::parse(
+      "(test foo (a 1) (b (a 2) \"(\\\")\") (a (c 3)) \"bar\" (d)) \n",
+      FilePath(), {"a", "d"});
+  ASSERT_EQ(5, s.getChildren().count());
+  EXPECT_EQ("foo", s.getChildByIndex(0).getStringOrToken());
+  EXPECT_EQ(1, s.getChildByIndex(1).getValueOfFirstChild<int>());
+  EXPECT_EQ(3, s.getChildByIndex(2).getValueByPath<int>("c"));
+  EXPECT_EQ("bar", s.getChildByIndex(3).getStringOrToken());
+  EXPECT_EQ("d", s.getChildByIndex(4).getName());
+  EXPECT_EQ(nullptr, s.tryGetChildByPath("b"));
+  EXPECT_THROW(SExpression::parse("(test (b (a \"x)))", FilePath(), {"a"}),
+               FileParseError);
+  EXPECT_THROW(SExpression::parse("(test (b (a 1))", FilePath(), {"a"}),
+               FileParseError);
+}
+
+TEST_F(SExpressionTest, testGetChildrenByName) {
+  SExpression s =
+      SExpression::parse("(test (a 1) (b 2) (a 3) \"a\" a)", FilePath());
+  QList<SExpression> children = s.getChildren("a");
+  ASSERT_EQ(2, children.count());
+  EXPECT_EQ(1, children.at(0).getValueOfFirstChild<int>());
+  EXPECT_EQ(3, children.at(1).getValueOfFirstChild<int>());
+}
+
+TEST_F(SExpressionTest, testAppendChildToParsedList) {
+  SExpression s = SExpression::parse("(test (a 1))", FilePath());
+  s.appendChild("b", 2, false);
+  EXPECT_EQ(2, s.getChildren().count());
+  EXPECT_EQ(1, s.getValueByPath<int>("a"));
+  EXPECT_EQ(2, s.getValueByPath<int>("b"));
+}
+
+TEST_F(SExpressionTest, testParseSerializeRoundTrip) {
+  SExpression root = SExpression::createList("test");
+  root.appendChild("name", QString("\"Foo\"\n\\Bar"), true);
+  root.appendChild("value", 42, true);
+  QByteArray serialized = root.toByteArray();
+  SExpression parsed    = SExpression::parse(serialized, FilePath());
+  EXPECT_EQ("\"Foo\"\n\\Bar", parsed.getValueByPath<QString>("name"));
+  EXPECT_EQ(42, parsed.getValueByPath<int>("value"));
+}
+
+TEST_F(SExpressionTest, testParseInvalidContent) {
+  QList<QByteArray> invalid = {
+      "",             // no root node
+      "foo",          // root node is not a list
+      "()",           // list without name
+      "((foo))",      // list without name
+      "(foo",         // missing closing parenthesis
+      "(foo))",       // unexpected closing parenthesis
+      "(foo) (bar)",  // multiple root nodes
+      "(foo \"bar)",  // unterminated string
+  };
+  foreach (const QByteArray& content, invalid) {
+    EXPECT_THROW(SExpression::parse(content, FilePath()), FileParseError)
+        << qPrintable(QString(content));
+  }
+}
+
+TEST_F(SExpressionTest, testParseErrorColumnCountsCharacters) {
+  // "\xC3\xA4" and "\xC3\xB6" are the UTF-8 encoded umlauts "ä" and "ö"
+  QByteArray content = "(test\n (a \"\xC3\xA4\xC3\xB6\" \"x))";
+  try {
+    SExpression::parse(content, FilePath());
+    FAIL() << "No exception thrown.";
+  } catch (const FileParseError& e) {
+    EXPECT_TRUE(e.getMsg().contains("Line,Column: 2,10"))
+        << qPrintable(e.getMsg());
+  }
+}
+
+TEST_F(SExpressionTest, testSerializeGolden) {
+  // The golden file was written by the former (QString based) serializer, so
+  // any change of the output format is detected here.
+  SExpression root = SExpression::createList("librepcb_test");
+  root.appendChild(SExpression::createToken("a1b2-c3"), false);
+  root.appendChild("name", QString("Foo \"bar\"\n\\µ"), true);
+  root.appendChild("escapes", QString("\a\b\f\n\r\t\v"), true);
+  root.appendChild("unicode", QString("µ € \U0001F600"), true);
+  // lone surrogates are not valid UTF-16 and are written as '?'
+  QString surrogates = QString("a") % QChar(0xD800) % "b" % QChar(0xDC00);
+  root.appendChild("surrogates", surrogates, true);
+  root.appendChild("empty_string", QString(""), true);
+  root.appendList("empty", true);
+  root.appendLineBreak();
+  root.appendLineBreak();
+  SExpression& nested = root.appendList("nested", true);
+  nested.appendChild("value", 42, false);
+  nested.appendChild("child", true, true);
+  SExpression& deep = nested.appendList("deep", true);
+  deep.appendChild(SExpression::createToken("x"), false);
+  deep.appendLineBreak();
+  deep.appendLineBreak();
+  deep.appendLineBreak();
+  deep.appendChild(SExpression::createString("y"), false);
+  deep.appendLineBreak();
+  SExpression& inlineList = nested.appendList("inline", true);
+  inlineList.appendChild(SExpression::createToken("1"), false);
+  inlineList.appendChild("sub", QString("z"), false);
+  SExpression& position = root.appendList("position", true);
+  position.appendChild(SExpression::createToken("1.5"), false);
+  position.appendChild(SExpression::createToken("-2.25"), false);
+
+  QByteArray expected = FileUtils::readFile(
+      FilePath(UNITTESTS_DIR "/common/fileio/sexpressiontest_golden.lp"));
+  EXPECT_EQ(expected, root.toByteArray());
+
+  QByteArray content;
+  QBuffer    buffer(&content);
+  ASSERT_TRUE(buffer.open(QIODevice::WriteOnly));
+  root.write(buffer);
+  EXPECT_EQ(expected, content);
+}
+
+TEST_F(SExpressionTest, testWriteLargeDocumentToDevice) {
+  SExpression root = SExpression::createList("librepcb_test");
+  for (int i = 0; i < 10000; ++i) {
+    root.appendChild("value", QString("Value #%1").arg(i), true);
+  }
+  QByteArray content;
+  QBuffer    buffer(&content);
+  ASSERT_TRUE(buffer.open(QIODevice::WriteOnly));
+  root.write(buffer);
+  EXPECT_GT(content.size(), 64 * 1024);  // must be flushed multiple times
+  EXPECT_EQ(root.toByteArray(), content);
+}
+
+TEST_F(SExpressionTest, testWriteToDeviceWithPartialWrites) {
+  SExpression root = SExpression::createList("librepcb_test");
+  for (int i = 0; i < 10000; ++i) {
+    root.appendChild("value", QString("Value #%1").arg(i), true);
+  }
+  PartialWriteDevice device;
+  ASSERT_TRUE(device.open(QIODevice::WriteOnly | QIODevice::Unbuffered));
+  EXPECT_THROW(root.write(device), RuntimeError);
+  // nothing must be written after the first partial write
+  EXPECT_EQ(100, device.mContent.size());
+}
+
+TEST_F(SExpressionTest, testSerializeInvalidNodes) {
+  SExpression invalidName = SExpression::createList("Foo");
+  EXPECT_THROW(invalidName.toByteArray(), LogicError);
+  SExpression invalidToken = SExpression::createList("foo");
+  invalidToken.appendChild(SExpression::createToken("foo bar"), false);
+  EXPECT_THROW(invalidToken.toByteArray(), LogicError);
+}
+
+TEST_F(SExpressionTest, benchmarkParseTestDataFiles) {
+  FilePath          testDataDir(TEST_DATA_DIR);
+  QList<QByteArray> contents;
+  QDirIterator      it(testDataDir.toStr(), {"*.lp"}, QDir::Files,
+                  QDirIterator::Subdirectories);
+  while (it.hasNext()) {
+    contents.append(FileUtils::readFile(FilePath(it.next())));
+  }
+
+  qint64        bytes = 0;
+  QElapsedTimer timer;
+  timer.start();
+  for (int i = 0; i < 10; ++i) {
+    foreach (const QByteArray& content, contents) {
+      SExpression root = SExpression::parse(content, FilePath());
+      EXPECT_TRUE(root.isList());
+      bytes += content.size();
+    }
+  }
+  qint64 elapsed = timer.nsecsElapsed();
+  std::cout << "Parsed " << contents.count() << " files (" << bytes
+            << " bytes) in " << (elapsed / 1000000) << " ms ("
+            << ((elapsed > 0) ? (bytes * 1000 / elapsed) : 0) << " MB/s)"
+            << std::endl;
+}
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace tests
+}  // namespace librepcb
@@ -24,6 +24,9 @@
 #include <gtest/gtest.h>
 #include <librepcb/common/fileio/fileutils.h>
 #include <librepcb/common/fileio/transactionalfilesystem.h>
+#include <librepcb/common/toolbox.h>
+
+#include <QtConcurrent/QtConcurrent>
 
 /*******************************************************************************
  *  Namespace
@@ -265,6 +268,40 @@ TEST_F(TransactionalFileSystemTest, testRemoveSubDirRecursively) {
   EXPECT_FALSE(fp.isExistingFile());
 }
 
+TEST_F(TransactionalFileSystemTest, testWriteIntoRemovedDir) {
+  TransactionalFileSystem fs(mPopulatedDir, true);
+  fs.write("1/2/new.txt", "new");
+  fs.write("1/new/x.txt", "x");
+  fs.removeDirRecursively("1/2");
+  EXPECT_FALSE(fs.fileExists("1/2/new.txt"));
+  EXPECT_FALSE(fs.fileExists("1/2/3/4.txt"));
+  EXPECT_EQ(QStringList{"new"}, fs.getDirs("1"));
+  EXPECT_EQ(QStringList{"x.txt"}, fs.getFiles("1/new"));
+
+  // files written after removing a directory must be visible
+  fs.write("1/2/3/new.txt", "new");
+  EXPECT_TRUE(fs.fileExists("1/2/3/new.txt"));
+  EXPECT_FALSE(fs.fileExists("1/2/3/4.txt"));
+  EXPECT_EQ(Toolbox::sorted(QStringList{"2", "new"}),
+            Toolbox::sorted(fs.getDirs("1")));
+  EXPECT_EQ(QStringList{"3"}, fs.getDirs("1/2"));
+  EXPECT_EQ(QStringList{"new.txt"}, fs.getFiles("1/2/3"));
+
+  // also when restored from an autosave backup
+  fs.autosave();
+  TransactionalFileSystem fs2(mPopulatedDir, false,
+                              TransactionalFileSystem::RestoreMode::YES);
+  EXPECT_TRUE(fs2.fileExists("1/2/3/new.txt"));
+  EXPECT_FALSE(fs2.fileExists("1/2/3/4.txt"));
+  EXPECT_EQ(QStringList{"new.txt"}, fs2.getFiles("1/2/3"));
+  EXPECT_TRUE(fs2.fileExists("1/new/x.txt"));
+
+  // removing the file again must not show the directory anymore
+  fs.removeFile("1/2/3/new.txt");
+  EXPECT_EQ(QStringList{"new"}, fs.getDirs("1"));
+  EXPECT_TRUE(fs.getDirs("1/2").isEmpty());
+}
+
 TEST_F(TransactionalFileSystemTest, testSaveThrowsExceptionIfNonWritable) {
   TransactionalFileSystem fs(mPopulatedDir, false);
   EXPECT_THROW(fs.save(), Exception);
@@ -434,6 +471,49 @@ TEST_F(TransactionalFileSystemTest, testAutosaveIsRemovedInDestructor) {
   EXPECT_FALSE(fp.isExistingDir());
 }
 
+TEST_F(TransactionalFileSystemTest, testIncrementalAutosave) {
+  FilePath                autosaveDir = mPopulatedDir.getPathTo(".autosave");
+  QDir                    dir(autosaveDir.toStr());
+  TransactionalFileSystem fs(mPopulatedDir, true);
+  fs.write("a.txt", "a");
+  fs.write("b.txt", "b");
+  fs.autosave();
+  QStringList dirs1 = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+  ASSERT_EQ(1, dirs1.count());
+
+  // only the modified file must be written into a new directory
+  QThread::msleep(5);  // make sure the new directory gets a different name
+  fs.write("b.txt", "b2");
+  fs.autosave();
+  QStringList dirs2 = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+  ASSERT_EQ(2, dirs2.count());
+  dirs2.removeOne(dirs1.first());
+  FilePath newDir = autosaveDir.getPathTo(dirs2.first());
+  EXPECT_FALSE(newDir.getPathTo("a.txt").isExistingFile());
+  EXPECT_TRUE(newDir.getPathTo("b.txt").isExistingFile());
+  {
+    TransactionalFileSystem restored(mPopulatedDir, false,
+                                     TransactionalFileSystem::RestoreMode::YES);
+    EXPECT_EQ("a", restored.read("a.txt"));
+    EXPECT_EQ("b2", restored.read("b.txt"));
+  }
+
+  // directories which are not referenced anymore must be removed
+  QThread::msleep(5);
+  fs.write("a.txt", "a2");
+  fs.autosave();
+  QStringList dirs3 = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+  EXPECT_EQ(2, dirs3.count());
+  EXPECT_FALSE(dirs3.contains(dirs1.first()));
+  EXPECT_TRUE(dirs3.contains(dirs2.first()));
+  {
+    TransactionalFileSystem restored(mPopulatedDir, false,
+                                     TransactionalFileSystem::RestoreMode::YES);
+    EXPECT_EQ("a2", restored.read("a.txt"));
+    EXPECT_EQ("b2", restored.read("b.txt"));
+  }
+}
+
 TEST_F(TransactionalFileSystemTest, testRestoreAutosave) {
   TransactionalFileSystem fs(mPopulatedDir, true);
 
@@ -598,6 +678,166 @@ TEST_F(TransactionalFileSystemTest, testExportToZip) {
   EXPECT_TRUE(zipFp.isExistingFile());
 }
 
+TEST_F(TransactionalFileSystemTest, testLoadFromZip) {
+  FilePath zipFp = mTmpDir.getPathTo("export.zip");
+  {
+    TransactionalFileSystem fs(mPopulatedDir, true);
+    fs.write("1.txt", "new 1");
+    fs.removeFile("2.txt");
+    fs.exportToZip(zipFp);
+  }
+  TransactionalFileSystem fs(mEmptyDir, false);
+  fs.loadFromZip(zipFp);
+  EXPECT_EQ("new 1", fs.read("1.txt"));
+  EXPECT_EQ("4", fs.read("1/2/3/4.txt"));
+  EXPECT_EQ("X", fs.read("foo dir/bar dir/X"));
+  EXPECT_FALSE(fs.fileExists("2.txt"));
+  EXPECT_FALSE(fs.fileExists(".dot/file.txt"));  // dotdirs are not exported
+  EXPECT_EQ(QStringList({"1", "a", "foo dir"}),
+            Toolbox::sorted(fs.getDirs("")));
+  EXPECT_EQ(QStringList({"1a.txt", "1b.txt"}),
+            Toolbox::sorted(fs.getFiles("1")));
+
+  // modifications must override the content of the ZIP file
+  fs.write("1.txt", "modified");
+  fs.removeFile("a/b/c");
+  EXPECT_EQ("modified", fs.read("1.txt"));
+  EXPECT_FALSE(fs.fileExists("a/b/c"));
+}
+
+TEST_F(TransactionalFileSystemTest, testLoadFromMultipleZips) {
+  FilePath zipFp1 = mTmpDir.getPathTo("first.zip");
+  FilePath zipFp2 = mTmpDir.getPathTo("second.zip");
+  {
+    TransactionalFileSystem fs(mPopulatedDir, true);
+    fs.exportToZip(zipFp1);
+    fs.write("1.txt", "second 1");
+    fs.write("only second.txt", "second");
+    fs.exportToZip(zipFp2);
+  }
+  TransactionalFileSystem fs(mEmptyDir, false);
+  fs.loadFromZip(zipFp1);
+  fs.loadFromZip(zipFp2);  // files of both archives must be overridden
+  EXPECT_EQ("second 1", fs.read("1.txt"));
+  EXPECT_EQ("second", fs.read("only second.txt"));
+  EXPECT_EQ("2", fs.read("2.txt"));
+
+  // same when the first archive was read into memory by exporting to it
+  TransactionalFileSystem fs2(mNonExistingDir, false);
+  fs2.loadFromZip(zipFp1);
+  fs2.exportToZip(zipFp1);
+  fs2.loadFromZip(zipFp2);
+  EXPECT_EQ("second 1", fs2.read("1.txt"));
+  EXPECT_EQ("second", fs2.read("only second.txt"));
+}
+
+TEST_F(TransactionalFileSystemTest, testReadFromZipInParallel) {
+  FilePath    zipFp = mTmpDir.getPathTo("export.zip");
+  QStringList files;
+  {
+    TransactionalFileSystem fs(mEmptyDir, true);
+    fs.write("empty.txt", QByteArray());
+    files.append("empty.txt");
+    for (int i = 0; i < 20; ++i) {
+      QString path = QString("dir %1/file.txt").arg(i);
+      fs.write(path, QByteArray::number(i).repeated(100000));
+      files.append(path);
+    }
+    fs.exportToZip(zipFp);
+  }
+  TransactionalFileSystem fs(mNonExistingDir, false);
+  fs.loadFromZip(zipFp);
+  auto read = [&fs](const QString& path) { return fs.read(path); };
+  for (int pass = 0; pass < 2; ++pass) {  // second pass reads cached files
+    QList<QByteArray> contents =
+        QtConcurrent::blockingMapped<QList<QByteArray>>(files, read);
+    ASSERT_EQ(files.count(), contents.count());
+    EXPECT_EQ(QByteArray(), contents.first());
+    for (int i = 1; i < files.count(); ++i) {
+      EXPECT_EQ(QByteArray::number(i - 1).repeated(100000), contents.at(i));
+    }
+  }
+}
+
+TEST_F(TransactionalFileSystemTest, testExportToLoadedZip) {
+  FilePath zipFp = mTmpDir.getPathTo("export.zip");
+  {
+    TransactionalFileSystem fs(mPopulatedDir, true);
+    fs.exportToZip(zipFp);
+  }
+  TransactionalFileSystem fs(mEmptyDir, false);
+  fs.loadFromZip(zipFp);
+  fs.write("new.txt", "new");
+  fs.exportToZip(zipFp);  // overwrite the loaded ZIP file
+  EXPECT_EQ("1", fs.read("1.txt"));
+  EXPECT_EQ("c", fs.read("a/b/c"));
+
+  TransactionalFileSystem fs2(mNonExistingDir, false);
+  fs2.loadFromZip(zipFp);
+  EXPECT_EQ("new", fs2.read("new.txt"));
+  EXPECT_EQ("bar", fs2.read("foo dir/bar dir.txt"));
+}
+
+TEST_F(TransactionalFileSystemTest, testReadSExpression) {
+  TransactionalFileSystem fs(mPopulatedDir, true);
+  fs.write("doc.lp", "(test (value 1))");
+  SExpression root = fs.readSExpression("doc.lp");
+  EXPECT_EQ(1, root.getValueByPath<int>("value"));
+  EXPECT_EQ(mPopulatedDir.getPathTo("doc.lp"), root.getFilePath());
+  EXPECT_THROW(fs.readSExpression("1.txt"), Exception);  // not an S-Expression
+  EXPECT_THROW(fs.readSExpression("nonexisting.lp"), Exception);
+}
+
+TEST_F(TransactionalFileSystemTest, testPreloadSExpressions) {
+  TransactionalFileSystem fs(mPopulatedDir, true);
+  fs.write("a.lp", "(test (value 1))");
+  fs.write("dir/b.lp", "(test (value 2))");
+  fs.write("dir/c.lp", "(test (value 3))");
+  fs.preloadSExpressions({"a.lp", "dir/b.lp", "dir/c.lp", "1.txt", "x.lp"});
+
+  // modifications after preloading must not be hidden by the preloaded files
+  fs.write("a.lp", "(test (value 10))");
+  fs.removeDirRecursively("dir");
+  EXPECT_EQ(10, fs.readSExpression("a.lp").getValueByPath<int>("value"));
+  EXPECT_THROW(fs.readSExpression("dir/b.lp"), Exception);
+
+  // errors are raised when reading the file, not when preloading it
+  EXPECT_THROW(fs.readSExpression("1.txt"), Exception);
+  EXPECT_THROW(fs.readSExpression("x.lp"), Exception);
+}
+
+TEST_F(TransactionalFileSystemTest, testPreloadedSExpressionsAreUsed) {
+  TransactionalFileSystem fs(mPopulatedDir, true);
+  FileUtils::writeFile(mPopulatedDir.getPathTo("doc.lp"), "(test (value 1))");
+  fs.preloadSExpressions({"doc.lp"});
+  // modify the file behind the back of the file system to see whether the
+  // preloaded document is returned (only once)
+  FileUtils::writeFile(mPopulatedDir.getPathTo("doc.lp"), "(test (value 2))");
+  EXPECT_EQ(1, fs.readSExpression("doc.lp").getValueByPath<int>("value"));
+  EXPECT_EQ(2, fs.readSExpression("doc.lp").getValueByPath<int>("value"));
+}
+
+TEST_F(TransactionalFileSystemTest, testDiscardPreloadedSExpressions) {
+  TransactionalFileSystem fs(mPopulatedDir, true);
+  FileUtils::writeFile(mPopulatedDir.getPathTo("a.lp"), "(test (value 1))");
+  FileUtils::writeFile(mPopulatedDir.getPathTo("dir/b.lp"), "(test (value 1))");
+  fs.preloadSExpressions({"a.lp", "dir/b.lp"});
+  FileUtils::writeFile(mPopulatedDir.getPathTo("a.lp"), "(test (value 2))");
+  FileUtils::writeFile(mPopulatedDir.getPathTo("dir/b.lp"), "(test (value 2))");
+
+  // discarded documents are read again from the file system
+  fs.discardPreloadedSExpressions("dir/");
+  EXPECT_EQ(2, fs.readSExpression("dir/b.lp").getValueByPath<int>("value"));
+  EXPECT_EQ(1, fs.readSExpression("a.lp").getValueByPath<int>("value"));
+
+  fs.preloadSExpressions({"a.lp", "dir/b.lp"});
+  FileUtils::writeFile(mPopulatedDir.getPathTo("a.lp"), "(test (value 3))");
+  FileUtils::writeFile(mPopulatedDir.getPathTo("dir/b.lp"), "(test (value 3))");
+  fs.discardPreloadedSExpressions();
+  EXPECT_EQ(3, fs.readSExpression("a.lp").getValueByPath<int>("value"));
+  EXPECT_EQ(3, fs.readSExpression("dir/b.lp").getValueByPath<int>("value"));
+}
+
 /*******************************************************************************
  *  Parametrized getSubDirs() Tests
  ******************************************************************************/
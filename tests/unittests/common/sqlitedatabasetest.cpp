@@ -28,6 +28,8 @@
 #include <QtConcurrent>
 #include <QtCore>
 
+#include <iostream>
+
 /*******************************************************************************
  *  Namespace
  ******************************************************************************/
@@ -140,6 +142,23 @@ TEST_F(SQLiteDatabaseTest, testIfContructorCreatesFile) {
   EXPECT_TRUE(mTempDbFilePath.isExistingFile());
 }
 
+TEST_F(SQLiteDatabaseTest, testReadOnlyConnection) {
+  SQLiteDatabase db(mTempDbFilePath);
+  db.exec("CREATE TABLE test (`id` INTEGER PRIMARY KEY NOT NULL, `name` TEXT)");
+  db.exec("INSERT INTO test (name) VALUES ('hello')");
+
+  SQLiteDatabase readOnlyDb(mTempDbFilePath, true);
+  QSqlQuery      query = readOnlyDb.prepareQuery("SELECT COUNT(*) FROM test");
+  EXPECT_EQ(1, readOnlyDb.count(query));
+  EXPECT_THROW(readOnlyDb.exec("INSERT INTO test (name) VALUES ('foo')"),
+               Exception);
+
+  // the read-only connection sees changes of the other connection
+  db.exec("INSERT INTO test (name) VALUES ('world')");
+  query = readOnlyDb.prepareQuery("SELECT COUNT(*) FROM test");
+  EXPECT_EQ(2, readOnlyDb.count(query));
+}
+
 TEST_F(SQLiteDatabaseTest, testExecQuery) {
   SQLiteDatabase db(mTempDbFilePath);
   db.exec("CREATE TABLE test (`id` INTEGER PRIMARY KEY NOT NULL)");
@@ -164,6 +183,121 @@ TEST_F(SQLiteDatabaseTest, testInsert) {
   }
 }
 
+TEST_F(SQLiteDatabaseTest, testPrepareCachedQuery) {
+  SQLiteDatabase db(mTempDbFilePath);
+  db.exec("CREATE TABLE test (`id` INTEGER PRIMARY KEY NOT NULL, `name` TEXT)");
+  for (int i = 0; i < 10; ++i) {
+    QSqlQuery query =
+        db.prepareCachedQuery("INSERT INTO test (name) VALUES (:name)");
+    query.bindValue(":name", QString("row %1").arg(i));
+    EXPECT_EQ(i + 1, db.insert(query));
+  }
+  QSqlQuery query = db.prepareCachedQuery("SELECT COUNT(*) FROM test");
+  EXPECT_EQ(10, db.count(query));
+  query = db.prepareCachedQuery("SELECT COUNT(*) FROM test");  // not consumed
+  EXPECT_EQ(10, db.count(query));
+  EXPECT_THROW(db.prepareCachedQuery("SELECT foo FROM bar"), Exception);
+}
+
+TEST_F(SQLiteDatabaseTest, testInsertBatch) {
+  SQLiteDatabase db(mTempDbFilePath);
+  db.exec("CREATE TABLE test (`id` INTEGER PRIMARY KEY NOT NULL, `name` TEXT)");
+  db.insertBatch("test", {"id", "name"}, {});
+  db.insertBatch("test", {"id", "name"},
+                 {{1, "foo"}, {2, QVariant(QVariant::String)}, {5, "bar"}});
+  QSqlQuery query = db.prepareQuery("SELECT id, name FROM test ORDER BY id");
+  db.exec(query);
+  ASSERT_TRUE(query.next());
+  EXPECT_EQ(1, query.value(0).toInt());
+  EXPECT_EQ("foo", query.value(1).toString());
+  ASSERT_TRUE(query.next());
+  EXPECT_EQ(2, query.value(0).toInt());
+  EXPECT_TRUE(query.value(1).isNull());
+  ASSERT_TRUE(query.next());
+  EXPECT_EQ(5, query.value(0).toInt());
+  EXPECT_EQ("bar", query.value(1).toString());
+  EXPECT_FALSE(query.next());
+  EXPECT_THROW(db.insertBatch("test", {"id", "name"}, {{6}}), Exception);
+  EXPECT_THROW(db.insertBatch("test", {"id", "name"}, {{1, "duplicate"}}),
+               Exception);
+}
+
+TEST_F(SQLiteDatabaseTest, testPragmas) {
+  SQLiteDatabase db(mTempDbFilePath);
+  db.setPragma("cache_size", "-4096");
+  EXPECT_EQ("-4096", db.getPragma("cache_size"));
+  db.setPragma("temp_store", "MEMORY");
+  EXPECT_EQ("2", db.getPragma("temp_store"));
+  EXPECT_THROW(db.setPragma("cache_size", "1; DROP TABLE test"), Exception);
+  EXPECT_THROW(db.getPragma("foo bar"), Exception);
+}
+
+TEST_F(SQLiteDatabaseTest, benchmarkInsertRows) {
+  // Simulates indexing library elements, each with a translation and two
+  // categories, with the different APIs.
+  const int elements = 5000;
+  for (int variant = 0; variant < 3; ++variant) {
+    QFile::remove(mTempDbFilePath.toStr());
+    SQLiteDatabase db(mTempDbFilePath);
+    db.setPragma("synchronous", "NORMAL");
+    db.exec(
+        "CREATE TABLE elements (`id` INTEGER PRIMARY KEY NOT NULL, "
+        "`name` TEXT)");
+    db.exec(
+        "CREATE TABLE elements_tr (`id` INTEGER PRIMARY KEY NOT NULL, "
+        "`element_id` INTEGER, `locale` TEXT, `name` TEXT)");
+    db.exec(
+        "CREATE TABLE elements_cat (`id` INTEGER PRIMARY KEY NOT NULL, "
+        "`element_id` INTEGER, `category` TEXT)");
+
+    QElapsedTimer timer;
+    timer.start();
+    SQLiteDatabase::TransactionScopeGuard tsg(db);
+    for (int i = 0; i < elements; ++i) {
+      QString   sql   = "INSERT INTO elements (name) VALUES (:name)";
+      QSqlQuery query = (variant == 0) ? db.prepareQuery(sql)
+                                       : db.prepareCachedQuery(sql);
+      query.bindValue(":name", QString("Element %1").arg(i));
+      int id = db.insert(query);
+      if (variant < 2) {
+        sql = "INSERT INTO elements_tr (element_id, locale, name) "
+              "VALUES (:id, :locale, :name)";
+        query = (variant == 0) ? db.prepareQuery(sql)
+                               : db.prepareCachedQuery(sql);
+        query.bindValue(":id", id);
+        query.bindValue(":locale", "en_US");
+        query.bindValue(":name", QString("Element %1").arg(i));
+        db.insert(query);
+        for (int k = 0; k < 2; ++k) {
+          sql = "INSERT INTO elements_cat (element_id, category) "
+                "VALUES (:id, :category)";
+          query = (variant == 0) ? db.prepareQuery(sql)
+                                 : db.prepareCachedQuery(sql);
+          query.bindValue(":id", id);
+          query.bindValue(":category", QString("Category %1").arg(k));
+          db.insert(query);
+        }
+      } else {
+        db.insertBatch("elements_tr", {"element_id", "locale", "name"},
+                       {{id, "en_US", QString("Element %1").arg(i)}});
+        db.insertBatch("elements_cat", {"element_id", "category"},
+                       {{id, "Category 0"}, {id, "Category 1"}});
+      }
+    }
+    tsg.commit();
+    qint64 elapsed = timer.nsecsElapsed();
+
+    QSqlQuery query = db.prepareQuery("SELECT COUNT(*) FROM elements_cat");
+    EXPECT_EQ(2 * elements, db.count(query));
+    const char* names[] = {"uncached", "cached", "cached + batch"};
+    qint64      rows    = 4 * elements;
+    std::cout << "Inserted " << rows << " rows (" << names[variant]
+              << ") in " << (elapsed / 1000000) << " ms ("
+              << ((elapsed > 0) ? (rows * 1000000000LL / elapsed) : 0)
+              << " rows/s)" << std::endl;
+  }
+}
+
 TEST_F(SQLiteDatabaseTest, testClearExistingTable) {
   SQLiteDatabase db(mTempDbFilePath);
   db.exec("CREATE TABLE test (`id` INTEGER PRIMARY KEY NOT NULL, `name` TEXT)");
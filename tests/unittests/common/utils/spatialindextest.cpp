@@ -0,0 +1,92 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <librepcb/common/utils/spatialindex.h>
+
+#include <QtCore>
+
+/*******************************************************************************
+ *  Namespace
+ ******************************************************************************/
+namespace librepcb {
+namespace tests {
+
+/*******************************************************************************
+ *  Test Class
+ ******************************************************************************/
+
+class SpatialIndexTest : public ::testing::Test {
+protected:
+  static Point mm(qreal x, qreal y) {
+    return Point(Length::fromMm(x), Length::fromMm(y));
+  }
+};
+
+/*******************************************************************************
+ *  Test Methods
+ ******************************************************************************/
+
+TEST_F(SpatialIndexTest, testQuery) {
+  SpatialIndex<int> index(PositiveLength(1000000));
+  index.insert(1, mm(0, 0), mm(1, 1));
+  index.insert(2, mm(-5, -5), mm(-4, -4));
+  index.insert(3, mm(10, 10), mm(0.5, 0.5));  // corners in reverse order
+  index.insert(4, mm(-1000, -1000), mm(1000, 1000));  // huge item
+  EXPECT_EQ(4, index.count());
+
+  EXPECT_EQ(QList<int>({1, 3, 4}), index.query(mm(0.75, 0.75)));
+  EXPECT_EQ(QList<int>({2, 4}), index.query(mm(-4.5, -4.5)));
+  EXPECT_EQ(QList<int>({4}), index.query(mm(-2, -2), mm(-3, -3)));
+  EXPECT_EQ(QList<int>({1, 2, 3, 4}),
+            index.query(mm(-1e4, -1e4), mm(1e4, 1e4)));
+  EXPECT_EQ(QList<int>(), index.query(mm(2000, 2000)));
+}
+
+TEST_F(SpatialIndexTest, testMoveKeepsOrder) {
+  SpatialIndex<int> index(PositiveLength(1000000));
+  index.insert(1, mm(0, 0), mm(1, 1));
+  index.insert(2, mm(5, 5), mm(6, 6));
+  index.insert(1, mm(5, 5), mm(6, 6));  // move item 1
+  EXPECT_EQ(2, index.count());
+  EXPECT_EQ(QList<int>(), index.query(mm(0.5, 0.5)));
+  EXPECT_EQ(QList<int>({1, 2}), index.query(mm(5.5, 5.5)));
+}
+
+TEST_F(SpatialIndexTest, testRemove) {
+  SpatialIndex<int> index(PositiveLength(1000000));
+  index.insert(1, mm(0, 0), mm(1, 1));
+  index.insert(2, mm(-1000, -1000), mm(1000, 1000));
+  index.remove(1);
+  index.remove(2);
+  index.remove(3);  // not contained
+  EXPECT_TRUE(index.isEmpty());
+  EXPECT_FALSE(index.contains(1));
+  EXPECT_EQ(QList<int>(), index.query(mm(0.5, 0.5)));
+}
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace tests
+}  // namespace librepcb
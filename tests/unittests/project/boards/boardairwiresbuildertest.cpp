@@ -0,0 +1,166 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <librepcb/common/fileio/transactionalfilesystem.h>
+#include <librepcb/project/boards/board.h>
+#include <librepcb/project/boards/boardairwiresbuilder.h>
+#include <librepcb/project/boards/items/bi_device.h>
+#include <librepcb/project/circuit/circuit.h>
+#include <librepcb/project/circuit/netsignal.h>
+#include <librepcb/project/project.h>
+
+#include <QtCore>
+
+#include <random>
+
+/*******************************************************************************
+ *  Namespace
+ ******************************************************************************/
+namespace librepcb {
+namespace project {
+namespace tests {
+
+/*******************************************************************************
+ *  Test Class
+ ******************************************************************************/
+
+class BoardAirWiresBuilderTest : public ::testing::Test {
+protected:
+  static qreal getTotalLength(
+      const QVector<QPair<Point, Point>>& airwires) noexcept {
+    qreal length = 0;
+    foreach (const auto& airwire, airwires) {
+      length += (airwire.second - airwire.first).getLength().toMm();
+    }
+    return length;
+  }
+};
+
+/*******************************************************************************
+ *  Test Methods
+ ******************************************************************************/
+
+TEST_F(BoardAirWiresBuilderTest, testIncrementalUpdateMatchesFullRebuild) {
+  FilePath testDataDir(
+      TEST_DATA_DIR
+      "/unittests/librepcbproject/BoardPlaneFragmentsBuilderTest");
+
+  // open project from test data directory
+  FilePath projectFp = testDataDir.getPathTo("test_project/test_project.lpp");
+  std::shared_ptr<TransactionalFileSystem> projectFs =
+      TransactionalFileSystem::openRO(projectFp.getParentDir());
+  QScopedPointer<Project> project(
+      new Project(std::unique_ptr<TransactionalDirectory>(
+                      new TransactionalDirectory(projectFs)),
+                  projectFp.getFilename()));
+  Board* board = project->getBoards().first();
+  ASSERT_FALSE(board->getDeviceInstances().isEmpty());
+
+  // create incremental builders for all net signals
+  QList<NetSignal*> netsignals =
+      project->getCircuit().getNetSignals().values();
+  QList<std::shared_ptr<BoardAirWiresBuilder>> builders;
+  foreach (NetSignal* netsignal, netsignals) {
+    builders.append(std::make_shared<BoardAirWiresBuilder>(*board, *netsignal));
+    builders.last()->buildAirWires();
+  }
+
+  // move devices step by step (like dragging them) and compare the result of
+  // the incremental builders with a calculation from scratch
+  Point offset(Length(2540000), Length(-1270000));
+  foreach (BI_Device* device, board->getDeviceInstances()) {
+    for (int step = 0; step < 3; ++step) {
+      device->setPosition(device->getPosition() + offset);
+      for (int i = 0; i < netsignals.count(); ++i) {
+        BoardAirWiresBuilder full(*board, *netsignals.at(i));
+        QVector<QPair<Point, Point>> expected = full.buildAirWires();
+        QVector<QPair<Point, Point>> actual   = builders.at(i)->buildAirWires();
+        EXPECT_EQ(expected.count(), actual.count());
+        EXPECT_NEAR(getTotalLength(expected), getTotalLength(actual), 1e-6);
+      }
+    }
+  }
+}
+
+TEST_F(BoardAirWiresBuilderTest, testIncrementalUpdateOnRandomMoves) {
+  FilePath testDataDir(
+      TEST_DATA_DIR
+      "/unittests/librepcbproject/BoardPlaneFragmentsBuilderTest");
+
+  // open project from test data directory
+  FilePath projectFp = testDataDir.getPathTo("test_project/test_project.lpp");
+  std::shared_ptr<TransactionalFileSystem> projectFs =
+      TransactionalFileSystem::openRO(projectFp.getParentDir());
+  QScopedPointer<Project> project(
+      new Project(std::unique_ptr<TransactionalDirectory>(
+                      new TransactionalDirectory(projectFs)),
+                  projectFp.getFilename()));
+  Board* board = project->getBoards().first();
+  QList<BI_Device*> devices = board->getDeviceInstances().values();
+  ASSERT_FALSE(devices.isEmpty());
+
+  // create incremental builders for all net signals
+  QList<NetSignal*> netsignals =
+      project->getCircuit().getNetSignals().values();
+  QList<std::shared_ptr<BoardAirWiresBuilder>> builders;
+  foreach (NetSignal* netsignal, netsignals) {
+    builders.append(std::make_shared<BoardAirWiresBuilder>(*board, *netsignal));
+    builders.last()->buildAirWires();
+  }
+
+  // Move random devices by random offsets, sometimes several devices at once
+  // and sometimes back and forth. The incremental result must be a minimum
+  // spanning tree as well, i.e. it has the same number of airwires and the
+  // same total length as a calculation from scratch. Only edges of equal
+  // length may be chosen differently.
+  std::mt19937                       random(42);  // reproducible sequence
+  std::uniform_int_distribution<int> deviceDist(0, devices.count() - 1);
+  std::uniform_int_distribution<int> countDist(1, 3);
+  // off-grid offsets to avoid degenerate triangulations of coincident pads
+  std::uniform_int_distribution<int> offsetDist(-2000, 2000);  // ~20mm
+  for (int step = 0; step < 100; ++step) {
+    int count = countDist(random);
+    for (int i = 0; i < count; ++i) {
+      BI_Device* device = devices.at(deviceDist(random));
+      Point      offset(Length(10007 * offsetDist(random)),
+                        Length(10007 * offsetDist(random)));
+      device->setPosition(device->getPosition() + offset);
+    }
+    for (int i = 0; i < netsignals.count(); ++i) {
+      BoardAirWiresBuilder full(*board, *netsignals.at(i));
+      QVector<QPair<Point, Point>> expected = full.buildAirWires();
+      QVector<QPair<Point, Point>> actual   = builders.at(i)->buildAirWires();
+      EXPECT_EQ(expected.count(), actual.count()) << "Step " << step;
+      EXPECT_NEAR(getTotalLength(expected), getTotalLength(actual), 1e-6)
+          << "Step " << step;
+    }
+  }
+}
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace tests
+}  // namespace project
+}  // namespace librepcb
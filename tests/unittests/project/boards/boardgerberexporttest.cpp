@@ -0,0 +1,134 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <librepcb/common/fileio/fileutils.h>
+#include <librepcb/common/fileio/transactionalfilesystem.h>
+#include <librepcb/project/boards/board.h>
+#include <librepcb/project/boards/boardfabricationoutputsettings.h>
+#include <librepcb/project/boards/boardgerberexport.h>
+#include <librepcb/project/project.h>
+
+#include <QtCore>
+
+/*******************************************************************************
+ *  Namespace
+ ******************************************************************************/
+namespace librepcb {
+namespace project {
+namespace tests {
+
+/*******************************************************************************
+ *  Test Class
+ ******************************************************************************/
+
+class BoardGerberExportTest : public ::testing::Test {
+protected:
+  FilePath mOutputDir;
+
+  BoardGerberExportTest() {
+    mOutputDir = FilePath::getRandomTempPath();
+  }
+
+  virtual ~BoardGerberExportTest() {
+    QDir(mOutputDir.toStr()).removeRecursively();
+    QThreadPool::globalInstance()->setMaxThreadCount(
+        QThread::idealThreadCount());
+  }
+
+  QVector<FilePath> exportBoard(const Board& board, const QString& subdir,
+                                int threads) const {
+    BoardFabricationOutputSettings settings =
+        board.getFabricationOutputSettings();
+    settings.setOutputBasePath(mOutputDir.getPathTo(subdir).toStr() % "/");
+    settings.setMergeDrillFiles(false);
+    settings.setOptimizeDrillOrder(true);
+    settings.setEnableSolderPasteTop(true);
+    settings.setEnableSolderPasteBot(true);
+    QThreadPool::globalInstance()->setMaxThreadCount(threads);
+    BoardGerberExport grbExport(board, settings);
+    grbExport.exportAllLayers();  // can throw
+    return grbExport.getWrittenFiles();
+  }
+
+  /**
+   * @brief Read a generated file without the lines containing the time of
+   *        the export (and the checksum over them)
+   */
+  static QByteArray readWithoutTimestamps(const FilePath& fp) {
+    QList<QByteArray> lines = FileUtils::readFile(fp).split('\n');
+    for (int i = lines.count() - 1; i >= 0; --i) {
+      const QByteArray& line = lines.at(i);
+      if (line.startsWith("%TF.CreationDate,") ||
+          line.startsWith(";Creation Date:") || line.startsWith("%TF.MD5,")) {
+        lines.removeAt(i);
+      }
+    }
+    return lines.join('\n');
+  }
+};
+
+/*******************************************************************************
+ *  Test Methods
+ ******************************************************************************/
+
+TEST_F(BoardGerberExportTest, testParallelExportEqualsSerialExport) {
+  FilePath testDataDir(
+      TEST_DATA_DIR
+      "/unittests/librepcbproject/BoardPlaneFragmentsBuilderTest");
+
+  // open project from test data directory
+  FilePath projectFp = testDataDir.getPathTo("test_project/test_project.lpp");
+  std::shared_ptr<TransactionalFileSystem> projectFs =
+      TransactionalFileSystem::openRO(projectFp.getParentDir());
+  QScopedPointer<Project> project(
+      new Project(std::unique_ptr<TransactionalDirectory>(
+                      new TransactionalDirectory(projectFs)),
+                  projectFp.getFilename()));
+  Board* board = project->getBoards().first();
+  board->rebuildAllPlanes();
+
+  // with a single pool thread, all jobs are executed one after the other
+  QVector<FilePath> serialFiles   = exportBoard(*board, "serial", 1);
+  QVector<FilePath> parallelFiles = exportBoard(
+      *board, "parallel", qMax(4, QThread::idealThreadCount()));
+
+  ASSERT_EQ(serialFiles.count(), parallelFiles.count());
+  ASSERT_GT(serialFiles.count(), 0);
+  for (int i = 0; i < serialFiles.count(); ++i) {
+    const FilePath& serial   = serialFiles.at(i);
+    const FilePath& parallel = parallelFiles.at(i);
+    EXPECT_EQ(serial.toRelative(mOutputDir.getPathTo("serial")).toStdString(),
+              parallel.toRelative(mOutputDir.getPathTo("parallel"))
+                  .toStdString());
+    EXPECT_EQ(readWithoutTimestamps(serial), readWithoutTimestamps(parallel))
+        << qPrintable(serial.getFilename());
+  }
+}
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace tests
+}  // namespace project
+}  // namespace librepcb
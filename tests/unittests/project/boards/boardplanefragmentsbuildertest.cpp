@@ -24,6 +24,7 @@
 #include <librepcb/common/fileio/fileutils.h>
 #include <librepcb/common/fileio/transactionalfilesystem.h>
 #include <librepcb/project/boards/board.h>
+#include <librepcb/project/boards/boardplanefragmentsbuilder.h>
 #include <librepcb/project/boards/items/bi_plane.h>
 #include <librepcb/project/project.h>
 
@@ -109,6 +110,43 @@ TEST(BoardPlaneFragmentsBuilderTest, testFragments) {
   EXPECT_EQ(expectedPlaneFragments, actualPlaneFragments);
 }
 
+TEST(BoardPlaneFragmentsBuilderTest, testRebuildWithUnmodifiedInputs) {
+  FilePath testDataDir(
+      TEST_DATA_DIR
+      "/unittests/librepcbproject/BoardPlaneFragmentsBuilderTest");
+
+  // open project from test data directory
+  FilePath projectFp = testDataDir.getPathTo("test_project/test_project.lpp");
+  std::shared_ptr<TransactionalFileSystem> projectFs =
+      TransactionalFileSystem::openRO(projectFp.getParentDir());
+  QScopedPointer<Project> project(
+      new Project(std::unique_ptr<TransactionalDirectory>(
+                      new TransactionalDirectory(projectFs)),
+                  projectFp.getFilename()));
+  Board* board = project->getBoards().first();
+  ASSERT_FALSE(board->getPlanes().isEmpty());
+
+  // after building all planes, the builder must detect that the inputs are
+  // unmodified
+  board->rebuildAllPlanes();
+  foreach (BI_Plane* plane, board->getPlanes()) {
+    EXPECT_FALSE(plane->getFragmentsInputHash().isEmpty());
+    BoardPlaneFragmentsBuilder builder(*plane);
+    EXPECT_FALSE(builder.buildFragments());
+    EXPECT_EQ(plane->getFragmentsInputHash(), builder.getInputHash());
+  }
+
+  // clearing a plane must lead to a rebuild with exactly the same fragments
+  BI_Plane*     plane     = board->getPlanes().first();
+  QVector<Path> fragments = plane->getFragments();
+  QByteArray    hash      = plane->getFragmentsInputHash();
+  plane->clear();
+  EXPECT_TRUE(plane->getFragmentsInputHash().isEmpty());
+  board->rebuildAllPlanes();
+  EXPECT_EQ(fragments, plane->getFragments());
+  EXPECT_EQ(hash, plane->getFragmentsInputHash());
+}
+
 /*******************************************************************************
  *  End of File
  ******************************************************************************/
@@ -0,0 +1,312 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <librepcb/common/fileio/transactionalfilesystem.h>
+#include <librepcb/project/boards/board.h>
+#include <librepcb/project/boards/boardairwiresbuilder.h>
+#include <librepcb/project/boards/items/bi_airwire.h>
+#include <librepcb/project/boards/items/bi_device.h>
+#include <librepcb/project/boards/items/bi_footprint.h>
+#include <librepcb/project/boards/items/bi_footprintpad.h>
+#include <librepcb/project/boards/items/bi_plane.h>
+#include <librepcb/project/circuit/circuit.h>
+#include <librepcb/project/circuit/netsignal.h>
+#include <librepcb/project/project.h>
+
+#include <QtCore>
+
+#include <functional>
+
+/*******************************************************************************
+ *  Namespace
+ ******************************************************************************/
+namespace librepcb {
+namespace project {
+namespace tests {
+
+/*******************************************************************************
+ *  Test Class
+ ******************************************************************************/
+
+class BoardTest : public ::testing::Test {
+protected:
+  typedef QSet<QPair<Point, Point>> AirWires;
+
+  static QPair<Point, Point> normalized(const Point& p1,
+                                        const Point& p2) noexcept {
+    if ((p1.getX() < p2.getX()) ||
+        ((p1.getX() == p2.getX()) && (p1.getY() < p2.getY()))) {
+      return qMakePair(p1, p2);
+    } else {
+      return qMakePair(p2, p1);
+    }
+  }
+
+  static AirWires getAirWires(const Board& board) noexcept {
+    AirWires airwires;
+    foreach (const BI_Base* item, board.getAllItems()) {
+      if (const BI_AirWire* airwire = dynamic_cast<const BI_AirWire*>(item)) {
+        airwires.insert(normalized(airwire->getP1(), airwire->getP2()));
+      }
+    }
+    return airwires;
+  }
+
+  static AirWires calcAirWires(const Board& board) noexcept {
+    AirWires airwires;
+    foreach (const NetSignal* netsignal,
+             board.getProject().getCircuit().getNetSignals()) {
+      BoardAirWiresBuilder builder(board, *netsignal);
+      foreach (const auto& airwire, builder.buildAirWires()) {
+        airwires.insert(normalized(airwire.first, airwire.second));
+      }
+    }
+    return airwires;
+  }
+
+  static bool containsAnyPoint(const AirWires&    airwires,
+                               const QSet<Point>& points) noexcept {
+    foreach (const auto& airwire, airwires) {
+      if (points.contains(airwire.first) || points.contains(airwire.second)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Process events until all airwire jobs are finished and applied
+   *
+   * @param callback  Called after every processed event, e.g. to check
+   *                  intermediate states
+   */
+  static void waitForAirWires(Board&                       board,
+                              const std::function<void()>& callback = {}) {
+    QElapsedTimer timer;
+    timer.start();
+    while (board.isAirWiresRebuildInProgress() && (timer.elapsed() < 30000)) {
+      QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+      if (callback) callback();
+    }
+    EXPECT_FALSE(board.isAirWiresRebuildInProgress());
+  }
+};
+
+/*******************************************************************************
+ *  Test Methods
+ ******************************************************************************/
+
+TEST_F(BoardTest, testItemsAtScenePosFollowMovedDevices) {
+  FilePath testDataDir(
+      TEST_DATA_DIR
+      "/unittests/librepcbproject/BoardPlaneFragmentsBuilderTest");
+
+  // open project from test data directory
+  FilePath projectFp = testDataDir.getPathTo("test_project/test_project.lpp");
+  std::shared_ptr<TransactionalFileSystem> projectFs =
+      TransactionalFileSystem::openRO(projectFp.getParentDir());
+  QScopedPointer<Project> project(
+      new Project(std::unique_ptr<TransactionalDirectory>(
+                      new TransactionalDirectory(projectFs)),
+                  projectFp.getFilename()));
+  Board* board = project->getBoards().first();
+  ASSERT_FALSE(board->getDeviceInstances().isEmpty());
+
+  // all pads must be found at their position
+  foreach (BI_Device* device, board->getDeviceInstances()) {
+    foreach (BI_FootprintPad* pad, device->getFootprint().getPads()) {
+      Point pos = pad->getPosition();
+      EXPECT_TRUE(
+          board->getPadsAtScenePos(pos, nullptr, nullptr).contains(pad));
+      EXPECT_TRUE(board->getItemsAtScenePos(pos).contains(pad));
+    }
+  }
+
+  // after moving the devices, the pads must be found only at the new position
+  Point offset(Length(1000000000), Length(0));
+  foreach (BI_Device* device, board->getDeviceInstances()) {
+    QList<BI_FootprintPad*> pads = device->getFootprint().getPads().values();
+    QList<Point>            oldPositions;
+    foreach (BI_FootprintPad* pad, pads) {
+      oldPositions.append(pad->getPosition());
+    }
+    device->setPosition(device->getPosition() + offset);
+    for (int i = 0; i < pads.count(); ++i) {
+      BI_FootprintPad* pad    = pads.at(i);
+      const Point&     oldPos = oldPositions.at(i);
+      const Point&     newPos = pad->getPosition();
+      EXPECT_FALSE(
+          board->getPadsAtScenePos(oldPos, nullptr, nullptr).contains(pad));
+      EXPECT_TRUE(
+          board->getPadsAtScenePos(newPos, nullptr, nullptr).contains(pad));
+    }
+  }
+}
+
+TEST_F(BoardTest, testPlanesAreRestoredFromCache) {
+  FilePath testDataDir(
+      TEST_DATA_DIR
+      "/unittests/librepcbproject/BoardPlaneFragmentsBuilderTest");
+
+  // open project from test data directory, build planes and save the cache
+  FilePath projectFp = testDataDir.getPathTo("test_project/test_project.lpp");
+  std::shared_ptr<TransactionalFileSystem> projectFs =
+      TransactionalFileSystem::openRO(projectFp.getParentDir());
+  QScopedPointer<Project> project(
+      new Project(std::unique_ptr<TransactionalDirectory>(
+                      new TransactionalDirectory(projectFs)),
+                  projectFp.getFilename()));
+  Board* board = project->getBoards().first();
+  ASSERT_FALSE(board->getPlanes().isEmpty());
+  board->rebuildAllPlanes();
+  QHash<Uuid, QVector<Path>> fragments;
+  foreach (const BI_Plane* plane, board->getPlanes()) {
+    fragments.insert(plane->getUuid(), plane->getFragments());
+  }
+  project->save();
+  QString cacheFile =
+      board->getFilePath().getParentDir().toRelative(projectFs->getAbsPath()) %
+      "/" % Board::getPlanesCacheFilePath();
+  EXPECT_TRUE(projectFs->fileExists(cacheFile));
+  QByteArray cacheContent = projectFs->read(cacheFile);
+
+  // the cache is only rewritten if some fragments were modified
+  projectFs->write(cacheFile, "unmodified");
+  project->save();
+  EXPECT_EQ(QByteArray("unmodified"), projectFs->read(cacheFile));
+  projectFs->write(cacheFile, cacheContent);
+  project.reset();
+
+  // reopen the project, the planes must be loaded from the cache
+  project.reset(new Project(std::unique_ptr<TransactionalDirectory>(
+                                new TransactionalDirectory(projectFs)),
+                            projectFp.getFilename()));
+  board = project->getBoards().first();
+  foreach (const BI_Plane* plane, board->getPlanes()) {
+    EXPECT_EQ(fragments.value(plane->getUuid()), plane->getFragments());
+    EXPECT_FALSE(plane->getFragmentsInputHash().isEmpty());
+  }
+  board->rebuildAllPlanes();
+  projectFs->write(cacheFile, "unmodified");
+  project->save();
+  EXPECT_EQ(QByteArray("unmodified"), projectFs->read(cacheFile));
+  projectFs->write(cacheFile, cacheContent);
+  project.reset();
+
+  // an invalid cache must be ignored
+  projectFs->write(cacheFile,
+                   "(librepcb_board_planes_cache (version \"0.1\"))");
+  project.reset(new Project(std::unique_ptr<TransactionalDirectory>(
+                                new TransactionalDirectory(projectFs)),
+                            projectFp.getFilename()));
+  board = project->getBoards().first();
+  foreach (const BI_Plane* plane, board->getPlanes()) {
+    EXPECT_TRUE(plane->getFragments().isEmpty());
+  }
+  board->rebuildAllPlanes();
+  foreach (const BI_Plane* plane, board->getPlanes()) {
+    EXPECT_EQ(fragments.value(plane->getUuid()), plane->getFragments());
+  }
+}
+
+TEST_F(BoardTest, testAirWiresJobsDropOutdatedResults) {
+  FilePath testDataDir(
+      TEST_DATA_DIR
+      "/unittests/librepcbproject/BoardPlaneFragmentsBuilderTest");
+
+  // open project from test data directory, the airwires are calculated in
+  // the worker thread
+  FilePath projectFp = testDataDir.getPathTo("test_project/test_project.lpp");
+  std::shared_ptr<TransactionalFileSystem> projectFs =
+      TransactionalFileSystem::openRO(projectFp.getParentDir());
+  QScopedPointer<Project> project(
+      new Project(std::unique_ptr<TransactionalDirectory>(
+                      new TransactionalDirectory(projectFs)),
+                  projectFp.getFilename()));
+  Board* board = project->getBoards().first();
+  waitForAirWires(*board);
+  AirWires initialAirWires = getAirWires(*board);
+  EXPECT_EQ(calcAirWires(*board), initialAirWires);
+
+  // find a device whose pads get airwires when moving it far away
+  Point       offset(Length(1000000000), Length(0));
+  BI_Device*  device = nullptr;
+  QSet<Point> movedPositions;
+  foreach (BI_Device* candidate, board->getDeviceInstances()) {
+    Point oldPos = candidate->getPosition();
+    candidate->setPosition(oldPos + offset);
+    QSet<Point> positions;
+    foreach (BI_FootprintPad* pad, candidate->getFootprint().getPads()) {
+      positions.insert(pad->getPosition());
+    }
+    bool found = containsAnyPoint(calcAirWires(*board), positions);
+    candidate->setPosition(oldPos);
+    if (found) {
+      device         = candidate;
+      movedPositions = positions;
+      break;
+    }
+  }
+  ASSERT_NE(nullptr, device);
+  Point oldPos = device->getPosition();
+  board->triggerAirWiresRebuild();  // rebuild for the unmoved device
+  waitForAirWires(*board);
+  EXPECT_EQ(initialAirWires, getAirWires(*board));
+
+  // results of net signals which were rescheduled while the job was running
+  // must be dropped
+  device->setPosition(oldPos + offset);
+  board->triggerAirWiresRebuild();
+  device->setPosition(oldPos);
+  waitForAirWires(*board);
+  EXPECT_EQ(initialAirWires, getAirWires(*board));
+
+  // results of jobs which were replaced by a newer snapshot must be dropped
+  device->setPosition(oldPos + offset);
+  board->triggerAirWiresRebuild();
+  device->setPosition(oldPos);
+  board->triggerAirWiresRebuild();
+  waitForAirWires(*board, [&]() {
+    EXPECT_FALSE(containsAnyPoint(getAirWires(*board), movedPositions));
+  });
+  EXPECT_FALSE(containsAnyPoint(getAirWires(*board), movedPositions));
+
+  // results of the latest snapshot must be applied
+  device->setPosition(oldPos + offset);
+  board->triggerAirWiresRebuild();
+  waitForAirWires(*board);
+  EXPECT_TRUE(containsAnyPoint(getAirWires(*board), movedPositions));
+
+  // closing the project while a job is running must be safe
+  device->setPosition(oldPos);
+  board->triggerAirWiresRebuild();
+  project.reset();
+}
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace tests
+}  // namespace project
+}  // namespace librepcb
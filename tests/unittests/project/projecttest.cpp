@@ -22,8 +22,10 @@
  ******************************************************************************/
 #include <gtest/gtest.h>
 #include <librepcb/common/fileio/transactionalfilesystem.h>
+#include <librepcb/common/gridproperties.h>
 #include <librepcb/project/metadata/projectmetadata.h>
 #include <librepcb/project/project.h>
+#include <librepcb/project/schematics/schematic.h>
 
 #include <QtCore>
 
@@ -137,6 +139,31 @@ TEST_F(ProjectTest, testSave) {
   project.reset(new Project(createDir(), mProjectFile.getFilename()));
 }
 
+TEST_F(ProjectTest, testSaveSkipsUnmodifiedSchematics) {
+  // create new project with one schematic
+  QScopedPointer<Project> project(
+      Project::create(createDir(), mProjectFile.getFilename()));
+  Schematic* schematic = project->createSchematic(ElementName("Foo"));
+  project->addSchematic(*schematic);
+  QString fp = schematic->getFilePath().toRelative(mProjectDir);
+
+  // first save must write the schematic file
+  project->save();
+  QByteArray content = project->getDirectory().read(fp);
+  EXPECT_FALSE(content.isEmpty());
+
+  // unmodified schematic must not be serialized again
+  project->getDirectory().write(fp, "unmodified");
+  project->save();
+  EXPECT_EQ(QByteArray("unmodified"), project->getDirectory().read(fp));
+
+  // modified schematic must be serialized again
+  GridProperties grid = schematic->getGridProperties();
+  schematic->setGridProperties(grid);
+  project->save();
+  EXPECT_EQ(content, project->getDirectory().read(fp));
+}
+
 TEST_F(ProjectTest, testIfLastModifiedDateTimeIsUpdatedOnSave) {
   // create new project
   QScopedPointer<Project> project(
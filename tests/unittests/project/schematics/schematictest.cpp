@@ -0,0 +1,145 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <librepcb/common/fileio/transactionalfilesystem.h>
+#include <librepcb/project/circuit/circuit.h>
+#include <librepcb/project/project.h>
+#include <librepcb/project/schematics/items/si_netlabel.h>
+#include <librepcb/project/schematics/items/si_netsegment.h>
+#include <librepcb/project/schematics/items/si_symbol.h>
+#include <librepcb/project/schematics/items/si_symbolpin.h>
+#include <librepcb/project/schematics/schematic.h>
+
+#include <QtCore>
+
+/*******************************************************************************
+ *  Namespace
+ ******************************************************************************/
+namespace librepcb {
+namespace project {
+namespace tests {
+
+/*******************************************************************************
+ *  Test Class
+ ******************************************************************************/
+
+class SchematicTest : public ::testing::Test {};
+
+/*******************************************************************************
+ *  Test Methods
+ ******************************************************************************/
+
+TEST(SchematicTest, testItemsAtScenePosFollowMovedItems) {
+  FilePath testDataDir(
+      TEST_DATA_DIR
+      "/unittests/librepcbproject/BoardPlaneFragmentsBuilderTest");
+
+  // open project from test data directory
+  FilePath projectFp = testDataDir.getPathTo("test_project/test_project.lpp");
+  std::shared_ptr<TransactionalFileSystem> projectFs =
+      TransactionalFileSystem::openRO(projectFp.getParentDir());
+  QScopedPointer<Project> project(
+      new Project(std::unique_ptr<TransactionalDirectory>(
+                      new TransactionalDirectory(projectFs)),
+                  projectFp.getFilename()));
+  ASSERT_FALSE(project->getSchematics().isEmpty());
+  ASSERT_FALSE(project->getCircuit().getNetSignals().isEmpty());
+  Schematic* schematic = project->getSchematics().first();
+  ASSERT_FALSE(schematic->getSymbols().isEmpty());
+
+  // add a net label far away from all other items
+  SI_NetSegment* segment = new SI_NetSegment(
+      *schematic, *project->getCircuit().getNetSignals().first());
+  schematic->addNetSegment(*segment);
+  SI_NetLabel* netlabel =
+      new SI_NetLabel(*segment, Point(Length(-500000000), Length(0)), Angle());
+  segment->addNetLabel(*netlabel);
+
+  // returns the center of the grab area and a small rect around it
+  auto center = [](const SI_Base& item) {
+    return Point::fromPx(item.getGrabAreaScenePx().boundingRect().center());
+  };
+  Point margin(Length(100000), Length(100000));
+
+  // all pins and the net label must be found at their position
+  foreach (SI_Symbol* symbol, schematic->getSymbols()) {
+    foreach (SI_SymbolPin* pin, symbol->getPins()) {
+      Point pos = pin->getPosition();
+      EXPECT_TRUE(schematic->getPinsAtScenePos(pos).contains(pin));
+      EXPECT_TRUE(schematic->getItemsAtScenePos(pos).contains(pin));
+    }
+  }
+  Point labelPos = center(*netlabel);
+  EXPECT_TRUE(schematic->getNetLabelsAtScenePos(labelPos).contains(netlabel));
+  EXPECT_TRUE(schematic->getItemsAtScenePos(labelPos).contains(netlabel));
+
+  // after moving the items, they must be found only at the new position
+  Point offset(Length(1000000000), Length(0));
+  foreach (SI_Symbol* symbol, schematic->getSymbols()) {
+    QList<SI_SymbolPin*> pins = symbol->getPins().values();
+    QList<Point>         oldPositions;
+    foreach (SI_SymbolPin* pin, pins) {
+      oldPositions.append(pin->getPosition());
+    }
+    symbol->setPosition(symbol->getPosition() + offset);
+    for (int i = 0; i < pins.count(); ++i) {
+      SI_SymbolPin* pin    = pins.at(i);
+      const Point&  oldPos = oldPositions.at(i);
+      const Point&  newPos = pin->getPosition();
+      EXPECT_FALSE(schematic->getPinsAtScenePos(oldPos).contains(pin));
+      EXPECT_TRUE(schematic->getPinsAtScenePos(newPos).contains(pin));
+    }
+  }
+  netlabel->setPosition(netlabel->getPosition() + offset);
+  Point newLabelPos = center(*netlabel);
+  EXPECT_FALSE(schematic->getNetLabelsAtScenePos(labelPos).contains(netlabel));
+  EXPECT_TRUE(
+      schematic->getNetLabelsAtScenePos(newLabelPos).contains(netlabel));
+
+  // the selection rect must select the items at their new position only
+  schematic->setSelectionRect(labelPos - margin, labelPos + margin, true);
+  EXPECT_FALSE(netlabel->isSelected());
+  schematic->setSelectionRect(newLabelPos - margin, newLabelPos + margin,
+                              true);
+  EXPECT_TRUE(netlabel->isSelected());
+  foreach (SI_Symbol* symbol, schematic->getSymbols()) {
+    foreach (SI_SymbolPin* pin, symbol->getPins()) {
+      Point pos = pin->getPosition();
+      schematic->setSelectionRect(pos - offset - margin,
+                                  pos - offset + margin, true);
+      EXPECT_FALSE(pin->isSelected());
+      schematic->setSelectionRect(pos - margin, pos + margin, true);
+      EXPECT_TRUE(pin->isSelected());
+    }
+  }
+  schematic->clearSelection();
+  EXPECT_FALSE(netlabel->isSelected());
+}
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace tests
+}  // namespace project
+}  // namespace librepcb
@@ -12,6 +12,7 @@ include(../../common.pri)
 
 # Set preprocessor defines
 DEFINES += TEST_DATA_DIR=\\\"$${PWD}/../data\\\"
+DEFINES += UNITTESTS_DIR=\\\"$${PWD}\\\"
 
 QT += core widgets network printsupport xml opengl sql concurrent
 
@@ -26,7 +27,6 @@ LIBS += \
     -llibrepcbproject \
     -llibrepcblibrary \    # Note: The order of the libraries is very important for the linker!
     -llibrepcbcommon \     # Another order could end up in "undefined reference" errors!
-    -lsexpresso \
     -lclipper \
     -lparseagle -lquazip -lz
 
@@ -47,7 +47,6 @@ DEPENDPATH += \
     ../../libs/librepcb/common \
     ../../libs/parseagle \
     ../../libs/quazip \
-    ../../libs/sexpresso \
     ../../libs/clipper \
 
 PRE_TARGETDEPS += \
@@ -58,15 +57,18 @@ PRE_TARGETDEPS += \
     $${DESTDIR}/liblibrepcblibrary.a \
     $${DESTDIR}/liblibrepcbcommon.a \
     $${DESTDIR}/libquazip.a \
-    $${DESTDIR}/libsexpresso.a \
     $${DESTDIR}/libclipper.a \
 
 SOURCES += \
     common/applicationtest.cpp \
     common/attributes/attributesubstitutortest.cpp \
+    common/cam/excellongeneratortest.cpp \
+    common/cam/gerberaperturelisttest.cpp \
+    common/cam/gerbergeneratortest.cpp \
     common/fileio/directorylocktest.cpp \
     common/fileio/filepathtest.cpp \
     common/fileio/serializableobjectlisttest.cpp \
+    common/fileio/sexpressiontest.cpp \
     common/fileio/transactionaldirectorytest.cpp \
     common/fileio/transactionalfilesystemtest.cpp \
     common/geometry/pathtest.cpp \
@@ -81,6 +83,7 @@ SOURCES += \
     common/units/lengthtest.cpp \
     common/units/pointtest.cpp \
     common/units/ratiotest.cpp \
+    common/utils/spatialindextest.cpp \
     common/uuidtest.cpp \
     common/versiontest.cpp \
     eagleimport/deviceconvertertest.cpp \
@@ -90,9 +93,15 @@ SOURCES += \
     library/cmp/componentsymbolvariantitemtest.cpp \
     library/librarybaseelementtest.cpp \
     main.cpp \
+    project/boards/boardairwiresbuildertest.cpp \
+    project/boards/boardgerberexporttest.cpp \
     project/boards/boardplanefragmentsbuildertest.cpp \
+    project/boards/boardtest.cpp \
     project/library/projectlibrarytest.cpp \
     project/projecttest.cpp \
+    project/schematics/schematictest.cpp \
+    workspace/library/workspacelibrarydbtest.cpp \
+    workspace/library/workspacelibraryscannertest.cpp \
     workspace/workspacetest.cpp \
 
 HEADERS += \
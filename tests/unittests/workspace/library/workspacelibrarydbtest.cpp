@@ -0,0 +1,273 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <librepcb/common/fileio/transactionalfilesystem.h>
+#include <librepcb/common/sqlitedatabase.h>
+#include <librepcb/library/cat/componentcategory.h>
+#include <librepcb/library/library.h>
+#include <librepcb/library/sym/symbol.h>
+#include <librepcb/workspace/library/cat/categorytreemodel.h>
+#include <librepcb/workspace/library/workspacelibrarydb.h>
+#include <librepcb/workspace/workspace.h>
+
+#include <QtConcurrent/QtConcurrent>
+#include <QtCore>
+#include <QtSql>
+
+#include <iostream>
+
+/*******************************************************************************
+ *  Namespace
+ ******************************************************************************/
+namespace librepcb {
+namespace workspace {
+namespace tests {
+
+/*******************************************************************************
+ *  Test Class
+ ******************************************************************************/
+
+class WorkspaceLibraryDbTest : public ::testing::Test {
+protected:
+  FilePath                  mWsDir;
+  QScopedPointer<Workspace> mWs;
+
+  WorkspaceLibraryDbTest() {
+    mWsDir = FilePath::getRandomTempPath().getPathTo("test workspace dir");
+    Workspace::createNewWorkspace(mWsDir);
+    mWs.reset(new Workspace(mWsDir));
+  }
+
+  virtual ~WorkspaceLibraryDbTest() {
+    mWs.reset();
+    QDir(mWsDir.getParentDir().toStr()).removeRecursively();
+  }
+
+  static int insertSymbol(SQLiteDatabase& db, const Uuid& uuid) {
+    QSqlQuery query = db.prepareQuery(
+        "INSERT INTO symbols "
+        "(lib_id, filepath, uuid, version, modified, checksum) VALUES "
+        "(1, :filepath, :uuid, '0.1', 0, '')");
+    query.bindValue(":filepath", "local/Test.lplib/sym/" % uuid.toStr());
+    query.bindValue(":uuid", uuid.toStr());
+    return db.insert(query);
+  }
+
+  static void insertTranslation(SQLiteDatabase& db, int symbolId,
+                                const QString& locale, const QString& name,
+                                const QString& keywords) {
+    QSqlQuery query = db.prepareQuery(
+        "INSERT INTO symbols_tr (symbol_id, locale, name, keywords) VALUES "
+        "(:symbol_id, :locale, :name, :keywords)");
+    query.bindValue(":symbol_id", symbolId);
+    query.bindValue(":locale", locale);
+    query.bindValue(":name", name);
+    query.bindValue(":keywords", keywords);
+    db.insert(query);
+  }
+
+  QList<Uuid> search(const QString& keyword) const {
+    return mWs->getLibraryDb().searchElements("symbols", "symbol_id", keyword);
+  }
+
+  std::shared_ptr<TransactionalFileSystem> createLibrary() {
+    std::shared_ptr<TransactionalFileSystem> fs =
+        TransactionalFileSystem::openRW(
+            mWs->getLibrariesPath().getPathTo("local/Test.lplib"));
+    library::Library lib(Uuid::createRandom(), Version::fromString("0.1"),
+                         "test", ElementName("Test"), "", "");
+    TransactionalDirectory libDir(fs);
+    lib.moveTo(libDir);
+    fs->save();
+    return fs;
+  }
+
+  bool scan() {
+    WorkspaceLibraryDb& db      = mWs->getLibraryDb();
+    bool                success = false;
+    QEventLoop          loop;
+    QObject::connect(&db, &WorkspaceLibraryDb::scanSucceeded, &loop,
+                     [&success](int elementCount) {
+                       Q_UNUSED(elementCount);
+                       success = true;
+                     });
+    QObject::connect(&db, &WorkspaceLibraryDb::scanFinished, &loop,
+                     &QEventLoop::quit);
+    QTimer::singleShot(60000, &loop, &QEventLoop::quit);  // timeout
+    db.startLibraryRescan();
+    loop.exec();
+    return success;
+  }
+};
+
+/*******************************************************************************
+ *  Test Methods
+ ******************************************************************************/
+
+TEST_F(WorkspaceLibraryDbTest, testBuildFullTextQuery) {
+  EXPECT_EQ("\"foo\"*", WorkspaceLibraryDb::buildFullTextQuery("foo"));
+  EXPECT_EQ("\"R\"* \"0603\"*",
+            WorkspaceLibraryDb::buildFullTextQuery(" R-0603 "));
+  EXPECT_EQ("\"foo\"* \"bar\"*",
+            WorkspaceLibraryDb::buildFullTextQuery("foo_bar\"*"));
+  EXPECT_EQ("\"NOT\"* \"µC\"*",
+            WorkspaceLibraryDb::buildFullTextQuery("NOT µC"));
+}
+
+TEST_F(WorkspaceLibraryDbTest, testBuildFullTextQueryWithoutWords) {
+  EXPECT_EQ("", WorkspaceLibraryDb::buildFullTextQuery(""));
+  EXPECT_EQ("", WorkspaceLibraryDb::buildFullTextQuery(" \"*()-"));
+}
+
+TEST_F(WorkspaceLibraryDbTest, testFullTextSearch) {
+  if (!mWs->getLibraryDb().hasFullTextIndex()) {
+    std::cout << "SQLite has no FTS5 support, skipping test." << std::endl;
+    return;
+  }
+
+  // the full-text index is updated by triggers on the translation tables
+  Uuid           resistor  = Uuid::createRandom();
+  Uuid           capacitor = Uuid::createRandom();
+  Uuid           diode     = Uuid::createRandom();
+  SQLiteDatabase db(mWs->getLibraryDb().getFilePath());
+  int            resistorId = insertSymbol(db, resistor);
+  insertTranslation(db, resistorId, "en_US", "Resistor 0603", "passive");
+  insertTranslation(db, resistorId, "de_DE", "Widerstand 0603", "passiv");
+  int capacitorId = insertSymbol(db, capacitor);
+  insertTranslation(db, capacitorId, "en_US", "Capacitor", "resistor-like");
+  int diodeId = insertSymbol(db, diode);
+  insertTranslation(db, diodeId, "en_US", "Diode", "");
+
+  // prefix search, name matches are ranked before keyword matches
+  EXPECT_EQ(QList<Uuid>({resistor, capacitor}), search("resis"));
+  EXPECT_EQ(QList<Uuid>({resistor}), search("WIDERST 06"));
+  EXPECT_EQ(QList<Uuid>(), search("resistor diode"));
+
+  // elements with multiple matching translations are listed only once
+  EXPECT_EQ(QList<Uuid>({resistor}), search("0603"));
+  EXPECT_EQ(QList<Uuid>({resistor}), search("pass"));
+
+  // updated translations are reindexed
+  QSqlQuery query = db.prepareQuery(
+      "UPDATE symbols_tr SET name = 'Zener' WHERE symbol_id = :id");
+  query.bindValue(":id", diodeId);
+  db.exec(query);
+  EXPECT_EQ(QList<Uuid>(), search("diode"));
+  EXPECT_EQ(QList<Uuid>({diode}), search("zen"));
+
+  // deleted translations disappear from the results, also if they are
+  // deleted by cascade
+  query = db.prepareQuery("DELETE FROM symbols_tr WHERE locale = 'de_DE'");
+  db.exec(query);
+  EXPECT_EQ(QList<Uuid>(), search("widerstand"));
+  query = db.prepareQuery("DELETE FROM symbols WHERE id = :id");
+  query.bindValue(":id", capacitorId);
+  db.exec(query);
+  EXPECT_EQ(QList<Uuid>({resistor}), search("resis"));
+  EXPECT_EQ(QList<Uuid>(), search("capacitor"));
+}
+
+TEST_F(WorkspaceLibraryDbTest, testQueryFromPoolThreadsWhileScanning) {
+  std::shared_ptr<TransactionalFileSystem> fs = createLibrary();
+  TransactionalDirectory                   symDir(fs, "sym");
+  for (int i = 0; i < 50; ++i) {
+    library::Symbol sym(Uuid::createRandom(), Version::fromString("0.1"),
+                        "test", ElementName(QString("Symbol %1").arg(i)), "",
+                        "");
+    sym.saveIntoParentDirectory(symDir);
+  }
+  fs->save();
+
+  // run queries on the pool threads while the scanner writes the database
+  WorkspaceLibraryDb& db = mWs->getLibraryDb();
+  auto                query = [&db]() {
+    try {
+      return db.getElementsBySearchKeyword<library::Symbol>("symbol").count();
+    } catch (const Exception& e) {
+      qWarning() << "Error:" << e.getMsg();
+      return -1;
+    }
+  };
+  QEventLoop loop;
+  QObject::connect(&db, &WorkspaceLibraryDb::scanFinished, &loop,
+                   &QEventLoop::quit);
+  QTimer::singleShot(60000, &loop, &QEventLoop::quit);  // timeout
+  db.startLibraryRescan();
+  QList<QFuture<int>> futures;
+  for (int i = 0; i < 20; ++i) {
+    futures.append(db.runAsync(query));
+  }
+  loop.exec();
+  foreach (QFuture<int> future, futures) {
+    EXPECT_GE(future.result(), 0);
+    EXPECT_LE(future.result(), 50);
+  }
+
+  // after the scan, the pool threads see all the written elements
+  EXPECT_EQ(50, db.runAsync(query).result());
+}
+
+TEST_F(WorkspaceLibraryDbTest, testQueryFromForeignThreadThrows) {
+  const WorkspaceLibraryDb& db     = mWs->getLibraryDb();
+  QFuture<bool>             future = QtConcurrent::run([&db]() {
+    try {
+      db.getLibraries();
+      return false;
+    } catch (const LogicError&) {
+      return true;
+    }
+  });
+  EXPECT_TRUE(future.result());
+}
+
+TEST_F(WorkspaceLibraryDbTest, testCategoryTreeModelLoadsAsynchronously) {
+  std::shared_ptr<TransactionalFileSystem> fs = createLibrary();
+  library::ComponentCategory cat(Uuid::createRandom(),
+                                 Version::fromString("0.1"), "test",
+                                 ElementName("Category"), "", "");
+  TransactionalDirectory     catDir(fs, "cmpcat");
+  cat.saveIntoParentDirectory(catDir);
+  fs->save();
+  ASSERT_TRUE(scan());
+
+  ComponentCategoryTreeModel model(mWs->getLibraryDb(), QStringList(),
+                                   CategoryTreeFilter::ALL);
+  EXPECT_EQ(0, model.rowCount());  // not loaded yet
+  QEventLoop loop;
+  QObject::connect(&model, &QAbstractItemModel::modelReset, &loop,
+                   &QEventLoop::quit);
+  QTimer::singleShot(60000, &loop, &QEventLoop::quit);  // timeout
+  loop.exec();
+  ASSERT_EQ(2, model.rowCount());
+  EXPECT_EQ("Category", model.data(model.index(0, 0)).toString());
+  EXPECT_EQ("(Without Category)", model.data(model.index(1, 0)).toString());
+}
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace tests
+}  // namespace workspace
+}  // namespace librepcb
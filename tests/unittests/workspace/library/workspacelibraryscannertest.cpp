@@ -0,0 +1,178 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <librepcb/common/fileio/fileutils.h>
+#include <librepcb/common/fileio/transactionalfilesystem.h>
+#include <librepcb/common/sqlitedatabase.h>
+#include <librepcb/library/library.h>
+#include <librepcb/library/sym/symbol.h>
+#include <librepcb/workspace/library/workspacelibrarydb.h>
+#include <librepcb/workspace/workspace.h>
+
+#include <QtCore>
+#include <QtSql>
+
+/*******************************************************************************
+ *  Namespace
+ ******************************************************************************/
+namespace librepcb {
+namespace workspace {
+namespace tests {
+
+/*******************************************************************************
+ *  Test Class
+ ******************************************************************************/
+
+class WorkspaceLibraryScannerTest : public ::testing::Test {
+protected:
+  struct DbEntry {
+    int     id;
+    qint64  modified;
+    QString name;
+  };
+
+  FilePath                                 mWsDir;
+  QScopedPointer<Workspace>                mWs;
+  std::shared_ptr<TransactionalFileSystem> mLibFs;
+
+  WorkspaceLibraryScannerTest() {
+    // create a workspace containing an empty library
+    mWsDir = FilePath::getRandomTempPath().getPathTo("test workspace dir");
+    Workspace::createNewWorkspace(mWsDir);
+    mWs.reset(new Workspace(mWsDir));
+    mLibFs = TransactionalFileSystem::openRW(
+        mWs->getLibrariesPath().getPathTo("local/Test.lplib"));
+    library::Library lib(Uuid::createRandom(), Version::fromString("0.1"),
+                         "test", ElementName("Test"), "", "");
+    TransactionalDirectory libDir(mLibFs);
+    lib.moveTo(libDir);
+    mLibFs->save();
+  }
+
+  virtual ~WorkspaceLibraryScannerTest() {
+    mLibFs.reset();
+    mWs.reset();
+    QDir(mWsDir.getParentDir().toStr()).removeRecursively();
+  }
+
+  Uuid addSymbol(const QString& name) {
+    library::Symbol sym(Uuid::createRandom(), Version::fromString("0.1"),
+                        "test", ElementName(name), "", "");
+    TransactionalDirectory symDir(mLibFs, "sym");
+    sym.saveIntoParentDirectory(symDir);
+    mLibFs->save();
+    return sym.getUuid();
+  }
+
+  FilePath getSymbolFile(const Uuid& uuid) const {
+    return mLibFs->getAbsPath("sym/" % uuid.toStr() % "/symbol.lp");
+  }
+
+  int scan() {
+    WorkspaceLibraryDb& db    = mWs->getLibraryDb();
+    int                 count = -1;
+    QEventLoop          loop;
+    QObject::connect(&db, &WorkspaceLibraryDb::scanSucceeded, &loop,
+                     [&count](int elementCount) { count = elementCount; });
+    QObject::connect(&db, &WorkspaceLibraryDb::scanFinished, &loop,
+                     &QEventLoop::quit);
+    QTimer::singleShot(60000, &loop, &QEventLoop::quit);  // timeout
+    db.startLibraryRescan();
+    loop.exec();
+    return count;
+  }
+
+  QHash<Uuid, DbEntry> getSymbolsFromDb() const {
+    SQLiteDatabase db(mWs->getLibraryDb().getFilePath(), true);
+    QSqlQuery      query = db.prepareQuery(
+        "SELECT symbols.uuid, symbols.id, symbols.modified, symbols_tr.name "
+        "FROM symbols LEFT JOIN symbols_tr "
+        "ON symbols.id = symbols_tr.symbol_id");
+    db.exec(query);
+    QHash<Uuid, DbEntry> entries;
+    while (query.next()) {
+      entries.insert(Uuid::fromString(query.value(0).toString()),
+                     DbEntry{query.value(1).toInt(),
+                             query.value(2).toLongLong(),
+                             query.value(3).toString()});
+    }
+    return entries;
+  }
+};
+
+/*******************************************************************************
+ *  Test Methods
+ ******************************************************************************/
+
+TEST_F(WorkspaceLibraryScannerTest, testIncrementalScan) {
+  Uuid unchanged = addSymbol("Unchanged");
+  Uuid touched   = addSymbol("Touched");
+  Uuid modified  = addSymbol("Modified");
+  Uuid removed   = addSymbol("Removed");
+  Uuid broken    = addSymbol("Broken");
+  FileUtils::writeFile(getSymbolFile(broken), "(librepcb_symbol");
+
+  // the broken element must not stop the scan
+  EXPECT_EQ(4, scan());
+  QHash<Uuid, DbEntry> before = getSymbolsFromDb();
+  EXPECT_EQ(4, before.count());
+  EXPECT_FALSE(before.contains(broken));
+
+  // make sure the modification times differ even on file systems with a
+  // resolution of one second
+  QThread::msleep(1100);
+  FileUtils::writeFile(getSymbolFile(touched),
+                       FileUtils::readFile(getSymbolFile(touched)));
+  FileUtils::writeFile(getSymbolFile(modified),
+                       FileUtils::readFile(getSymbolFile(modified))
+                           .replace("\"Modified\"", "\"New Name\""));
+  FileUtils::removeDirRecursively(getSymbolFile(removed).getParentDir());
+
+  EXPECT_EQ(3, scan());
+  QHash<Uuid, DbEntry> after = getSymbolsFromDb();
+  EXPECT_EQ(3, after.count());
+  EXPECT_FALSE(after.contains(removed));
+  EXPECT_FALSE(after.contains(broken));
+
+  // unchanged elements are skipped
+  EXPECT_EQ(before[unchanged].id, after[unchanged].id);
+  EXPECT_EQ(before[unchanged].modified, after[unchanged].modified);
+
+  // touched but identical elements are skipped by their checksum, only the
+  // modification time is updated
+  EXPECT_EQ(before[touched].id, after[touched].id);
+  EXPECT_LT(before[touched].modified, after[touched].modified);
+  EXPECT_EQ("Touched", after[touched].name);
+
+  // modified elements are indexed again
+  EXPECT_NE(before[modified].id, after[modified].id);
+  EXPECT_EQ("New Name", after[modified].name);
+}
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace tests
+}  // namespace workspace
+}  // namespace librepcb